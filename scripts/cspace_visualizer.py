@@ -187,10 +187,37 @@ def plotCSpaceCylindricalProjection(PX,PT):
   ax.set_zlabel(r'z')
   ax.tick_params(axis='both', which='major', pad=15)
 
+def getPointsBinary(fname, maxElements = float('inf')):
+  ### binary sample file (see src/elements/roadmap_sample_writer.h), same
+  ### output as getPoints
+  header = np.fromfile(fname, dtype=np.uint8, count=32)
+  version, dimension = header[8:16].view(np.uint32)
+  Nv, Ne = header[16:32].view(np.uint64)
+  if version != 1:
+    raise ValueError("Unknown sample file version %d" % version)
+  data = np.memmap(fname, dtype=np.uint8, mode='r')
+  offset = 32
+  states = data[offset:offset+8*Nv*dimension].view(np.float64).reshape(Nv, dimension)
+  offset += 8*Nv*dimension
+  feasible = data[offset:offset+Nv]
+
+  Q = list()
+  for k in range(int(Nv)):
+    if k > maxElements:
+      return Q
+    q = [bool(feasible[k]), False, None, int(dimension)]
+    q.extend(states[k])
+    Q.append(q)
+  return Q
+
 def getPoints(fname, maxElements = float('inf')):
   ### output: [feasible {True,False}, sufficient {True,False}, open_ball_radius
   ### {real}, number_of_states {int}, states {vector of real}]
 
+  with open(fname, 'rb') as f:
+    if f.read(8) == b'MXSAMPLE':
+      return getPointsBinary(fname, maxElements)
+
   import xml.etree.ElementTree
   root = xml.etree.ElementTree.parse(fname).getroot()
   Q = list()
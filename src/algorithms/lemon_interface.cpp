@@ -48,7 +48,7 @@ LemonInterface::LemonInterface( ob::PlannerDataPtr pd_ ):
 //#############################################################################
 // Extract edges and weight
 //#############################################################################
-  length = new CostMap(lg);
+  length.reset(new CostMap(lg));
 
   for(uint v1 = 0; v1 < pd->numVertices(); v1++){
     ob::PlannerDataVertex v1d = pd->getVertex(v1);
@@ -4,6 +4,7 @@
 #include <ompl/base/PlannerDataGraph.h>
 #include <lemon/list_graph.h>
 #include <lemon/dijkstra.h>
+#include <memory>
 
 namespace ob = ompl::base;
 
@@ -27,7 +28,7 @@ class LemonInterface{
     lemon::ListGraph::Node start, goal;
     bool hasStart, hasGoal;
 
-    CostMap* length;
+    std::unique_ptr<CostMap> length;
 
 };
 
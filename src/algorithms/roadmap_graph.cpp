@@ -0,0 +1,317 @@
+#include "roadmap_graph.h"
+#include <ompl/base/SpaceInformation.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace{
+  //planner data -> graph (planner data might be shared between roadmaps)
+  std::map<const ob::PlannerData*, std::pair<std::weak_ptr<ob::PlannerData>, RoadmapGraphPtr>> graphs;
+  std::mutex graphsMutex;
+
+  const uint NO_PREDECESSOR = std::numeric_limits<uint>::max();
+}
+
+RoadmapGraph::RoadmapGraph(const ob::PlannerData *pd_):
+  pd(pd_)
+{
+  Build();
+}
+
+RoadmapGraphPtr RoadmapGraph::Get(const ob::PlannerDataPtr &pd)
+{
+  std::lock_guard<std::mutex> lock(graphsMutex);
+
+  for(auto it = graphs.begin(); it != graphs.end();){
+    if(it->second.first.expired()) it = graphs.erase(it);
+    else it++;
+  }
+
+  auto it = graphs.find(pd.get());
+  if(it == graphs.end()){
+    RoadmapGraphPtr graph = std::make_shared<RoadmapGraph>(pd.get());
+    graphs[pd.get()] = std::make_pair(std::weak_ptr<ob::PlannerData>(pd), graph);
+    return graph;
+  }
+  RoadmapGraphPtr graph = it->second.second;
+  graph->Update();
+  return graph;
+}
+
+uint RoadmapGraph::numVertices() const
+{
+  return Nvertices;
+}
+
+uint RoadmapGraph::numEdges() const
+{
+  return Nedges;
+}
+
+void RoadmapGraph::Build()
+{
+  uint N = pd->numVertices();
+  const ob::SpaceInformationPtr si = pd->getSpaceInformation();
+
+  offsets.assign(N + 1, 0);
+  pending.clear();
+  pending.resize(N);
+  Npending = 0;
+  admissibleHeuristic = true;
+  //vertex indices might have changed
+  edgeValidity.clear();
+  invalidEdges.clear();
+
+  std::vector<std::vector<uint>> edges(N);
+  for(uint v = 0; v < N; v++){
+    pd->getEdges(v, edges.at(v));
+    offsets.at(v + 1) += edges.at(v).size();
+    for(uint j = 0; j < edges.at(v).size(); j++){
+      offsets.at(edges.at(v).at(j) + 1)++;
+    }
+  }
+  for(uint v = 0; v < N; v++){
+    offsets.at(v + 1) += offsets.at(v);
+  }
+
+  //edges are stored in both directions
+  targets.resize(offsets.back());
+  weights.resize(offsets.back());
+  std::vector<uint> fill(offsets.begin(), offsets.end() - 1);
+  for(uint v = 0; v < N; v++){
+    for(uint j = 0; j < edges.at(v).size(); j++){
+      uint w = edges.at(v).at(j);
+      ob::Cost c;
+      pd->getEdgeWeight(v, w, &c);
+      if(si && c.value() < si->distance(pd->getVertex(v).getState(), pd->getVertex(w).getState()) - 1e-10){
+        admissibleHeuristic = false;
+      }
+      targets.at(fill.at(v)) = w;
+      weights.at(fill.at(v)++) = c.value();
+      targets.at(fill.at(w)) = v;
+      weights.at(fill.at(w)++) = c.value();
+    }
+  }
+
+  Nvertices = N;
+  Nedges = pd->numEdges();
+}
+
+void RoadmapGraph::Compact()
+{
+  std::vector<uint> offsetsNew(Nvertices + 1, 0);
+  std::vector<uint> targetsNew;
+  std::vector<double> weightsNew;
+  targetsNew.reserve(targets.size() + 2*Npending);
+  weightsNew.reserve(targets.size() + 2*Npending);
+
+  uint Ncsr = offsets.size() - 1;
+  for(uint v = 0; v < Nvertices; v++){
+    if(v < Ncsr){
+      targetsNew.insert(targetsNew.end(), targets.begin() + offsets.at(v), targets.begin() + offsets.at(v + 1));
+      weightsNew.insert(weightsNew.end(), weights.begin() + offsets.at(v), weights.begin() + offsets.at(v + 1));
+    }
+    for(uint j = 0; j < pending.at(v).size(); j++){
+      targetsNew.push_back(pending.at(v).at(j).first);
+      weightsNew.push_back(pending.at(v).at(j).second);
+    }
+    pending.at(v).clear();
+    offsetsNew.at(v + 1) = targetsNew.size();
+  }
+  offsets.swap(offsetsNew);
+  targets.swap(targetsNew);
+  weights.swap(weightsNew);
+  Npending = 0;
+}
+
+void RoadmapGraph::AddEdge(uint v, uint w)
+{
+  ob::Cost c;
+  pd->getEdgeWeight(v, w, &c);
+  const ob::SpaceInformationPtr si = pd->getSpaceInformation();
+  if(si && c.value() < si->distance(pd->getVertex(v).getState(), pd->getVertex(w).getState()) - 1e-10){
+    admissibleHeuristic = false;
+  }
+  pending.at(v).push_back(std::make_pair(w, c.value()));
+  pending.at(w).push_back(std::make_pair(v, c.value()));
+  Npending++;
+}
+
+void RoadmapGraph::Update()
+{
+  uint N = pd->numVertices();
+  uint E = pd->numEdges();
+  if(N == Nvertices && E == Nedges) return;
+  if(N < Nvertices || E < Nedges){
+    Build();
+    return;
+  }
+
+  //new edges are edges from/to new vertices. Edges between new vertices are
+  //added as outgoing edges only.
+  pending.resize(N);
+  uint Nadded = 0;
+  std::vector<uint> edges;
+  for(uint v = Nvertices; v < N; v++){
+    pd->getEdges(v, edges);
+    for(uint j = 0; j < edges.size(); j++){
+      AddEdge(v, edges.at(j));
+      Nadded++;
+    }
+    pd->getIncomingEdges(v, edges);
+    for(uint j = 0; j < edges.size(); j++){
+      if(edges.at(j) < Nvertices){
+        AddEdge(edges.at(j), v);
+        Nadded++;
+      }
+    }
+  }
+
+  if(Nedges + Nadded != E){
+    //edges between existing vertices changed
+    Build();
+    return;
+  }
+  Nvertices = N;
+  Nedges = E;
+
+  if(Npending > 1024 && Npending > targets.size()/8){
+    Compact();
+  }
+}
+
+double RoadmapGraph::Heuristic(uint v, uint goal) const
+{
+  if(!admissibleHeuristic) return 0;
+  return pd->getSpaceInformation()->distance(pd->getVertex(v).getState(), pd->getVertex(goal).getState());
+}
+
+std::vector<uint> RoadmapGraph::GetShortestPath()
+{
+  if(Nvertices <= 0 || pd->numStartVertices() <= 0 || pd->numGoalVertices() <= 0){
+    return std::vector<uint>();
+  }
+  //last start and goal vertex (in vertex order), as selected by the previous
+  //lemon based query
+  uint s = 0, t = 0;
+  for(uint k = 0; k < pd->numStartVertices(); k++){
+    s = std::max(s, pd->getStartIndex(k));
+  }
+  for(uint k = 0; k < pd->numGoalVertices(); k++){
+    t = std::max(t, pd->getGoalIndex(k));
+  }
+  return GetShortestPath(s, t);
+}
+
+std::vector<uint> RoadmapGraph::GetShortestPath(uint s, uint t)
+{
+  std::vector<uint> path;
+  if(s >= Nvertices || t >= Nvertices) return path;
+  if(!pd->getSpaceInformation()) admissibleHeuristic = false;
+
+  if(cost.size() < Nvertices){
+    cost.resize(Nvertices);
+    predecessor.resize(Nvertices);
+    stamp.resize(Nvertices, 0);
+    closed.resize(Nvertices, false);
+  }
+  query++;
+  if(query == 0){
+    //stamps wrapped around
+    std::fill(stamp.begin(), stamp.end(), 0);
+    query = 1;
+  }
+
+  //A*: open list is a binary heap of (cost + heuristic, vertex), entries of
+  //vertices which have been closed are skipped
+  typedef std::pair<double, uint> Entry;
+  std::vector<Entry> open;
+  auto greater = [](const Entry &a, const Entry &b){ return a.first > b.first; };
+
+  uint Ncsr = offsets.size() - 1;
+
+  cost.at(s) = 0;
+  predecessor.at(s) = NO_PREDECESSOR;
+  stamp.at(s) = query;
+  closed.at(s) = false;
+  open.push_back(Entry(Heuristic(s, t), s));
+
+  bool reached = false;
+  while(!open.empty()){
+    std::pop_heap(open.begin(), open.end(), greater);
+    uint v = open.back().second;
+    open.pop_back();
+    if(closed.at(v)) continue;
+    closed.at(v) = true;
+    if(v == t){
+      reached = true;
+      break;
+    }
+
+    auto relax = [&](uint w, double weight)
+    {
+      if(!invalidEdges.empty() && invalidEdges.count(EdgeKey(v, w)) > 0) return;
+      double c = cost.at(v) + weight;
+      if(stamp.at(w) != query){
+        stamp.at(w) = query;
+        closed.at(w) = false;
+      }else if(closed.at(w) || c >= cost.at(w)){
+        return;
+      }
+      cost.at(w) = c;
+      predecessor.at(w) = v;
+      open.push_back(Entry(c + Heuristic(w, t), w));
+      std::push_heap(open.begin(), open.end(), greater);
+    };
+
+    if(v < Ncsr){
+      for(uint j = offsets.at(v); j < offsets.at(v + 1); j++){
+        relax(targets.at(j), weights.at(j));
+      }
+    }
+    for(uint j = 0; j < pending.at(v).size(); j++){
+      relax(pending.at(v).at(j).first, pending.at(v).at(j).second);
+    }
+  }
+
+  if(!reached) return path;
+
+  for(uint v = t; v != NO_PREDECESSOR; v = predecessor.at(v)){
+    path.push_back(v);
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+uint64_t RoadmapGraph::EdgeKey(uint v, uint w)
+{
+  if(w < v) std::swap(v, w);
+  return ((uint64_t)v << 32) | w;
+}
+
+std::vector<uint> RoadmapGraph::GetShortestPathLazy(uint s, uint t, const EdgeValidator &isValid)
+{
+  //terminates since every iteration either returns or removes an edge
+  while(true){
+    std::vector<uint> path = GetShortestPath(s, t);
+    bool valid = true;
+    for(uint k = 1; k < path.size(); k++){
+      uint64_t key = EdgeKey(path.at(k - 1), path.at(k));
+      auto it = edgeValidity.find(key);
+      bool validEdge;
+      if(it != edgeValidity.end()){
+        validEdge = it->second;
+      }else{
+        validEdge = isValid(path.at(k - 1), path.at(k));
+        edgeValidity[key] = validEdge;
+      }
+      if(!validEdge){
+        invalidEdges.insert(key);
+        valid = false;
+        break;
+      }
+    }
+    if(valid) return path;
+  }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <ompl/base/PlannerData.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ob = ompl::base;
+
+//RoadmapGraph: compressed sparse row (CSR) adjacency of the (undirected)
+//graph of a PlannerData, used for shortest path queries. The graph is built
+//once and updated incrementally when vertices and edges are appended to the
+//planner data. Edges added after the last build are kept in per-vertex
+//lists, and merged into the CSR arrays when they become too many.
+//
+//Queries run A* with the state space distance to the goal as heuristic (if
+//all edge weights are at least the distance between their states, otherwise
+//Dijkstra).
+class RoadmapGraph
+{
+  public:
+    RoadmapGraph(const ob::PlannerData *pd);
+
+    //graph for planner data (shared by all roadmaps on the same planner
+    //data, and updated to its current state)
+    static std::shared_ptr<RoadmapGraph> Get(const ob::PlannerDataPtr &pd);
+
+    //append vertices and edges which have been added to the planner data
+    //since the last call (rebuilds the graph if this is not possible)
+    void Update();
+
+    //vertex indices of shortest path between the start and goal vertex with
+    //the largest index (if there are several). Empty if there is no path.
+    std::vector<uint> GetShortestPath();
+    std::vector<uint> GetShortestPath(uint s, uint t);
+
+    //lazy shortest path: candidate shortest paths are searched until all of
+    //their edges are accepted by isValid. Rejected edges are removed from the
+    //search. The validity of checked edges is kept in the graph, such that
+    //each edge is checked at most once. Empty if there is no valid path.
+    typedef std::function<bool(uint, uint)> EdgeValidator;
+    std::vector<uint> GetShortestPathLazy(uint s, uint t, const EdgeValidator &isValid);
+
+    uint numVertices() const;
+    uint numEdges() const;
+
+  private:
+    void Build();
+    void Compact();
+    void AddEdge(uint v, uint w);
+    double Heuristic(uint v, uint goal) const;
+    static uint64_t EdgeKey(uint v, uint w);
+
+    const ob::PlannerData *pd{nullptr};
+
+    //neighbors of v: targets[offsets[v]], .., targets[offsets[v+1]-1]
+    std::vector<uint> offsets;
+    std::vector<uint> targets;
+    std::vector<double> weights;
+
+    //edges added since the last build (per vertex)
+    std::vector<std::vector<std::pair<uint, double>>> pending;
+    uint Npending{0};
+
+    //size of planner data the graph is built from
+    uint Nvertices{0};
+    uint Nedges{0};
+
+    bool admissibleHeuristic{true};
+
+    //validity of edges checked by lazy queries, and the invalid ones (which
+    //are skipped by all queries)
+    std::unordered_map<uint64_t, bool> edgeValidity;
+    std::unordered_set<uint64_t> invalidEdges;
+
+    //search buffers, reused between queries. A vertex is valid for the
+    //current query if its stamp is equal to the query counter.
+    std::vector<double> cost;
+    std::vector<uint> predecessor;
+    std::vector<uint> stamp;
+    std::vector<bool> closed;
+    uint query{0};
+};
+typedef std::shared_ptr<RoadmapGraph> RoadmapGraphPtr;
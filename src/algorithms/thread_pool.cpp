@@ -0,0 +1,91 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint Nthreads)
+{
+  if(Nthreads == 0) Nthreads = std::max(1u, std::thread::hardware_concurrency());
+  for(uint k = 1; k < Nthreads; k++){
+    workers.push_back(std::thread(&ThreadPool::Run, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cvWork.notify_all();
+  for(uint k = 0; k < workers.size(); k++){
+    workers.at(k).join();
+  }
+}
+
+uint ThreadPool::GetNumberOfThreads() const
+{
+  return workers.size() + 1;
+}
+
+void ThreadPool::Work()
+{
+  uint j;
+  while((j = nextJob++) < Njobs){
+    try{
+      (*job)(j);
+    }catch(...){
+      std::lock_guard<std::mutex> lock(mutex);
+      if(!exception) exception = std::current_exception();
+    }
+  }
+}
+
+void ThreadPool::Run()
+{
+  unsigned long seen = 0;
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cvWork.wait(lock, [&]{ return stop || epoch != seen; });
+      if(stop) return;
+      seen = epoch;
+    }
+    Work();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      active--;
+      if(active == 0) cvDone.notify_all();
+    }
+  }
+}
+
+void ThreadPool::ParallelFor(uint N, const std::function<void(uint)> &f)
+{
+  std::unique_lock<std::mutex> loop(loopMutex, std::try_to_lock);
+  if(!loop.owns_lock() || workers.empty() || N <= 1){
+    for(uint k = 0; k < N; k++) f(k);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &f;
+    Njobs = N;
+    nextJob = 0;
+    active = workers.size();
+    exception = nullptr;
+    epoch++;
+  }
+  cvWork.notify_all();
+
+  Work();
+
+  std::exception_ptr e;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cvDone.wait(lock, [&]{ return active == 0; });
+    job = nullptr;
+    e = exception;
+    exception = nullptr;
+  }
+  if(e) std::rethrow_exception(e);
+}
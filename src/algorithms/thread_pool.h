@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//ThreadPool: persistent worker threads for fine-grained parallel loops (the
+//workers wait on a condition variable between loops, so a loop does not pay
+//for thread creation). The calling thread takes part in the loop.
+//
+//Only one loop runs at a time. If the pool is busy (concurrent or nested
+//calls), the loop runs serially on the calling thread.
+class ThreadPool
+{
+  public:
+    //Nthreads: total number of threads including the caller (0: hardware
+    //concurrency)
+    ThreadPool(uint Nthreads = 0);
+    ~ThreadPool();
+
+    //calls f(0), .., f(N-1) and blocks until all calls returned. The first
+    //exception thrown by f is rethrown on the calling thread.
+    void ParallelFor(uint N, const std::function<void(uint)> &f);
+
+    uint GetNumberOfThreads() const;
+
+  private:
+    void Run();
+    void Work();
+
+    std::vector<std::thread> workers;
+
+    std::mutex loopMutex;
+    std::mutex mutex;
+    std::condition_variable cvWork;
+    std::condition_variable cvDone;
+
+    const std::function<void(uint)> *job{nullptr};
+    uint Njobs{0};
+    std::atomic<uint> nextJob{0};
+    uint active{0};
+    unsigned long epoch{0};
+    bool stop{false};
+    std::exception_ptr exception{nullptr};
+};
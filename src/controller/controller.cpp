@@ -1,14 +1,28 @@
 #include "controller.h"
+#include <algorithm>
 
-void ControllerState::AddCOM( Vector3 &com, Vector3 &linmom, Vector3 &angmom ){
+ControllerState::ControllerState():
+  com_window(maximumWindowSize), linmomentum_window(maximumWindowSize), angmomentum_window(maximumWindowSize)
+{
+}
+
+void ControllerState::AddCOM( Vector3 &com, Vector3 &linmom, Vector3 &angmom, double dt ){
+  if(!com_window.empty()){
+    window_length += (com - com_window.back()).norm();
+  }
+  if(com_window.full()){
+    window_length -= (com_window.at(1) - com_window.at(0)).norm();
+  }
   com_window.push_back(com);
   linmomentum_window.push_back(linmom);
   angmomentum_window.push_back(angmom);
+  if(dt > 0) sample_dt = dt;
 
-  if(getLength(com_window) > maximumWindowLength){
-    com_window.erase(com_window.begin());
-    linmomentum_window.erase(linmomentum_window.begin());
-    angmomentum_window.erase(angmomentum_window.begin());
+  while(window_length > maximumWindowLength && com_window.size() > 1){
+    window_length -= (com_window.at(1) - com_window.at(0)).norm();
+    com_window.pop_front();
+    linmomentum_window.pop_front();
+    angmomentum_window.pop_front();
   }
 }
 
@@ -20,65 +34,54 @@ void ControllerState::PredictCOM( double tstep, uint Nsteps){
   if(com_window.empty()){
     return;
   }
-  //compute change in momentum to get force estimate
-  Vector3 force;
-  if(linmomentum_window.size()>1){
-    double dt = 0.01;
-    //uint N = linmomentum_window.size()-1;
-
-    //average over last elements with diminishing return
-    uint N= min(10, int(linmomentum_window.size()-1));
+  //compute change in momentum to get force estimate: weighted average over
+  //the last differences, with diminishing weight for older ones
+  Vector3 force(0,0,0);
+  uint Nw = linmomentum_window.size();
+  if(Nw > 1){
+    uint N = std::min(10U, Nw-1);
+    double weights = 0;
     for(uint i = 0; i < N; i++){
-      Vector3 l1 = linmomentum_window.at(i);
-      Vector3 l2 = linmomentum_window.at(i+1);
-      force += ((N-i)/N)*(l2 - l1)/dt;
+      const Vector3 &l1 = linmomentum_window[Nw-2-i];
+      const Vector3 &l2 = linmomentum_window[Nw-1-i];
+      double w = double(N-i)/N;
+      force += w*(l2 - l1)/sample_dt;
+      weights += w;
     }
-    force /= N;
-  }else{
-    force = Vector3(0,0,0);
-  }
-  Vector3 torque;
-  if(angmomentum_window.size()>1){
-    uint N = angmomentum_window.size()-1;
-    Vector3 a1 = angmomentum_window.at(N-1);
-    Vector3 a2 = angmomentum_window.at(N);
-    torque = (a2 - a1)/tstep;
-  }else{
-    torque = Vector3(0,0,0);
+    force /= weights;
   }
 
   //predict COM forward assuming that we are in uniform force field
-  Vector3 com = com_window.back();
-  Vector3 LM = linmomentum_window.back();
-  //Vector3 AM = angmomentum_window.back();
-
-  double dt = tstep;
-  double dt2 = tstep*tstep*0.5;
-
-  Vector3 dcom = LM/mass;
-
-  predicted_com.clear();
-  for(uint i = 0; i < Nsteps; i++){
-    predicted_com.push_back(com);
-    com = com + dt * dcom + dt2 * force/mass;
-    dcom = dcom + dt * force/mass;
-  }
-
+  prediction_com = com_window.back();
+  prediction_dcom = linmomentum_window.back()/mass;
+  prediction_acceleration = force/mass;
+  prediction_tstep = tstep;
+  prediction_Nsteps = Nsteps;
+  predicted_com_valid = false;
 }
 
-double ControllerState::getLength(std::vector<Vector3> &path){
-  double length = 0.0;
-  for(uint i = 0; i < path.size()-1; i++){
-    length += (path.at(i) - path.at(i+1)).norm();
+const std::vector<Vector3>& ControllerState::GetPredictedCOM() const{
+  if(!predicted_com_valid){
+    //single pass over the horizon, reusing the storage of the previous one
+    predicted_com.resize(prediction_Nsteps);
+    for(uint i = 0; i < prediction_Nsteps; i++){
+      double t = i*prediction_tstep;
+      predicted_com[i] = prediction_com + t*prediction_dcom + (0.5*t*t)*prediction_acceleration;
+    }
+    predicted_com_valid = true;
   }
-  return length;
+  return predicted_com;
 }
+
 void ControllerState::Reset(){
   predicted_com.clear();
+  predicted_com_valid = true;
+  prediction_Nsteps = 0;
   predicted_com_dir.clear();
   com_window.clear();
   linmomentum_window.clear();
   angmomentum_window.clear();
+  window_length = 0;
 }
 //################################################################################
 //################################################################################
@@ -100,6 +103,7 @@ void ContactStabilityController::Reset() {
     }
   }
   output.Reset();
+  logger.Reset();
   RobotController::Reset(); 
 
   //std::cout << std::string(80, '-') << std::endl;
@@ -121,15 +125,16 @@ const ControllerState& ContactStabilityController::GetControllerState() const {
 void ContactStabilityController::Update(Real dt) {
   //We'll put our code here: read from this->sensors, and write to this->command.
   //See Sensor.h and Command.h for details on these structures
-  std::cout << "controller time " << time << " dt=" << dt << std::endl;
-
   Vector q_sensed,dq_sensed;
   GetSensedConfig(q_sensed);
   GetSensedVelocity(dq_sensed);
 
-  std::cout << std::string(80, '-') << std::endl;
-  std::cout << q_sensed << std::endl;
-  std::cout << robot.q << std::endl;
+  if(logger.Ready(time)){
+    logger.Stream() << "controller time " << time << " dt=" << dt << std::endl;
+    logger.Stream() << std::string(80, '-') << std::endl;
+    logger.Stream() << q_sensed << std::endl;
+    logger.Stream() << robot.q << std::endl;
+  }
 
   robot.q = q_sensed;
   robot.dq = dq_sensed;
@@ -140,21 +145,15 @@ void ContactStabilityController::Update(Real dt) {
   Vector3 AM = robot.GetAngularMomentum();
 
   output.SetMass( robot.GetTotalMass() );
-  output.AddCOM(com, LM, AM);
+  output.AddCOM(com, LM, AM, dt);
   output.PredictCOM(0.001, 1000);
 
   if(torques.size()>0){
-    output.current_torque = ZeroTorque;
-
-    uint ictr = 0;
-    double t = 0;
-    while(t <= time*0.1 && ictr<times.size()){
-      t+= times.at(ictr++);
-    }
-    //std::cout << time << "::" << t << "::" << ictr << std::endl;
-    if(t>time*0.1){
-      Vector torque = torques.at(ictr-1);
-      output.current_torque = torque;
+    //torque whose time interval contains the (scaled) controller time
+    double t = time*0.1;
+    auto it = std::upper_bound(end_times.begin(), end_times.end(), t);
+    if(it != end_times.end()){
+      output.current_torque = torques.at(it - end_times.begin());
     }else{
       output.current_torque = ZeroTorque;
     }
@@ -194,9 +193,10 @@ void ContactStabilityController::SetWrenchCommand(const Vector& wrenches)
 
     }
   }
-  //std::cout << "torques: " << wrenches << std::endl;
-  std::cout << "torques: " << T_wrenches << std::endl;
-  std::cout << std::string(80, '-') << std::endl;
+  if(logger.Ready(time)){
+    logger.Stream() << "torques: " << T_wrenches << std::endl;
+    logger.Stream() << std::string(80, '-') << std::endl;
+  }
   //SetTorqueCommand(T_wrenches);
   for(size_t i=0;i<robot.drivers.size();i++)
       command->actuators[i].SetTorque(T_wrenches[i]);
@@ -215,6 +215,8 @@ bool ContactStabilityController::SendCommand(const string& name,const string& st
   }else if(name == "set_torque_control") {
     ss >> torque_and_time;
     torques.clear();
+    times.clear();
+    end_times.clear();
     AppendTorqueAndTime(torque_and_time);
     ZeroTorque = torques.back();
     ZeroTorque.setZero();
@@ -241,6 +243,7 @@ void ContactStabilityController::AppendTorqueAndTime( Vector &torque_and_time )
   Vector torque(torque_tmp);
   torques.push_back(torque);
   times.push_back(torque_and_time(torque_and_time.size()-1));
+  end_times.push_back((end_times.empty() ? 0 : end_times.back()) + times.back());
 }
 
 vector<string> ContactStabilityController::Commands() const
@@ -1,28 +1,52 @@
 #pragma once
 #include <Control/Controller.h>
 #include <KrisLibrary/math/random.h>
+#include "controller/ring_buffer.h"
+#include "controller/rate_limited_log.h"
 
 struct ControllerState{
   public:
-    std::vector<Vector3> predicted_com;
+    ControllerState();
+
+    //sliding windows of the last samples, bounded by the path length of the
+    //COM (maximumWindowLength) and by their capacity
+    RingBuffer<Vector3> com_window;
+    RingBuffer<Vector3> linmomentum_window;
+    RingBuffer<Vector3> angmomentum_window;
     std::vector<Vector3> predicted_com_dir;
-    std::vector<Vector3> com_window;
-    std::vector<Vector3> linmomentum_window;
-    std::vector<Vector3> angmomentum_window;
 
     double mass;
     double maximumWindowLength = 2.0;
+    static const uint maximumWindowSize = 2000;
 
-    void AddCOM( Vector3 &com, Vector3 &linmom, Vector3 &angmom );
+    //sample of the current COM and momenta, dt after the previous sample
+    void AddCOM( Vector3 &com, Vector3 &linmom, Vector3 &angmom, double dt );
     void SetMass( double _mass );
+    //estimates the force from the momentum window and stores the initial
+    //conditions of the prediction (constant time, see GetPredictedCOM)
     void PredictCOM( double tstep, uint Nsteps);
+    //Nsteps COM positions predicted by the last PredictCOM (assuming that we
+    //are in a uniform force field), computed once per prediction on request
+    const std::vector<Vector3>& GetPredictedCOM() const;
 
     Vector current_torque;
 
     void Reset();
 
   private:
-    double getLength(std::vector<Vector3> &path);
+    //path length of com_window
+    double window_length{0};
+    double sample_dt{0.01};
+
+    //com(t) = com + t*dcom + t^2/2*acceleration
+    Vector3 prediction_com;
+    Vector3 prediction_dcom;
+    Vector3 prediction_acceleration;
+    double prediction_tstep{0};
+    uint prediction_Nsteps{0};
+
+    mutable bool predicted_com_valid{true};
+    mutable std::vector<Vector3> predicted_com;
 };
 
 
@@ -32,8 +56,11 @@ class ContactStabilityController: public RobotController
     ControllerState output;
     std::vector<Vector> torques;
     std::vector<double> times;
+    //end times of the torques: times[0]+...+times[k]
+    std::vector<double> end_times;
     double overall_time;
     Vector ZeroTorque;
+    RateLimitedLog logger;
 
   public:
     ContactStabilityController(Robot& robot);
@@ -0,0 +1,38 @@
+#include "rate_limited_log.h"
+
+RateLimitedLog::RateLimitedLog(double period_, std::ostream &out_):
+  period(period_), out(&out_), last_time(0)
+{
+}
+
+bool RateLimitedLog::Ready(double time)
+{
+  if(has_written && time < last_time + period && time >= last_time){
+    suppressed++;
+    return false;
+  }
+  if(suppressed > 0){
+    *out << "(" << suppressed << " messages suppressed)" << std::endl;
+    suppressed = 0;
+  }
+  last_time = time;
+  has_written = true;
+  return true;
+}
+
+std::ostream& RateLimitedLog::Stream()
+{
+  return *out;
+}
+
+void RateLimitedLog::SetPeriod(double period_)
+{
+  period = period_;
+}
+
+void RateLimitedLog::Reset()
+{
+  has_written = false;
+  suppressed = 0;
+  last_time = 0;
+}
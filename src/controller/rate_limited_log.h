@@ -0,0 +1,25 @@
+#pragma once
+#include <iostream>
+
+//Log sink for code running at control rate: messages are written at most
+//once per period (in the time of the caller, e.g. controller time). Callers
+//compose a message only if Ready() is true; messages in between are counted
+//and reported with the next written message.
+class RateLimitedLog{
+  public:
+    RateLimitedLog(double period = 1.0, std::ostream &out = std::cout);
+
+    //true if a message can be written at time
+    bool Ready(double time);
+    std::ostream& Stream();
+
+    void SetPeriod(double period);
+    void Reset();
+
+  private:
+    double period;
+    std::ostream *out;
+    double last_time;
+    bool has_written{false};
+    unsigned long suppressed{0};
+};
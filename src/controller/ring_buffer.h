@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <iostream>
+
+//Fixed-capacity FIFO window: push_back overwrites the oldest element if the
+//buffer is full. Element 0 is the oldest, element size()-1 the newest.
+template <class T>
+class RingBuffer{
+  public:
+    RingBuffer(uint capacity_ = 1000): data(capacity_)
+    {
+      if(capacity_ == 0){
+        std::cout << "[RingBuffer] capacity needs to be positive." << std::endl;
+        throw "Invalid capacity.";
+      }
+    }
+
+    void push_back(const T &element)
+    {
+      data[(first + N) % data.size()] = element;
+      if(N < data.size()) N++;
+      else first = (first + 1) % data.size();
+    }
+    void pop_front()
+    {
+      if(N == 0) return;
+      first = (first + 1) % data.size();
+      N--;
+    }
+    void clear()
+    {
+      first = 0;
+      N = 0;
+    }
+
+    const T& at(uint i) const
+    {
+      if(i >= N){
+        std::cout << "[RingBuffer] index " << i << " out of range (size " << N << ")" << std::endl;
+        throw "Index out of range.";
+      }
+      return data[(first + i) % data.size()];
+    }
+    const T& operator[](uint i) const { return data[(first + i) % data.size()]; }
+    const T& front() const { return at(0); }
+    const T& back() const { return at(N-1); }
+
+    uint size() const { return N; }
+    uint capacity() const { return data.size(); }
+    bool empty() const { return N == 0; }
+    bool full() const { return N == data.size(); }
+
+  private:
+    std::vector<T> data;
+    uint first{0};
+    uint N{0};
+};
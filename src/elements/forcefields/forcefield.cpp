@@ -1,6 +1,22 @@
 #include "forcefield.h"
 
 using namespace Math3D;
+void ForceField::addForces(const std::vector<Vector3>& positions, const std::vector<Vector3>& velocities, std::vector<Vector3>& forces)
+{
+  Vector3 zero(0,0,0);
+  for(uint k = 0; k < positions.size(); k++){
+    forces[k] += getForce(positions[k], velocities.empty() ? zero : velocities[k]);
+  }
+}
+
+bool ForceField::isStatic()
+{
+  return false;
+}
+ForceFieldSupport ForceField::getSupport(const Vector3& center, double radius)
+{
+  return SUPPORT_BOUNDARY;
+}
 void ForceField::DrawGL(GUIState &state)
 {
 
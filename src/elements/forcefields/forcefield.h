@@ -7,15 +7,28 @@
 #include <KrisLibrary/math/random.h>
 #include <KrisLibrary/utils/SmartPointer.h>
 #include <iostream>
+#include <vector>
 
-enum ForceFieldTypes{ UNIFORM=0, RADIAL, CYLINDRICAL, UNIFORM_RANDOM, DRAG, GAUSSIAN_RANDOM, OBB};
+enum ForceFieldTypes{ UNIFORM=0, RADIAL, CYLINDRICAL, UNIFORM_RANDOM, DRAG, GAUSSIAN_RANDOM, OBB, GRID};
+
+//relation of a ball to the region in which a force field is smooth and
+//non-zero (SUPPORT_BOUNDARY if the ball might intersect its boundary)
+enum ForceFieldSupport{ SUPPORT_OUTSIDE=0, SUPPORT_INSIDE, SUPPORT_BOUNDARY};
 
 class ForceField{
   public:
     virtual ~ForceField(){};
     virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity = Math3D::Vector3(0,0,0)) = 0;
+    //batched evaluation: adds the force at each position to forces (all of
+    //the same size). velocities is either empty (zero velocity) or of the
+    //same size as positions.
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces);
     virtual void Print(std::ostream &out) const = 0;
     virtual ForceFieldTypes type() = 0;
+    //true if the force depends only on the position (not on time or velocity)
+    virtual bool isStatic();
+    //conservative test, used to precompute static fields (see GridForceField)
+    virtual ForceFieldSupport getSupport(const Math3D::Vector3& center, double radius);
     virtual void DrawGL(GUIState &state);
     GLDraw::GLColor cForce{grey};
     friend std::ostream& operator<< (std::ostream& out, const ForceField& ff);
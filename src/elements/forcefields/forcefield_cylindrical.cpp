@@ -26,6 +26,29 @@ Math3D::Vector3 CylindricalForceField::getForce(const Math3D::Vector3& position,
   return F;
 }
 
+void CylindricalForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  const double sx = source.x, sy = source.y, sz = source.z;
+  const double dx = direction.x, dy = direction.y, dz = direction.z;
+  const double c = power/(2*M_PI);
+  for(uint k = 0; k < positions.size(); k++){
+    double xx = positions[k].x - sx;
+    double xy = positions[k].y - sy;
+    double xz = positions[k].z - sz;
+    double a = xx*dx + xy*dy + xz*dz;
+    double vx = xx - a*dx;
+    double vy = xy - a*dy;
+    double vz = xz - a*dz;
+    double dist = vx*vx + vy*vy + vz*vz;
+    //branch-free, such that the loop can be vectorized
+    bool inside = (minimum_radius <= dist) & (dist <= maximum_radius);
+    double s = inside ? c/sqrt(dist) : 0.0;
+    forces[k].x += s*(vy*dz - vz*dy);
+    forces[k].y += s*(vz*dx - vx*dz);
+    forces[k].z += s*(vx*dy - vy*dx);
+  }
+}
+
 void CylindricalForceField::Print(std::ostream &out) const
 {
   out << "CylindricalForceField  : source:" << source << " direction: "<< direction;
@@ -36,6 +59,21 @@ void CylindricalForceField::Print(std::ostream &out) const
 ForceFieldTypes CylindricalForceField::type(){
   return CYLINDRICAL;
 }
+bool CylindricalForceField::isStatic()
+{
+  return true;
+}
+ForceFieldSupport CylindricalForceField::getSupport(const Math3D::Vector3& center, double radius)
+{
+  //the field is non-zero on the cylindrical shell between the (squared) radii
+  Vector3 x = center - source;
+  double d = (x - (dot(x,direction))*direction).norm();
+  double rmin = sqrt(minimum_radius);
+  double rmax = sqrt(maximum_radius);
+  if(d + radius < rmin || d - radius > rmax) return SUPPORT_OUTSIDE;
+  if(d - radius > rmin && d + radius < rmax) return SUPPORT_INSIDE;
+  return SUPPORT_BOUNDARY;
+}
 Math3D::Vector3 CylindricalForceField::GetSource(){
   return source;
 }
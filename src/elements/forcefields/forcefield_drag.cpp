@@ -10,6 +10,19 @@ Math3D::Vector3 DragForceField::getForce(const Math3D::Vector3& position, const
   double d = v/(viscosity*viscosity);
   return -d*velocity;
 }
+void DragForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  //zero velocity, zero drag
+  if(velocities.empty()) return;
+  const double c = 1.0/(viscosity*viscosity);
+  for(uint k = 0; k < positions.size(); k++){
+    const Math3D::Vector3 &v = velocities[k];
+    double d = c*sqrt(v.x*v.x + v.y*v.y + v.z*v.z);
+    forces[k].x -= d*v.x;
+    forces[k].y -= d*v.y;
+    forces[k].z -= d*v.z;
+  }
+}
 void DragForceField::Print(std::ostream &out) const
 {
   out << "DragForceField : viscosity " << viscosity;
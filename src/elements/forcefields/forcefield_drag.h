@@ -4,9 +4,10 @@
 class DragForceField: public ForceField{
   public:
     DragForceField(double viscosity_);
-    virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity);
+    virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
     virtual void Print(std::ostream &out) const override;
-    virtual ForceFieldTypes type();
+    virtual ForceFieldTypes type() override;
   private:
     double viscosity;
 };
@@ -0,0 +1,224 @@
+#include "forcefield_grid.h"
+#include <KrisLibrary/math/random.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Math3D;
+
+//random points per cell at which the interpolation error is checked
+const uint samplesPerCell = 8;
+
+GridForceField::GridForceField(const std::vector<ForceFieldPtr> &fields_, Vector3 minimum_, Vector3 maximum_,
+    double maxError_, uint maxCells):
+  fields(fields_), minimum(minimum_), maximum(maximum_), maxError(maxError_)
+{
+  for(uint k = 0; k < fields.size(); k++){
+    if(!fields.at(k)->isStatic()){
+      std::cout << "[GridForceField] can only precompute static fields, but got " << *fields.at(k) << std::endl;
+      throw "Non-static force field.";
+    }
+  }
+  Vector3 extension = maximum - minimum;
+  for(uint k = 0; k < 3; k++){
+    if(extension[k] <= 0){
+      std::cout << "[GridForceField] empty grid from " << minimum << " to " << maximum << std::endl;
+      throw "Invalid grid bounds.";
+    }
+  }
+
+  double hk = extension.maxAbsElement()/8;
+  double error = Build(hk);
+  while(error > maxError && NumberOfCells(0.5*hk) <= maxCells){
+    hk *= 0.5;
+    error = Build(hk);
+  }
+  BuildCellFields();
+}
+
+uint GridForceField::NumberOfCells(double hk) const
+{
+  Vector3 extension = maximum - minimum;
+  double N = 1;
+  for(uint k = 0; k < 3; k++){
+    N *= std::max(1.0, std::ceil(extension[k]/hk));
+  }
+  return (N < std::numeric_limits<uint>::max() ? (uint)N : std::numeric_limits<uint>::max());
+}
+
+double GridForceField::Build(double hk)
+{
+  h = hk;
+  Vector3 extension = maximum - minimum;
+  Nx = std::max(1, (int)std::ceil(extension[0]/h));
+  Ny = std::max(1, (int)std::ceil(extension[1]/h));
+  Nz = std::max(1, (int)std::ceil(extension[2]/h));
+
+  corners.resize((Nx+1)*(Ny+1)*(Nz+1));
+  for(uint k = 0; k <= Nz; k++){
+    for(uint j = 0; j <= Ny; j++){
+      for(uint i = 0; i <= Nx; i++){
+        corners.at(CornerIndex(i,j,k)) = EvaluateAll(minimum + h*Vector3(i,j,k));
+      }
+    }
+  }
+
+  //a cell is interpolated if all fields are either zero or smooth on it (and
+  //the interpolation error at random points inside is small)
+  double radius = 0.5*sqrt(3.0)*h;
+  double error = 0;
+  interpolated.assign(Nx*Ny*Nz, true);
+  for(uint k = 0; k < Nz; k++){
+    for(uint j = 0; j < Ny; j++){
+      for(uint i = 0; i < Nx; i++){
+        uint c = (k*Ny + j)*Nx + i;
+        Vector3 center = minimum + h*Vector3(i+0.5, j+0.5, k+0.5);
+        for(uint f = 0; f < fields.size(); f++){
+          if(fields.at(f)->getSupport(center, radius) == SUPPORT_BOUNDARY){
+            interpolated[c] = false;
+            break;
+          }
+        }
+        if(!interpolated[c]) continue;
+
+        double e = 0;
+        for(uint m = 0; m < samplesPerCell; m++){
+          double tx = Math::Rand(), ty = Math::Rand(), tz = Math::Rand();
+          Vector3 p = minimum + h*Vector3(i+tx, j+ty, k+tz);
+          e = std::max(e, (Interpolate(i, j, k, tx, ty, tz) - EvaluateAll(p)).maxAbsElement());
+        }
+        error = std::max(error, e);
+        if(e > maxError) interpolated[c] = false;
+      }
+    }
+  }
+  return error;
+}
+
+void GridForceField::BuildCellFields()
+{
+  double radius = 0.5*sqrt(3.0)*h;
+  cell_offsets.assign(Nx*Ny*Nz + 1, 0);
+  cell_fields.clear();
+  for(uint k = 0; k < Nz; k++){
+    for(uint j = 0; j < Ny; j++){
+      for(uint i = 0; i < Nx; i++){
+        uint c = (k*Ny + j)*Nx + i;
+        if(!interpolated[c]){
+          Vector3 center = minimum + h*Vector3(i+0.5, j+0.5, k+0.5);
+          for(uint f = 0; f < fields.size(); f++){
+            if(fields.at(f)->getSupport(center, radius) != SUPPORT_OUTSIDE){
+              cell_fields.push_back(f);
+            }
+          }
+        }
+        cell_offsets[c+1] = cell_fields.size();
+      }
+    }
+  }
+}
+
+Vector3 GridForceField::Interpolate(uint i, uint j, uint k, double tx, double ty, double tz) const
+{
+  const Vector3 &c000 = corners[CornerIndex(i, j, k)];
+  const Vector3 &c100 = corners[CornerIndex(i+1, j, k)];
+  const Vector3 &c010 = corners[CornerIndex(i, j+1, k)];
+  const Vector3 &c110 = corners[CornerIndex(i+1, j+1, k)];
+  const Vector3 &c001 = corners[CornerIndex(i, j, k+1)];
+  const Vector3 &c101 = corners[CornerIndex(i+1, j, k+1)];
+  const Vector3 &c011 = corners[CornerIndex(i, j+1, k+1)];
+  const Vector3 &c111 = corners[CornerIndex(i+1, j+1, k+1)];
+
+  Vector3 c00 = c000 + tx*(c100 - c000);
+  Vector3 c10 = c010 + tx*(c110 - c010);
+  Vector3 c01 = c001 + tx*(c101 - c001);
+  Vector3 c11 = c011 + tx*(c111 - c011);
+  Vector3 c0 = c00 + ty*(c10 - c00);
+  Vector3 c1 = c01 + ty*(c11 - c01);
+  return c0 + tz*(c1 - c0);
+}
+
+Vector3 GridForceField::EvaluateAll(const Vector3& position)
+{
+  Vector3 zero(0,0,0);
+  Vector3 F(0,0,0);
+  for(uint f = 0; f < fields.size(); f++){
+    F += fields.at(f)->getForce(position, zero);
+  }
+  return F;
+}
+
+Vector3 GridForceField::getForce(const Vector3& position, const Vector3& velocity)
+{
+  double x = (position.x - minimum.x)/h;
+  double y = (position.y - minimum.y)/h;
+  double z = (position.z - minimum.z)/h;
+  if(x < 0 || y < 0 || z < 0 || x >= Nx || y >= Ny || z >= Nz){
+    return EvaluateAll(position);
+  }
+  uint i = (uint)x, j = (uint)y, k = (uint)z;
+  uint c = (k*Ny + j)*Nx + i;
+  if(interpolated[c]){
+    return Interpolate(i, j, k, x - i, y - j, z - k);
+  }
+
+  Vector3 zero(0,0,0);
+  Vector3 F(0,0,0);
+  for(uint m = cell_offsets[c]; m < cell_offsets[c+1]; m++){
+    F += fields[cell_fields[m]]->getForce(position, zero);
+  }
+  return F;
+}
+
+void GridForceField::addForces(const std::vector<Vector3>& positions, const std::vector<Vector3>& velocities, std::vector<Vector3>& forces)
+{
+  Vector3 zero(0,0,0);
+  for(uint k = 0; k < positions.size(); k++){
+    forces[k] += getForce(positions[k], zero);
+  }
+}
+
+void GridForceField::Print(std::ostream &out) const
+{
+  out << "GridForceField : " << fields.size() << " static fields, " << Nx << "x" << Ny << "x" << Nz
+    << " cells of size " << h << " (" << GetNumberOfInterpolatedCells() << " interpolated)"
+    << " from " << minimum << " to " << maximum;
+  for(uint k = 0; k < fields.size(); k++){
+    out << std::endl << "  " << *fields.at(k);
+  }
+}
+
+ForceFieldTypes GridForceField::type()
+{
+  return GRID;
+}
+bool GridForceField::isStatic()
+{
+  return true;
+}
+void GridForceField::DrawGL(GUIState &state)
+{
+  for(uint k = 0; k < fields.size(); k++){
+    fields.at(k)->DrawGL(state);
+  }
+}
+const std::vector<ForceFieldPtr>& GridForceField::GetForceFields() const
+{
+  return fields;
+}
+uint GridForceField::GetNumberOfCells() const
+{
+  return Nx*Ny*Nz;
+}
+uint GridForceField::GetNumberOfInterpolatedCells() const
+{
+  return std::count(interpolated.begin(), interpolated.end(), true);
+}
+double GridForceField::GetCellSize() const
+{
+  return h;
+}
+double GridForceField::GetMaxError() const
+{
+  return maxError;
+}
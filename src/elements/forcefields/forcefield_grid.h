@@ -0,0 +1,62 @@
+#pragma once
+#include "forcefield.h"
+#include <vector>
+
+//Precomputed sum of static force fields on a regular grid inside the box
+//[minimum,maximum]. In cells in which each field is either zero or smooth,
+//the force is trilinearly interpolated from the cell corners. In the
+//remaining cells (support boundaries, singularities, interpolation error
+//above the bound) only the fields intersecting the cell are evaluated.
+//Outside of the box, all fields are evaluated.
+//
+//The cell size is halved (starting from an eighth of the box) until the
+//interpolation error at random points inside each cell is below maxError or
+//maxCells would be exceeded.
+class GridForceField: public ForceField{
+  public:
+    GridForceField(const std::vector<ForceFieldPtr> &fields, Math3D::Vector3 minimum, Math3D::Vector3 maximum,
+        double maxError = 1e-2, uint maxCells = 1000000);
+
+    virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
+    virtual void Print(std::ostream &out) const override;
+    virtual ForceFieldTypes type() override;
+    virtual bool isStatic() override;
+    virtual void DrawGL(GUIState &state) override;
+
+    const std::vector<ForceFieldPtr>& GetForceFields() const;
+    uint GetNumberOfCells() const;
+    //cells which are interpolated (instead of evaluated)
+    uint GetNumberOfInterpolatedCells() const;
+    double GetCellSize() const;
+    double GetMaxError() const;
+
+  private:
+    //computes corners and interpolated cells for cell size h. Cells with an
+    //interpolation error above maxError are evaluated. Returns the maximum
+    //interpolation error at the sampled points.
+    double Build(double h);
+    //cell_fields of the evaluated cells
+    void BuildCellFields();
+    uint NumberOfCells(double h) const;
+    Math3D::Vector3 Interpolate(uint i, uint j, uint k, double tx, double ty, double tz) const;
+    Math3D::Vector3 EvaluateAll(const Math3D::Vector3& position);
+
+    inline uint CornerIndex(uint i, uint j, uint k) const
+    {
+      return (k*(Ny+1) + j)*(Nx+1) + i;
+    }
+
+    std::vector<ForceFieldPtr> fields;
+    Math3D::Vector3 minimum, maximum;
+    double maxError;
+    double h;
+    uint Nx, Ny, Nz;
+
+    //summed force at (Nx+1)*(Ny+1)*(Nz+1) cell corners
+    std::vector<Math3D::Vector3> corners;
+    std::vector<bool> interpolated;
+    //fields to evaluate in cell c: cell_fields[cell_offsets[c]..cell_offsets[c+1])
+    std::vector<uint> cell_offsets;
+    std::vector<uint> cell_fields;
+};
@@ -60,11 +60,51 @@ Math3D::Vector3 OrientedBoundingBoxForceField::getForce(const Math3D::Vector3& p
   }
 }
 
+void OrientedBoundingBoxForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  const double cx = center.x, cy = center.y, cz = center.z;
+  const double ex = 0.5*extension.x, ey = 0.5*extension.y, ez = 0.5*extension.z;
+  //rows of R^T
+  const double r00 = R(0,0), r10 = R(1,0), r20 = R(2,0);
+  const double r01 = R(0,1), r11 = R(1,1), r21 = R(2,1);
+  const double r02 = R(0,2), r12 = R(1,2), r22 = R(2,2);
+  const double fx = force.x, fy = force.y, fz = force.z;
+  for(uint k = 0; k < positions.size(); k++){
+    double px = positions[k].x - cx;
+    double py = positions[k].y - cy;
+    double pz = positions[k].z - cz;
+    double rx = r00*px + r10*py + r20*pz;
+    double ry = r01*px + r11*py + r21*pz;
+    double rz = r02*px + r12*py + r22*pz;
+    //branch-free, such that the loop can be vectorized
+    bool inside = (fabs(rx) <= ex) & (fabs(ry) <= ey) & (fabs(rz) <= ez);
+    double s = inside ? 1.0 : 0.0;
+    forces[k].x += s*fx;
+    forces[k].y += s*fy;
+    forces[k].z += s*fz;
+  }
+}
+
 void OrientedBoundingBoxForceField::Print(std::ostream &out) const
 {
   out << "OrientedBoundingBoxForceField : force " << force  << " center " << center << " extension " << extension;
 }
 
+bool OrientedBoundingBoxForceField::isStatic()
+{
+  return true;
+}
+ForceFieldSupport OrientedBoundingBoxForceField::getSupport(const Math3D::Vector3& position, double radius)
+{
+  Vector3 rel;
+  R.mulTranspose(position - center, rel);
+  bool inside = true;
+  for(int i = 0; i < 3; i++){
+    if(fabs(rel[i]) > extension[i]/2 + radius) return SUPPORT_OUTSIDE;
+    if(fabs(rel[i]) + radius >= extension[i]/2) inside = false;
+  }
+  return (inside ? SUPPORT_INSIDE : SUPPORT_BOUNDARY);
+}
 double OrientedBoundingBoxForceField::GetPower(){
   return power;
 }
@@ -24,6 +24,23 @@ Math3D::Vector3 RadialForceField::getForce(const Math3D::Vector3& position, cons
   return F;
 }
 
+void RadialForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  const double sx = source.x, sy = source.y, sz = source.z;
+  for(uint k = 0; k < positions.size(); k++){
+    double rx = positions[k].x - sx;
+    double ry = positions[k].y - sy;
+    double rz = positions[k].z - sz;
+    double dist = rx*rx + ry*ry + rz*rz;
+    //branch-free, such that the loop can be vectorized
+    bool inside = (minimum_radius <= dist) & (dist <= maximum_radius);
+    double s = inside ? power/dist : 0.0;
+    forces[k].x += s*rx;
+    forces[k].y += s*ry;
+    forces[k].z += s*rz;
+  }
+}
+
 void RadialForceField::Print(std::ostream &out) const
 {
   out << "RadialForceField  : source:" << source << " power: "<< power << " radius "<< maximum_radius << " color " << cForce;
@@ -32,6 +49,20 @@ void RadialForceField::Print(std::ostream &out) const
 ForceFieldTypes RadialForceField::type(){
   return RADIAL;
 }
+bool RadialForceField::isStatic()
+{
+  return true;
+}
+ForceFieldSupport RadialForceField::getSupport(const Math3D::Vector3& center, double radius)
+{
+  //the field is non-zero on the shell between the (squared) radii
+  double d = (center - source).norm();
+  double rmin = sqrt(minimum_radius);
+  double rmax = sqrt(maximum_radius);
+  if(d + radius < rmin || d - radius > rmax) return SUPPORT_OUTSIDE;
+  if(d - radius > rmin && d + radius < rmax) return SUPPORT_INSIDE;
+  return SUPPORT_BOUNDARY;
+}
 Math3D::Vector3 RadialForceField::GetSource(){
   return source;
 }
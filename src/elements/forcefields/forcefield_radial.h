@@ -6,8 +6,11 @@ class RadialForceField: public ForceField{
     RadialForceField(Math3D::Vector3 _source, double _power, double _radius);
 
     virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
     virtual void Print(std::ostream &out) const override;
     virtual ForceFieldTypes type() override;
+    virtual bool isStatic() override;
+    virtual ForceFieldSupport getSupport(const Math3D::Vector3& center, double radius) override;
     virtual void DrawGL(GUIState &state) override;
 
     Math3D::Vector3 GetSource();
@@ -19,6 +19,15 @@ Math3D::Vector3 UniformRandomForceField::getForce(const Math3D::Vector3& positio
   return F;
 }
 
+void UniformRandomForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  for(uint k = 0; k < positions.size(); k++){
+    for(int i = 0; i < 3; i++){
+      forces[k][i] += Math::Rand(minforce[i], maxforce[i]);
+    }
+  }
+}
+
 void UniformRandomForceField::Print(std::ostream &out) const
 {
   out << "UniformRandomForceField  : minforce "<<minforce << " maxforce " << maxforce;
@@ -44,6 +53,15 @@ Math3D::Vector3 GaussianRandomForceField::getForce(const Math3D::Vector3& positi
   return F;
 }
 
+void GaussianRandomForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  for(uint k = 0; k < positions.size(); k++){
+    for(int i = 0; i < 3; i++){
+      forces[k][i] += Math::RandGaussian(mean[i], stddeviation[i]);
+    }
+  }
+}
+
 void GaussianRandomForceField::Print(std::ostream& out) const
 {
   out << "GaussianRandomForceField  : mean "<< mean << " stddev " << stddeviation;
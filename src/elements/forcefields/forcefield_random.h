@@ -6,6 +6,7 @@ class UniformRandomForceField: public ForceField{
     UniformRandomForceField(Math3D::Vector3 _minforce, Math3D::Vector3 _maxforce);
 
     virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
     virtual void Print(std::ostream &out) const override;
     virtual ForceFieldTypes type() override;
 
@@ -18,6 +19,7 @@ class GaussianRandomForceField: public ForceField{
     GaussianRandomForceField(Math3D::Vector3 _mean, Math3D::Vector3 _std);
 
     virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
     virtual void Print(std::ostream &out) const override;
     virtual ForceFieldTypes type() override;
 
@@ -8,6 +8,15 @@ Math3D::Vector3 UniformForceField::getForce(const Math3D::Vector3& position, con
 {
   return force;
 }
+void UniformForceField::addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces)
+{
+  const double fx = force.x, fy = force.y, fz = force.z;
+  for(uint k = 0; k < positions.size(); k++){
+    forces[k].x += fx;
+    forces[k].y += fy;
+    forces[k].z += fz;
+  }
+}
 void UniformForceField::Print(std::ostream &out) const
 {
   out << "UniformForceField : force " << force;
@@ -16,6 +25,14 @@ ForceFieldTypes UniformForceField::type()
 {
   return UNIFORM;
 }
+bool UniformForceField::isStatic()
+{
+  return true;
+}
+ForceFieldSupport UniformForceField::getSupport(const Math3D::Vector3& center, double radius)
+{
+  return SUPPORT_INSIDE;
+}
 void UniformForceField::DrawGL(GUIState &state)
 {
   // double step = 0.5;
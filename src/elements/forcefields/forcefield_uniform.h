@@ -5,8 +5,11 @@ class UniformForceField: public ForceField{
   public:
     UniformForceField(Math3D::Vector3 force_);
     virtual Math3D::Vector3 getForce(const Math3D::Vector3& position, const Math3D::Vector3& velocity) override;
+    virtual void addForces(const std::vector<Math3D::Vector3>& positions, const std::vector<Math3D::Vector3>& velocities, std::vector<Math3D::Vector3>& forces) override;
     virtual void Print(std::ostream &out) const override;
     virtual ForceFieldTypes type() override;
+    virtual bool isStatic() override;
+    virtual ForceFieldSupport getSupport(const Math3D::Vector3& center, double radius) override;
     virtual void DrawGL(GUIState &state) override;
   private:
     Math3D::Vector3 force;
@@ -4,6 +4,7 @@
 #include "planner/cspace/cspace_multiagent.h"
 #include "gui/drawMotionPlanner.h"
 #include <iostream>
+#include <algorithm>
 #include <ompl/base/spaces/SE3StateSpace.h>
 #include <ompl/base/StateSpace.h>
 #include <ompl/geometric/PathGeometric.h>
@@ -80,7 +81,10 @@ PathPiecewiseLinear::PathPiecewiseLinear(ob::PathPtr p_, CSpaceOMPL *cspace_, CS
         interLength.push_back(d);
         length+=d;
       }
+      quotient_space->SpaceInformationPtr()->freeState(x0prime);
+      quotient_space->SpaceInformationPtr()->freeState(x1prime);
     }
+    UpdateCumulativeLength();
   }
 }
 
@@ -197,6 +201,7 @@ void PathPiecewiseLinear::Smooth(bool forceSmoothing){
 
     double l = path->length();
     path = std::make_shared<og::PathGeometric>(gpath);
+    UpdateCumulativeLength();
     std::cout << "Path smoothed (states: " << statesB.size() << " -> " << states.size() 
       << ", length: " << l << " -> " << path->length()
       << ")" << std::endl;
@@ -216,6 +221,7 @@ void PathPiecewiseLinear::Normalize(){
   }
   assert( fabs(newLength-1.0) < 1e-10);
   length = newLength;
+  UpdateCumulativeLength();
 }
 std::vector<double> PathPiecewiseLinear::GetLengthVector() const{
   return interLength;
@@ -226,84 +232,119 @@ double PathPiecewiseLinear::GetLength() const{
 }
 
 Vector3 PathPiecewiseLinear::EvalVec3(const double t, int ridx) const{
-  Config q = Eval(t);
-  ob::ScopedState<> s = quotient_space->ConfigToOMPLState(q);
-  Vector3 v = quotient_space->getXYZ(s.get(), ridx);
+  Vector3 v = quotient_space->getXYZ(EvalState(t), ridx);
   if(draw_planar) v[2] = zOffset;
   return v;
 }
 
 Vector3 PathPiecewiseLinear::EvalVec3(const double t) const{
-  Config q = Eval(t);
-  ob::ScopedState<> s = quotient_space->ConfigToOMPLState(q);
-  Vector3 v = quotient_space->getXYZ(s.get());
+  Vector3 v = quotient_space->getXYZ(EvalState(t));
   if(draw_planar) v[2] = zOffset;
   return v;
 }
 
-Config PathPiecewiseLinear::EvalStates(std::vector<ob::State*> states, const double t) const{
-  ob::SpaceInformationPtr si = quotient_space->SpaceInformationPtr();
+void PathPiecewiseLinear::UpdateCumulativeLength()
+{
+  cumLength.resize(interLength.size()+1);
+  cumLength.at(0) = 0;
+  for(uint i = 0; i < interLength.size(); i++){
+    cumLength.at(i+1) = cumLength.at(i) + interLength.at(i);
+  }
+  segmentCursor = 0;
 
-  if(t<=0){
-    return quotient_space->OMPLStateToConfig(states.front());
+  //rounding errors could lead to the fact that the cumulative length is not
+  //exactly the length. Points beyond are mapped to the last keyframe.
+  double epsilon = 1e-10;
+  if(fabs(length-cumLength.back()) > epsilon){
+    std::cout << "length of path is significantly different from " << length << std::endl;
+    std::cout << "length    : " << cumLength.back() << "/" << length << std::endl;
+    std::cout << "difference: " << length-cumLength.back() << " > " << epsilon << std::endl;
+    OMPL_WARN("Length of path different from computed length.");
   }
-  if(t>=length){
-    return quotient_space->OMPLStateToConfig(states.back());
+}
+
+uint PathPiecewiseLinear::FindSegment(const double t) const
+{
+  uint N = interLength.size();
+  uint i = std::min(segmentCursor, N-1);
+
+  if(cumLength[i] <= t){
+    if(t < cumLength[i+1]) return i;
+    if(i+2 <= N && t < cumLength[i+2]){
+      segmentCursor = i+1;
+      return segmentCursor;
+    }
+  }else if(i > 0 && cumLength[i-1] <= t){
+    segmentCursor = i-1;
+    return segmentCursor;
   }
 
-  double Tcum = 0;
+  //first element larger than t
+  uint k = std::upper_bound(cumLength.begin(), cumLength.end(), t) - cumLength.begin();
+  k = (k > 0 ? k-1 : 0);
+  segmentCursor = std::min(k, N-1);
+  return segmentCursor;
+}
 
+const std::vector<ob::State*>& PathPiecewiseLinear::GetStates() const
+{
+  if(quotient_space->isDynamic()){
+    return static_cast<oc::PathControl*>(path.get())->getStates();
+  }else{
+    return static_cast<og::PathGeometric*>(path.get())->getStates();
+  }
+}
+
+const ob::State* PathPiecewiseLinear::InterpolateState(const std::vector<ob::State*> &states, const double t) const
+{
   assert(interLength.size()==states.size()-1);
+  assert(cumLength.size()==states.size());
 
-  for(uint i = 0; i < interLength.size(); i++){
-    double Tnext = interLength.at(i);
-    if((Tcum+Tnext)>=t){
-      //t \in [Lcum, Lcum+Lnext]
-      double tloc = (t-Tcum)/Tnext; //tloc \in [0,1]
-      ob::State* s1 = states.at(i);
-      ob::State* s2 = states.at(i+1);
-      ob::State* sm = si->allocState();
-      si->getStateSpace()->interpolate(s1,s2,tloc,sm);
-      Config q = quotient_space->OMPLStateToConfig(sm);
-      si->freeState(sm);
-      return q;
-    }
-    Tcum+=Tnext;
-  }
-  //rounding errors could lead to the fact that the cumulative length is not
-  //exactly 1. If t is sufficiently close, we just return the last keyframe.
-  double epsilon = 1e-10;
-  if(length-Tcum > epsilon){
-    std::cout << "length of path is significantly different from " << length << std::endl;
-    std::cout << "length    : " << Tcum << "/" << length << std::endl;
-    std::cout << "difference: " << length-Tcum << " > " << epsilon << std::endl;
-    std::cout << "choosen t : " << t << std::endl;
-    OMPL_ERROR("Length of path different from computed length.");
-    exit(0);
+  if(t >= cumLength.back()) return states.back();
+
+  ob::SpaceInformationPtr si = quotient_space->SpaceInformationPtr();
+  if(!stateTmp){
+    stateTmp = std::shared_ptr<ob::State>(si->allocState(), [si](ob::State *s){ si->freeState(s); });
   }
 
-  if(t>=Tcum){
+  uint i = FindSegment(t);
+  //t \in [Lcum, Lcum+Lnext]
+  double tloc = (t-cumLength.at(i))/interLength.at(i); //tloc \in [0,1]
+  si->getStateSpace()->interpolate(states.at(i), states.at(i+1), tloc, stateTmp.get());
+  return stateTmp.get();
+}
+
+Config PathPiecewiseLinear::EvalStates(const std::vector<ob::State*> &states, const double t) const{
+  if(t<=0){
+    return quotient_space->OMPLStateToConfig(states.front());
+  }
+  if(t>=length){
     return quotient_space->OMPLStateToConfig(states.back());
   }
-  std::cout << "Eval could not find point for value " << t << std::endl;
-  throw;
+  return quotient_space->OMPLStateToConfig(InterpolateState(states, t));
 }
 
 Config PathPiecewiseLinear::Eval(const double t) const{
+  Config q;
+  Eval(t, q);
+  return q;
+}
+
+const ob::State* PathPiecewiseLinear::EvalState(const double t) const{
   if(!path){
     std::cout << "Cannot Eval empty path" << std::endl;
     throw "Empty path";
   }
 
-  std::vector<ob::State *> states;
-  if(quotient_space->isDynamic()){
-    oc::PathControl *cpath = static_cast<oc::PathControl*>(path.get());
-    states = cpath->getStates();
-  }else{
-    og::PathGeometric *gpath = static_cast<og::PathGeometric*>(path.get());
-    states = gpath->getStates();
-  }
-  return EvalStates(states, t);
+  const std::vector<ob::State*> &states = GetStates();
+
+  if(t<=0) return states.front();
+  if(t>=length) return states.back();
+  return InterpolateState(states, t);
+}
+
+void PathPiecewiseLinear::Eval(const double t, Config &q) const{
+  quotient_space->OMPLStateToConfig(EvalState(t), q);
 }
 
 Config PathPiecewiseLinear::EvalVelocity(const double t) const{
@@ -316,54 +357,7 @@ Config PathPiecewiseLinear::EvalVelocity(const double t) const{
     // return dq;
   }
 
-  oc::PathControl cpath = static_cast<oc::PathControl&>(*path);
-  std::vector<ob::State *> states = cpath.getStates();
-
-  ob::SpaceInformationPtr si = quotient_space->SpaceInformationPtr();
-
-  if(t<=0){
-    return quotient_space->OMPLStateToVelocity(states.front());
-  }
-  if(t>=length){
-    return quotient_space->OMPLStateToVelocity(states.back());
-  }
-
-  double Tcum = 0;
-
-  assert(interLength.size()==states.size()-1);
-
-  for(uint i = 0; i < interLength.size(); i++){
-    double Tnext = interLength.at(i);
-    if((Tcum+Tnext)>=t){
-      //t \in [Lcum, Lcum+Lnext]
-      double tloc = (t-Tcum)/Tnext; //tloc \in [0,1]
-      ob::State* s1 = states.at(i);
-      ob::State* s2 = states.at(i+1);
-      ob::State* sm = si->allocState();
-      si->getStateSpace()->interpolate(s1,s2,tloc,sm);
-      Config q = quotient_space->OMPLStateToVelocity(sm);
-      si->freeState(sm);
-      return q;
-    }
-    Tcum+=Tnext;
-  }
-  //rounding errors could lead to the fact that the cumulative length is not
-  //exactly 1. If t is sufficiently close, we just return the last keyframe.
-  double epsilon = 1e-10;
-  if(length-Tcum > epsilon){
-    std::cout << "length of path is significantly different from " << length << std::endl;
-    std::cout << "length    : " << Tcum << "/" << length << std::endl;
-    std::cout << "difference: " << length-Tcum << " > " << epsilon << std::endl;
-    std::cout << "choosen t : " << t << std::endl;
-    throw;
-  }
-
-  if(t>=Tcum){
-    return quotient_space->OMPLStateToVelocity(states.back());
-  }
-
-  std::cout << "Eval could not find point for value " << t << std::endl;
-  throw;
+  return quotient_space->OMPLStateToVelocity(EvalState(t));
 }
 
 Vector3 PathPiecewiseLinear::Vector3FromState(ob::State *s){
@@ -937,6 +931,7 @@ bool PathPiecewiseLinear::Load(TiXmlElement *node)
       path_raw = std::make_shared<og::PathGeometric>(gpath);
     }
   }
+  UpdateCumulativeLength();
   return true;
 }
 
@@ -30,7 +30,9 @@ class PathPiecewiseLinear
     ob::PathPtr GetOMPLPath() const;
 
     Config Eval(const double t) const;
-    Config EvalStates(std::vector<ob::State*> states, const double t) const;
+    //in-place version (no allocation if q has already the right size)
+    void Eval(const double t, Config &q) const;
+    Config EvalStates(const std::vector<ob::State*> &states, const double t) const;
     Config EvalVelocity(const double t) const;
     Vector EvalVelocityVec3(const double t) const;
     Vector3 EvalVec3(const double t) const;
@@ -75,6 +77,22 @@ class PathPiecewiseLinear
   protected:
     double length{0};
     std::vector<double> interLength;//interLength(i) length towards next milestone point from q(i)
+    std::vector<double> cumLength;//cumLength(i) length from q(0) to q(i)
+    void UpdateCumulativeLength();
+
+    //Segment i such that cumLength(i) <= t < cumLength(i+1). Starts searching
+    //at the segment of the last call, such that evaluating at monotonically
+    //increasing (or decreasing) t is amortized O(1). Otherwise binary search.
+    uint FindSegment(const double t) const;
+    mutable uint segmentCursor{0};
+
+    //state at t (only valid until the next evaluation)
+    const ob::State* EvalState(const double t) const;
+    //interpolate path at t (with 0 < t < length) into a reusable state
+    const ob::State* InterpolateState(const std::vector<ob::State*> &states, const double t) const;
+    const std::vector<ob::State*>& GetStates() const;
+    //NOTE: shared by copies of this path, i.e. evaluation is not thread-safe
+    mutable std::shared_ptr<ob::State> stateTmp{nullptr};
 
     bool isSmooth{false};
     Vector3 Vector3FromState(ob::State *s);
@@ -6,6 +6,7 @@
 #include "planner/cspace/validitychecker/validity_checker_ompl.h"
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/foreach.hpp>
+#include <algorithm>
 
 #define foreach BOOST_FOREACH
 
@@ -46,6 +47,11 @@ uint Roadmap::numVertices()
   return pd->numVertices();
 }
 
+void Roadmap::ShareBuffers(const Roadmap &previous)
+{
+  buffers = previous.buffers;
+}
+
 void Roadmap::SetShortestPathOMPL(ob::PathPtr& path_ompl_ptr)
 {
   path_ompl = new PathPiecewiseLinear(path_ompl_ptr, cspace, quotient_space);
@@ -61,8 +67,9 @@ PathPiecewiseLinear* Roadmap::GetShortestPath()
       path_ompl = new PathPiecewiseLinear(pd->path_, cspace, quotient_space);
     }else{
 
-      LemonInterface lemon(pd);
-      std::vector<Vertex> pred = lemon.GetShortestPath();
+      //graph persists between roadmaps on the same planner data
+      RoadmapGraphPtr graph = RoadmapGraph::Get(pd);
+      std::vector<uint> pred = graph->GetShortestPath();
 
       ob::SpaceInformationPtr si = quotient_space->SpaceInformationPtr();
 
@@ -78,7 +85,7 @@ PathPiecewiseLinear* Roadmap::GetShortestPath()
 
       for(uint i = 0; i < pred.size(); i++)
       {
-        Vertex pi = pred.at(i);
+        uint pi = pred.at(i);
         ob::PlannerDataVertexAnnotated *v = dynamic_cast<ob::PlannerDataVertexAnnotated*>(&pd->getVertex(pi));
         const ob::State *s;
         if(v==nullptr){
@@ -114,6 +121,13 @@ PathPiecewiseLinear* Roadmap::GetShortestPath()
 }
 
 
+//state in the quotient space for annotated vertices
+static const ob::State* GetBaseState(const ob::PlannerDataVertex *v)
+{
+  const ob::PlannerDataVertexAnnotated *va = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(v);
+  return (va != nullptr ? va->getBaseState() : v->getState());
+}
+
 Vector3 Roadmap::VectorFromVertex(const ob::PlannerDataVertex *v, int ridx)
 {
   const ob::PlannerDataVertexAnnotated *va = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(v);
@@ -133,130 +147,137 @@ Vector3 Roadmap::VectorFromVertex(const ob::PlannerDataVertex *v, int ridx)
 
 void Roadmap::DrawGLRoadmapVertices(GUIState &state, int ridx)
 {
-  for(uint vidx = 0; vidx < pd->numVertices(); vidx++)
-  {
-    glPointSize(sizeVertex);
-    setColor(cVertex);
-    glPushMatrix();
-
-    ob::PlannerDataVertex *vd = &pd->getVertex(vidx);
-    
-    Vector3 q = VectorFromVertex(vd, ridx);
-
-    if(pd->isStartVertex(vidx))
-    {
-      glPointSize(2*sizeVertex);
-      setColor(cVertexStart);
-    }else{
-      if(pd->isGoalVertex(vidx))
-      {
-        glPointSize(2*sizeVertex);
-        setColor(cVertexGoal);
-      }
-    }
+  RoadmapBuffers &b = GetBuffers(ridx);
 
-    drawPoint(q);
+  glPointSize(sizeVertex);
+  setColor(cVertex);
+  b.vertices.Draw(GL_POINTS);
 
-    glPopMatrix();
+  //start and goal vertices on top
+  glPointSize(2*sizeVertex);
+  for(uint k = 0; k < pd->numStartVertices(); k++)
+  {
+    setColor(cVertexStart);
+    drawPoint(VectorFromVertex(&pd->getStartVertex(k), ridx));
+  }
+  for(uint k = 0; k < pd->numGoalVertices(); k++)
+  {
+    setColor(cVertexGoal);
+    drawPoint(VectorFromVertex(&pd->getGoalVertex(k), ridx));
   }
 }
 
-void Roadmap::DrawGLEdgeStateToState(CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx)
-{
-    Vector3 a = space->getXYZ(s, ridx);
-    Vector3 b = space->getXYZ(t, ridx);
-    if(draw_planar) a[2] = b[2] = 0.0;
-    drawLineSegment(a, b);
-}
-
-void Roadmap::DrawGLEdge(CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx)
+void Roadmap::AppendEdge(RoadmapBuffers &b, CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx)
 {
   ob::StateSpacePtr stateSpace = space->SpaceInformationPtr()->getStateSpace();
 
-  int nd = stateSpace->validSegmentCount(s, t);
+  Vector3 qOld = space->getXYZ(s, ridx);
+  if(draw_planar) qOld[2] = 0.0;
 
-  if(nd <= 1)
-  {
-      DrawGLEdgeStateToState(space, s, t, ridx);
-  }else
+  int nd = std::max(1u, stateSpace->validSegmentCount(s, t));
+  for (int j = 1; j <= nd; j++)
   {
-      stateSpace->copyState(stateTmpOld, s);
-      for (int j = 1; j <= nd; j++)
-      {
-          stateSpace->interpolate(s, t, (double)j / (double)nd, stateTmpCur);
-
-          DrawGLEdgeStateToState(space, stateTmpOld, stateTmpCur, ridx);
+    Vector3 qCur;
+    if(j < nd){
+      stateSpace->interpolate(s, t, (double)j / (double)nd, stateTmpCur);
+      qCur = space->getXYZ(stateTmpCur, ridx);
+    }else{
+      qCur = space->getXYZ(t, ridx);
+    }
+    if(draw_planar) qCur[2] = 0.0;
+    b.edges.Append(qOld);
+    b.edges.Append(qCur);
+    qOld = qCur;
+  }
+}
 
-          stateSpace->copyState(stateTmpOld, stateTmpCur);
-      }
+bool Roadmap::IsPrefixOfPlannerData(const RoadmapBuffers &b, int ridx)
+{
+  if(b.Nvertices == 0) return true;
+  uint idxs[3] = {0, b.Nvertices/2, b.Nvertices-1};
+  for(uint k = 0; k < 3; k++){
+    Vector3 q = VectorFromVertex(&pd->getVertex(idxs[k]), ridx);
+    Vector3 qb = b.vertices.Get(idxs[k]);
+    for(uint j = 0; j < 3; j++){
+      //positions are buffered as floats
+      if((float)q[j] != (float)qb[j]) return false;
+    }
   }
+  return true;
 }
 
-void Roadmap::DrawGLRoadmapEdges(GUIState &state, int ridx)
+RoadmapBuffers& Roadmap::GetBuffers(int ridx)
 {
-  if(pd->numVertices() <= 0) return;
+  RoadmapBuffers &b = (*buffers)[ridx];
 
-  glPushMatrix();
-  glLineWidth(widthEdge);
-  setColor(cEdge);
+  uint N = pd->numVertices();
+  uint E = pd->numEdges();
+  if(N < b.Nvertices || E < b.Nedges || b.planar != draw_planar
+      || !IsPrefixOfPlannerData(b, ridx))
+  {
+    b.Clear();
+  }
+  b.planar = draw_planar;
+  if(N == b.Nvertices && E == b.Nedges) return b;
 
   //############################################################################
   //Get Space
-  ob::PlannerDataVertex *v = &pd->getVertex(0);
-  const ob::PlannerDataVertexAnnotated *va = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(v);
-
-  CSpaceOMPL *curSpace;
-  if(va!=nullptr)
-  {
-      curSpace = quotient_space;
-  }else{
-      curSpace = cspace;
-  }
+  const ob::PlannerDataVertexAnnotated *va = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(&pd->getVertex(0));
+  CSpaceOMPL *curSpace = (va != nullptr ? quotient_space : cspace);
 
   ob::StateSpacePtr stateSpace = curSpace->SpaceInformationPtr()->getStateSpace();
   stateTmpCur = stateSpace->allocState();
-  stateTmpOld = stateSpace->allocState();
   //############################################################################
 
-  for(uint vidx = 0; vidx < pd->numVertices(); vidx++)
+  //new vertices with all their outgoing edges and the incoming edges from
+  //vertices which have been added before
+  uint Nold = b.Nvertices;
+  uint Eadded = 0;
+  std::vector<uint> edgeList;
+  for(uint vidx = Nold; vidx < N; vidx++)
   {
     ob::PlannerDataVertex *v = &pd->getVertex(vidx);
-  //############################################################################
-    const ob::PlannerDataVertexAnnotated *va = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(v);
-    const ob::State *vState;
+    b.vertices.Append(VectorFromVertex(v, ridx));
+    const ob::State *vState = GetBaseState(v);
 
-    if(va!=nullptr)
-    {
-      vState = va->getBaseState();
-    }else{
-      vState = v->getState();
-    }
-  //############################################################################
-
-    std::vector<uint> edgeList;
     pd->getEdges(vidx, edgeList);
-
     for(uint j = 0; j < edgeList.size(); j++){
+      AppendEdge(b, curSpace, vState, GetBaseState(&pd->getVertex(edgeList.at(j))), ridx);
+    }
+    Eadded += edgeList.size();
 
-      ob::PlannerDataVertex *w = &pd->getVertex(edgeList.at(j));
-  //############################################################################
-      const ob::PlannerDataVertexAnnotated *wa = dynamic_cast<const ob::PlannerDataVertexAnnotated*>(w);
-      const ob::State *wState;
-      if(wa!=nullptr)
-      {
-        wState = wa->getBaseState();
-      }else{
-        wState = w->getState();
-      }
-  //############################################################################
-
-      DrawGLEdge(curSpace, vState, wState, ridx);
-
+    pd->getIncomingEdges(vidx, edgeList);
+    for(uint j = 0; j < edgeList.size(); j++){
+      uint uidx = edgeList.at(j);
+      if(uidx >= Nold) continue;
+      AppendEdge(b, curSpace, GetBaseState(&pd->getVertex(uidx)), vState, ridx);
+      Eadded++;
     }
   }
   stateSpace->freeState(stateTmpCur);
-  stateSpace->freeState(stateTmpOld);
-  glPopMatrix();
+  stateTmpCur = nullptr;
+
+  b.Nvertices = N;
+  b.Nedges += Eadded;
+  if(b.Nedges != E && Nold > 0)
+  {
+    //edges between existing vertices have been added or removed
+    b.Clear();
+    return GetBuffers(ridx);
+  }
+  b.Nedges = E;
+  return b;
+}
+
+void Roadmap::DrawGLRoadmapEdges(GUIState &state, int ridx)
+{
+  if(pd->numVertices() <= 0) return;
+
+  RoadmapBuffers &b = GetBuffers(ridx);
+
+  glLineWidth(widthEdge);
+  setColor(cEdge);
+  b.edges.Draw(GL_LINES);
 }
 
 void Roadmap::drawLineWorkspaceStateToState(const ob::State *from, const ob::State *to, int ridx)
@@ -365,3 +386,36 @@ bool Roadmap::Save(TiXmlElement *node)
   return true;
 }
 
+
+void Roadmap::GetSamples(RoadmapSamples &samples)
+{
+  samples.Clear();
+  if(pd == nullptr) return;
+
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  ob::StateSpacePtr space = si->getStateSpace();
+
+  uint N = pd->numVertices();
+  std::vector<double> state_serialized;
+  std::vector<uint> edgeList;
+  samples.feasible.resize(N);
+  samples.edges.reserve(2*pd->numEdges());
+  for(uint vidx = 0; vidx < N; vidx++){
+    ob::PlannerDataVertex *vd = &pd->getVertex(vidx);
+    space->copyToReals(state_serialized, vd->getState());
+    if(vidx == 0){
+      samples.dimension = state_serialized.size();
+      samples.states.reserve(N*samples.dimension);
+    }
+    samples.states.insert(samples.states.end(), state_serialized.begin(), state_serialized.end());
+
+    ob::PlannerDataVertexAnnotated *v = dynamic_cast<ob::PlannerDataVertexAnnotated*>(vd);
+    samples.feasible.at(vidx) = (v != nullptr);
+
+    pd->getEdges(vidx, edgeList);
+    for(uint j = 0; j < edgeList.size(); j++){
+      samples.edges.push_back(vidx);
+      samples.edges.push_back(edgeList.at(j));
+    }
+  }
+}
@@ -1,12 +1,15 @@
 #pragma once
-#include "algorithms/lemon_interface.h"
+#include "algorithms/roadmap_graph.h"
 #include "planner/cspace/cspace.h"
 #include "elements/path_pwl.h"
+#include "elements/roadmap_sample_writer.h"
+#include "elements/roadmap_buffers.h"
 #include "gui/gui_state.h"
 
 #include <ompl/base/PlannerData.h>
 #include <KrisLibrary/GLdraw/GLColor.h>
 #include <KrisLibrary/robotics/RobotKinematics3D.h> //Config
+#include <map>
 
 namespace ob = ompl::base;
 
@@ -24,6 +27,8 @@ class Roadmap{
 
     bool Save(const char* fn);
     bool Save(TiXmlElement *node);
+    //copy states and edges into (binary) sample buffer
+    void GetSamples(RoadmapSamples &samples);
 
     GLDraw::GLColor cEdge{green};
     GLDraw::GLColor cVertex{green};
@@ -37,15 +42,25 @@ class Roadmap{
     uint numEdges();
     uint numVertices();
 
+    //continue with the retained geometry of a roadmap which has been created
+    //from an earlier version of the same planner data (the hierarchical
+    //roadmap is recreated after each planner step)
+    void ShareBuffers(const Roadmap &previous);
+
   private:
 
     void DrawGLPlannerData(GUIState&);
     //void DrawGLShortestPath(GUIState&);
     void DrawGLRoadmapVertices(GUIState&, int ridx = -1);
     void DrawGLRoadmapEdges(GUIState&, int ridx = -1);
-    void DrawGLEdge(const ob::PlannerDataVertex *v, const ob::PlannerDataVertex *w, int ridx);
-    void DrawGLEdge(CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx);
-    void DrawGLEdgeStateToState(CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx);
+    //buffers of robot ridx, with the vertices and edges added to the planner
+    //data since the last call (rebuilt if the planner data has been changed
+    //otherwise)
+    RoadmapBuffers& GetBuffers(int ridx);
+    //spot check if the buffered vertices are still the first vertices of the
+    //planner data (i.e. vertices have not been removed or reordered)
+    bool IsPrefixOfPlannerData(const RoadmapBuffers &b, int ridx);
+    void AppendEdge(RoadmapBuffers &buffers, CSpaceOMPL *space, const ob::State *s, const ob::State *t, int ridx);
     void drawLineWorkspaceStateToState(const ob::State *from, const ob::State *to, int ridx);
     Vector3 VectorFromVertex(const ob::PlannerDataVertex *v, int ridx);
 
@@ -57,7 +72,11 @@ class Roadmap{
     std::vector<Vector3> shortest_path;
     bool draw_planar{false};
 
+    //retained geometry per robot index (-1: all robots), shared with the
+    //roadmaps of later planner steps
+    std::shared_ptr<std::map<int, RoadmapBuffers>> buffers{
+      std::make_shared<std::map<int, RoadmapBuffers>>()};
+
     ob::State *stateTmpCur{nullptr};
-    ob::State *stateTmpOld{nullptr};
 };
 typedef std::shared_ptr<Roadmap> RoadmapPtr;
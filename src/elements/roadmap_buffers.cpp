@@ -0,0 +1,69 @@
+#define GL_GLEXT_PROTOTYPES
+#include "elements/roadmap_buffers.h"
+#include <KrisLibrary/GLdraw/GL.h>
+#include <GL/glext.h>
+#include <algorithm>
+
+GLVertexBuffer::~GLVertexBuffer()
+{
+  if(id != 0) glDeleteBuffers(1, &id);
+}
+
+void GLVertexBuffer::Append(const Vector3 &q)
+{
+  positions.push_back(q[0]);
+  positions.push_back(q[1]);
+  positions.push_back(q[2]);
+}
+
+void GLVertexBuffer::Clear()
+{
+  positions.clear();
+  uploaded = 0;
+}
+
+uint GLVertexBuffer::size() const
+{
+  return positions.size()/3;
+}
+
+Vector3 GLVertexBuffer::Get(uint k) const
+{
+  return Vector3(positions.at(3*k), positions.at(3*k+1), positions.at(3*k+2));
+}
+
+void GLVertexBuffer::Upload()
+{
+  if(uploaded == positions.size()) return;
+  if(id == 0) glGenBuffers(1, &id);
+  glBindBuffer(GL_ARRAY_BUFFER, id);
+  if(positions.size() > capacity){
+    capacity = std::max<uint>(2*capacity, positions.size());
+    glBufferData(GL_ARRAY_BUFFER, capacity*sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    uploaded = 0;
+  }
+  glBufferSubData(GL_ARRAY_BUFFER, uploaded*sizeof(float),
+      (positions.size() - uploaded)*sizeof(float), &positions[uploaded]);
+  uploaded = positions.size();
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GLVertexBuffer::Draw(unsigned int mode)
+{
+  Upload();
+  if(positions.empty()) return;
+  glBindBuffer(GL_ARRAY_BUFFER, id);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, nullptr);
+  glDrawArrays(mode, 0, size());
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RoadmapBuffers::Clear()
+{
+  vertices.Clear();
+  edges.Clear();
+  Nvertices = 0;
+  Nedges = 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <KrisLibrary/math3d/primitives.h>
+#include <vector>
+
+using Math3D::Vector3;
+
+//GLVertexBuffer: vertex buffer object of 3D positions, which only grows.
+//Positions are appended on the host, and Upload copies the appended range
+//into the buffer (the buffer is reallocated with twice the size if it is too
+//small). Upload and Draw require a current GL context.
+class GLVertexBuffer
+{
+  public:
+    GLVertexBuffer() = default;
+    //owns the GL buffer
+    GLVertexBuffer(const GLVertexBuffer&) = delete;
+    GLVertexBuffer& operator=(const GLVertexBuffer&) = delete;
+    ~GLVertexBuffer();
+
+    void Append(const Vector3 &q);
+    //removes all positions (the GL buffer is kept for reuse)
+    void Clear();
+    uint size() const;
+    //k-th position
+    Vector3 Get(uint k) const;
+
+    void Upload();
+    //one draw call for all positions (GL_POINTS, GL_LINES, ..)
+    void Draw(unsigned int mode);
+
+  private:
+    std::vector<float> positions;
+    unsigned int id{0};
+    //in number of floats
+    uint capacity{0};
+    uint uploaded{0};
+};
+
+//RoadmapBuffers: retained-mode geometry of a roadmap, i.e. the projected
+//vertex positions and the interpolated edge polylines (as line segments).
+struct RoadmapBuffers
+{
+  GLVertexBuffer vertices;
+  GLVertexBuffer edges;
+
+  //number of planner data vertices and edges which have been added
+  uint Nvertices{0};
+  uint Nedges{0};
+  bool planar{false};
+
+  void Clear();
+};
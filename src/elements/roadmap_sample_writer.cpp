@@ -0,0 +1,208 @@
+#include "elements/roadmap_sample_writer.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const char RoadmapSamples::MAGIC[8] = {'M','X','S','A','M','P','L','E'};
+
+namespace{
+  uint64_t HashBytes(uint64_t h, const void *data, size_t size)
+  {
+    //FNV-1a
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    for(size_t k = 0; k < size; k++){
+      h ^= p[k];
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+  void WritePadding(std::ofstream &file, size_t size)
+  {
+    static const char zeros[8] = {0};
+    if(size % 8 != 0) file.write(zeros, 8 - size % 8);
+  }
+  size_t Padded(size_t size)
+  {
+    return (size + 7) / 8 * 8;
+  }
+}
+
+uint64_t RoadmapSamples::numVertices() const
+{
+  return feasible.size();
+}
+
+uint64_t RoadmapSamples::numEdges() const
+{
+  return edges.size() / 2;
+}
+
+void RoadmapSamples::Clear()
+{
+  dimension = 0;
+  states.clear();
+  feasible.clear();
+  edges.clear();
+}
+
+uint64_t RoadmapSamples::Hash() const
+{
+  uint64_t h = 14695981039346656037ULL;
+  h = HashBytes(h, &dimension, sizeof(dimension));
+  h = HashBytes(h, states.data(), states.size()*sizeof(double));
+  h = HashBytes(h, feasible.data(), feasible.size()*sizeof(uint8_t));
+  h = HashBytes(h, edges.data(), edges.size()*sizeof(uint32_t));
+  return h;
+}
+
+bool RoadmapSamples::Save(const std::string &fname) const
+{
+  std::ofstream file(fname, std::ios::binary | std::ios::trunc);
+  if(!file.is_open()){
+    std::cout << "Could not open " << fname << " for writing." << std::endl;
+    return false;
+  }
+  uint32_t version = VERSION;
+  uint64_t Nv = numVertices();
+  uint64_t Ne = numEdges();
+  file.write(MAGIC, sizeof(MAGIC));
+  file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  file.write(reinterpret_cast<const char*>(&dimension), sizeof(dimension));
+  file.write(reinterpret_cast<const char*>(&Nv), sizeof(Nv));
+  file.write(reinterpret_cast<const char*>(&Ne), sizeof(Ne));
+
+  file.write(reinterpret_cast<const char*>(states.data()), states.size()*sizeof(double));
+  file.write(reinterpret_cast<const char*>(feasible.data()), feasible.size());
+  WritePadding(file, feasible.size());
+  file.write(reinterpret_cast<const char*>(edges.data()), edges.size()*sizeof(uint32_t));
+  WritePadding(file, edges.size()*sizeof(uint32_t));
+  return file.good();
+}
+
+bool RoadmapSamples::Load(const std::string &fname)
+{
+  Clear();
+  std::ifstream file(fname, std::ios::binary);
+  if(!file.is_open()) return false;
+
+  char magic[8];
+  uint32_t version;
+  uint64_t Nv, Ne;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&dimension), sizeof(dimension));
+  file.read(reinterpret_cast<char*>(&Nv), sizeof(Nv));
+  file.read(reinterpret_cast<char*>(&Ne), sizeof(Ne));
+  if(!file.good() || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0){
+    std::cout << fname << " is not a sample file." << std::endl;
+    return false;
+  }
+  if(version != VERSION){
+    std::cout << fname << " has version " << version << " (expected " << VERSION << ")." << std::endl;
+    return false;
+  }
+
+  states.resize(Nv*dimension);
+  feasible.resize(Nv);
+  edges.resize(2*Ne);
+  file.read(reinterpret_cast<char*>(states.data()), states.size()*sizeof(double));
+  file.read(reinterpret_cast<char*>(feasible.data()), feasible.size());
+  file.ignore(Padded(feasible.size()) - feasible.size());
+  file.read(reinterpret_cast<char*>(edges.data()), edges.size()*sizeof(uint32_t));
+  if(!file.good()){
+    Clear();
+    return false;
+  }
+  return true;
+}
+
+//##############################################################################
+//##############################################################################
+
+RoadmapSampleWriter& RoadmapSampleWriter::Get()
+{
+  static RoadmapSampleWriter writer;
+  return writer;
+}
+
+RoadmapSampleWriter::RoadmapSampleWriter()
+{
+  thread = std::thread(&RoadmapSampleWriter::Run, this);
+}
+
+RoadmapSampleWriter::~RoadmapSampleWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cvSubmit.notify_one();
+  if(thread.joinable()) thread.join();
+}
+
+void RoadmapSampleWriter::Write(const std::string &fname, RoadmapSamples &samples)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    RoadmapSamples &target = back[fname];
+    std::swap(target, samples);
+  }
+  samples.Clear();
+  cvSubmit.notify_one();
+}
+
+void RoadmapSampleWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  cvDone.wait(lock, [this]{ return back.empty() && !busy; });
+}
+
+uint RoadmapSampleWriter::GetNumberOfWrites() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return Nwrites;
+}
+
+uint RoadmapSampleWriter::GetNumberOfSkippedWrites() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return Nskipped;
+}
+
+void RoadmapSampleWriter::Run()
+{
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cvSubmit.wait(lock, [this]{ return stop || !back.empty(); });
+      if(back.empty() && stop) return;
+      //writes pending samples before stopping
+      std::swap(front, back);
+      busy = true;
+    }
+
+    uint written = 0;
+    uint skipped = 0;
+    for(auto &entry: front){
+      uint64_t h = entry.second.Hash();
+      auto it = lastHash.find(entry.first);
+      if(it != lastHash.end() && it->second == h){
+        skipped++;
+        continue;
+      }
+      if(entry.second.Save(entry.first)){
+        lastHash[entry.first] = h;
+        written++;
+      }
+    }
+    front.clear();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      busy = false;
+      Nwrites += written;
+      Nskipped += skipped;
+    }
+    cvDone.notify_all();
+  }
+}
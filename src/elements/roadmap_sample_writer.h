@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Binary roadmap sample file (version 1). All numbers are stored in native
+//(little endian) byte order, each section is aligned to 8 bytes, such that
+//the file can be memory-mapped:
+//
+//  header    : char magic[8] "MXSAMPLE", uint32 version, uint32 dimension,
+//              uint64 number of vertices, uint64 number of edges
+//  states    : double[vertices * dimension]
+//  feasible  : uint8[vertices] (padded to 8 bytes)
+//  edges     : uint32[2 * edges] (pairs of vertex indices, padded to 8 bytes)
+struct RoadmapSamples
+{
+  static const char MAGIC[8];
+  static const uint32_t VERSION = 1;
+
+  uint32_t dimension{0};
+  std::vector<double> states;
+  std::vector<uint8_t> feasible;
+  std::vector<uint32_t> edges;
+
+  uint64_t numVertices() const;
+  uint64_t numEdges() const;
+  void Clear();
+
+  //hash over all sections (to detect unchanged roadmaps)
+  uint64_t Hash() const;
+
+  bool Save(const std::string &fname) const;
+  bool Load(const std::string &fname);
+};
+
+//RoadmapSampleWriter: writes sample files on a background thread. Samples
+//are submitted to a back buffer (newer samples for the same file replace
+//older ones which have not been written yet), which the writer swaps with
+//its front buffer. Files are not rewritten if their content did not change
+//since the last write.
+class RoadmapSampleWriter
+{
+  public:
+    static RoadmapSampleWriter& Get();
+
+    //samples are moved into the writer
+    void Write(const std::string &fname, RoadmapSamples &samples);
+
+    //block until all submitted samples are written
+    void Flush();
+
+    uint GetNumberOfWrites() const;
+    uint GetNumberOfSkippedWrites() const;
+
+    ~RoadmapSampleWriter();
+
+  private:
+    RoadmapSampleWriter();
+    void Run();
+
+    std::map<std::string, RoadmapSamples> back;
+    std::map<std::string, RoadmapSamples> front;
+    std::map<std::string, uint64_t> lastHash;
+
+    mutable std::mutex mutex;
+    std::condition_variable cvSubmit;
+    std::condition_variable cvDone;
+    bool busy{false};
+    bool stop{false};
+
+    uint Nwrites{0};
+    uint Nskipped{0};
+
+    std::thread thread;
+};
@@ -7,6 +7,8 @@
 #include "elements/forcefields/forcefield_random.h"
 #include "elements/forcefields/forcefield_obb.h"
 #include "elements/forcefields/forcefield_cylindrical.h"
+#include "elements/forcefields/forcefield_grid.h"
+#include <algorithm>
 
 using namespace Math3D;
 using namespace GLDraw;
@@ -183,6 +185,34 @@ bool WrenchField::Load(TiXmlElement *node)
     field = FindNextSiblingNode(field, "cylindrical");
   }
 
+  //store fields of the same type contiguously, such that batched evaluation
+  //runs the same loop for all fields of a type
+  std::stable_sort(forcefields.begin(), forcefields.end(),
+      [](const ForceFieldPtr &a, const ForceFieldPtr &b){ return a->type() < b->type(); });
+
+  //############################################################################
+  //Grid: precompute all static fields inside the given box
+  //############################################################################
+  //<grid min="-5 -5 0" max="5 5 5" error="0.01" maxcells="1000000"/>
+  TiXmlElement* grid = FindSubNode(forcefieldsettings, "grid");
+  if(grid){
+    Vector3 gmin = GetAttribute<Vector3>(grid, "min");
+    Vector3 gmax = GetAttribute<Vector3>(grid, "max");
+    double error = GetAttributeDefault<double>(grid, "error", 1e-2);
+    uint maxcells = GetAttributeDefault<int>(grid, "maxcells", 1000000);
+
+    std::vector<ForceFieldPtr> static_fields, dynamic_fields;
+    for(uint k = 0; k < forcefields.size(); k++){
+      if(forcefields.at(k)->isStatic()) static_fields.push_back(forcefields.at(k));
+      else dynamic_fields.push_back(forcefields.at(k));
+    }
+    if(!static_fields.empty()){
+      forcefields = dynamic_fields;
+      ForceFieldPtr fg(new GridForceField(static_fields, gmin, gmax, error, maxcells));
+      forcefields.push_back(fg);
+    }
+  }
+
   return true;
 }
 
@@ -208,6 +238,21 @@ Vector3 WrenchField::getForce(const Vector3 &position, const Vector3 &velocity){
 
   return F;
 }
+void WrenchField::getForces(const std::vector<Vector3> &positions, const std::vector<Vector3> &velocities, std::vector<Vector3> &forces)
+{
+  if(!velocities.empty() && velocities.size() != positions.size()){
+    std::cout << "[WrenchField] number of velocities " << velocities.size()
+      << " does not match number of positions " << positions.size() << std::endl;
+    throw "Invalid number of velocities.";
+  }
+  forces.resize(positions.size());
+  std::fill(forces.begin(), forces.end(), Vector3(0,0,0));
+
+  for(uint i = 0; i < forcefields.size(); i++){
+    forcefields.at(i)->addForces(positions, velocities, forces);
+  }
+}
+
 Vector3 WrenchField::getTorqueFieldAtPosition(Vector3 &position, Vector3 &origin){
 
   Vector3 T(0,0,0);
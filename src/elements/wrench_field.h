@@ -43,6 +43,11 @@ class WrenchField{
 
     Math3D::Vector3 getForce(const Math3D::Vector3 &position, const Math3D::Vector3 &velocity = Math3D::Vector3(0,0,0));
 
+    //batched getForce: forces[k] = getForce(positions[k], velocities[k]).
+    //velocities is either empty (zero velocity) or of the same size as
+    //positions. One virtual call per field instead of per field and position.
+    void getForces(const std::vector<Math3D::Vector3> &positions, const std::vector<Math3D::Vector3> &velocities, std::vector<Math3D::Vector3> &forces);
+
     //TODO: force at origin induced by force at position 
     Math3D::Vector3 getTorqueFieldAtPosition(Math3D::Vector3 &position, Math3D::Vector3 &origin);
 
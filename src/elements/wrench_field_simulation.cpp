@@ -0,0 +1,125 @@
+#include "elements/wrench_field_simulation.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace Math3D;
+
+WrenchFieldSimulation::WrenchFieldSimulation(WorldSimulation *sim_, WrenchField *wrenchfield_, uint robot_idx_):
+  sim(sim_), wrenchfield(wrenchfield_), robot_idx(robot_idx_)
+{
+  step = [this](double dt){
+    sim->Advance(dt);
+    sim->UpdateModel();
+  };
+}
+
+void WrenchFieldSimulation::Clear()
+{
+  //only compare addresses, the hooks might already be deleted
+  auto &simhooks = sim->hooks;
+  simhooks.erase(std::remove_if(simhooks.begin(), simhooks.end(),
+        [this](const SmartPointer<WorldSimulationHook> &hook){
+          return std::find(hooks.begin(), hooks.end(), &(*hook)) != hooks.end();
+        }), simhooks.end());
+  hooks.clear();
+  links.clear();
+  remainder = 0;
+}
+
+void WrenchFieldSimulation::CreateHooks()
+{
+  ODERobot *simrobot = sim->odesim.robot(robot_idx);
+  uint Nlinks = simrobot->robot.links.size();
+  if(wrenchfield->size() != Nlinks) wrenchfield->init(Nlinks);
+
+  for(uint i = 0; i < Nlinks; i++){
+    dBodyID bodyid = simrobot->body(i);
+    if(!bodyid || simrobot->robot.IsGeometryEmpty(i)) continue;
+    WrenchHook *hook = new WrenchHook(bodyid, Vector3(0,0,0), Vector3(0,0,0));
+    sim->hooks.push_back(hook);
+    hooks.push_back(hook);
+    links.push_back(i);
+  }
+  positions.resize(links.size());
+  velocities.resize(links.size());
+  forces.resize(links.size());
+}
+
+void WrenchFieldSimulation::UpdateWrenches()
+{
+  if(hooks.empty()) CreateHooks();
+
+  Robot &robot = sim->odesim.robot(robot_idx)->robot;
+  for(uint k = 0; k < links.size(); k++){
+    RobotLink3D &link = robot.links[links[k]];
+    link.GetWorldCOM(positions[k]);
+    velocities[k] = robot.GetLinearMomentum(links[k])/link.mass;
+  }
+
+  wrenchfield->getForces(positions, velocities, forces);
+
+  Vector3 torque(0,0,0);
+  for(uint k = 0; k < links.size(); k++){
+    hooks[k]->f = forces[k];
+    hooks[k]->m = torque;
+    wrenchfield->setPosition(links[k], positions[k]);
+    wrenchfield->setForce(links[k], forces[k]);
+    wrenchfield->setTorque(links[k], torque);
+  }
+}
+
+void WrenchFieldSimulation::Step()
+{
+  UpdateWrenches();
+  step(timestep);
+}
+
+uint WrenchFieldSimulation::Advance(double elapsed)
+{
+  remainder += elapsed;
+  uint Nsteps = 0;
+  while(remainder >= timestep && Nsteps < maxStepsPerAdvance){
+    Step();
+    remainder -= timestep;
+    Nsteps++;
+  }
+  //drop time which could not be simulated in real time
+  if(remainder >= timestep) remainder = 0;
+  return Nsteps;
+}
+
+uint WrenchFieldSimulation::Run(double duration)
+{
+  uint Nsteps = std::floor(duration/timestep);
+  for(uint k = 0; k < Nsteps; k++){
+    Step();
+  }
+  return Nsteps;
+}
+
+void WrenchFieldSimulation::SetRobot(uint robot_idx_)
+{
+  if(robot_idx_ == robot_idx) return;
+  Clear();
+  robot_idx = robot_idx_;
+}
+void WrenchFieldSimulation::SetTimeStep(double timestep_)
+{
+  timestep = timestep_;
+}
+double WrenchFieldSimulation::GetTimeStep() const
+{
+  return timestep;
+}
+double WrenchFieldSimulation::GetTimeToNextStep() const
+{
+  return std::max(0.0, timestep - remainder);
+}
+void WrenchFieldSimulation::SetMaxStepsPerAdvance(uint maxSteps)
+{
+  maxStepsPerAdvance = maxSteps;
+}
+void WrenchFieldSimulation::SetStepFunction(const std::function<void(double)> &step_)
+{
+  step = step_;
+}
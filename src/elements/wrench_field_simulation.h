@@ -0,0 +1,62 @@
+#pragma once
+#include "elements/wrench_field.h"
+#include <Simulation/WorldSimulation.h>
+#include <functional>
+#include <vector>
+
+//Applies a WrenchField to the links of a simulated robot and advances the
+//simulation at a fixed rate, independent of the GUI (see ForceFieldBackend).
+//
+//Each link with geometry gets one WrenchHook, which is added to sim->hooks
+//once and whose force is updated in place on every step. The hooks are owned
+//by sim->hooks, i.e. Clear() has to be called whenever sim->hooks is cleared.
+class WrenchFieldSimulation
+{
+  public:
+    WrenchFieldSimulation(WorldSimulation *sim, WrenchField *wrenchfield, uint robot_idx = 0);
+
+    //removes the hooks from the simulation (recreated on the next step)
+    void Clear();
+
+    //computes the wrench on each link and updates the hooks
+    void UpdateWrenches();
+
+    //UpdateWrenches and advance the simulation by the time step
+    void Step();
+
+    //fixed-rate loop: performs all (full) time steps within elapsed seconds
+    //and carries over the remainder. Returns the number of steps.
+    uint Advance(double elapsed);
+
+    //headless: simulate for duration seconds. Returns the number of steps.
+    uint Run(double duration);
+
+    void SetRobot(uint robot_idx);
+    void SetTimeStep(double timestep);
+    double GetTimeStep() const;
+    //time until Advance performs the next step
+    double GetTimeToNextStep() const;
+    //bound on steps per Advance, such that slow steps do not accumulate
+    void SetMaxStepsPerAdvance(uint maxSteps);
+    //default: sim->Advance(dt) followed by sim->UpdateModel()
+    void SetStepFunction(const std::function<void(double)> &step);
+
+  private:
+    void CreateHooks();
+
+    WorldSimulation *sim;
+    WrenchField *wrenchfield;
+    uint robot_idx;
+
+    //one hook per link in links (owned by sim->hooks)
+    std::vector<WrenchHook*> hooks;
+    std::vector<int> links;
+    std::vector<Math3D::Vector3> positions;
+    std::vector<Math3D::Vector3> velocities;
+    std::vector<Math3D::Vector3> forces;
+
+    std::function<void(double)> step;
+    double timestep{0.01};
+    double remainder{0};
+    uint maxStepsPerAdvance{10};
+};
@@ -0,0 +1,165 @@
+#include "environment_loader_headless.h"
+#include "file_io.h"
+
+bool HeadlessEnvironmentLoader::SetupWorld(RobotWorld &world, PlannerMultiInput &pin, const char *file_name)
+{
+  if(world.robots.size() <= 0 || !pin.Load(file_name)) return false;
+
+  //Adding triangle information to PlannerInput (to be used as constraint
+  //manifolds)
+  std::vector<Triangle3D> tris;
+  for(uint k = 0; k < world.terrains.size(); k++){
+    Terrain* terrain_k = world.terrains[k];
+    const CollisionMesh mesh = terrain_k->geometry->TriangleMeshCollisionData();
+    for(uint j = 0; j < mesh.tris.size(); j++){
+      Triangle3D tri;
+      mesh.GetTriangle(j, tri);
+      tris.push_back(tri);
+    }
+  }
+  std::cout << "Environment has " << tris.size() << " triangles to make contact." << std::endl;
+
+  for(uint k = 0; k < pin.inputs.size(); k++){
+    PlannerInput *pkin = pin.inputs.at(k);
+    if(pkin->contactPlanner){
+      pkin->tris = tris;
+    }
+    for(uint j = 0; j < pkin->stratifications.size(); j++){
+      Stratification stratification = pkin->stratifications.at(j);
+      for(uint i = 0; i < stratification.layers.size(); i++){
+        Layer layer = stratification.layers.at(i);
+        if(!layer.isMultiAgent){
+          uint ri = layer.inner_index;
+          uint ro = layer.outer_index;
+          if(ri>=world.robots.size()){
+            std::cout << std::string(80, '>') << std::endl;
+            std::cout << ">>> [ERROR] Robot with idx " << ri << " does not exists." << std::endl;
+            std::cout << std::string(80, '>') << std::endl;
+            throw "Invalid robot idx.";
+          }
+          if(ro>=world.robots.size()){
+            std::cout << std::string(80, '>') << std::endl;
+            std::cout << ">>> [ERROR] Robot with idx " << ro << " does not exists." << std::endl;
+            std::cout << std::string(80, '>') << std::endl;
+            throw "Invalid robot idx.";
+          }
+
+          Robot *rk= world.robots.at(ri);
+          Robot *rko= world.robots.at(ro);
+          for(int i = 0; i < 6; i++){
+            rk->qMin[i] = pkin->se3min[i];
+            rk->qMax[i] = pkin->se3max[i];
+            rko->qMin[i] = pkin->se3min[i];
+            rko->qMax[i] = pkin->se3max[i];
+          }
+          // rk->q = pkin->q_init;
+          // rk->dq = pkin->dq_init;
+          // rk->UpdateFrames();
+          // rko->q = pkin->q_init;
+          // rko->dq = pkin->dq_init;
+          // rko->UpdateFrames();
+        }
+      }//for layers
+    }//for stratifications
+  }//for inputs
+
+  PlannerInput *pkin = pin.inputs.at(0);
+  if(pkin->multiAgent){
+    //multiagent settings
+
+    for(uint k = 0; k < world.robots.size(); k++)
+    {
+        Robot *rk= world.robots.at(k);
+        for(int i = 0; i < 6; i++){
+          rk->qMin[i] = pkin->se3min[i];
+          rk->qMax[i] = pkin->se3max[i];
+        }
+    }
+    for(uint k = 0; k < pkin->agent_information.size(); k++){
+      AgentInformation ai = pkin->agent_information.at(k);
+      int ri = ai.id;
+      if(ri>=(int)world.robots.size()){
+        OMPL_ERROR("Specified AgentInformation for id %d, but robots only have ids of 0 to %d.", ai.id, world.robots.size()-1);
+        throw "Invalid robot idx.";
+      }
+      Robot *rk= world.robots.at(ri);
+      if(ai.qMin.size()>0){
+        for(int i = 0; i < 6; i++){
+            rk->qMin[i] = ai.qMin[i];
+            rk->qMax[i] = ai.qMax[i];
+        }
+      }else{
+        for(int i = 0; i < 6; i++){
+            rk->qMin[i] = pkin->se3min[i];
+            rk->qMax[i] = pkin->se3max[i];
+        }
+      }
+      if(ai.uMin.size() > 0){
+        for(int i = 0; i < 6; i++){
+            rk->torqueMax[i] = ai.uMax[i];
+        }
+      }
+    }
+  }else{
+    uint ridx = pin.inputs.at(0)->robot_idx;
+    Robot *robot = world.robots[ridx];
+    Vector q_init = pin.inputs.at(0)->q_init;
+    Vector q_goal = pin.inputs.at(0)->q_goal;
+    Vector dq_init = pin.inputs.at(0)->dq_init;
+
+    // for(int i = 0; i < 6; i++){
+    //   robot->qMin[i] = pin.inputs.at(0)->se3min[i];
+    //   robot->qMax[i] = pin.inputs.at(0)->se3max[i];
+    // }
+
+    // pin.inputs.at(0)->qMin = robot->qMin;
+    // pin.inputs.at(0)->qMax = robot->qMax;
+    uint N = robot->q.size();
+
+    uint Ni = pin.inputs.at(0)->q_init.size();
+    uint Ng = pin.inputs.at(0)->q_goal.size();
+    if(Ni!=N){
+      std::cout << std::string(80, '#') << std::endl;
+      std::cout << "q_init has " << Ni << " dofs, but robot " << robot->name << " expects " << N << " dofs." << std::endl;
+      std::cout << std::string(80, '#') << std::endl;
+      throw "Invalid dofs.";
+    }
+    if(Ng!=N){
+      std::cout << std::string(80, '#') << std::endl;
+      std::cout << "q_goal has " << Ng << " dofs, but robot " << robot->name << " expects " << N << " dofs." << std::endl;
+      std::cout << std::string(80, '#') << std::endl;
+      throw "Invalid dofs.";
+    }
+
+    robot->q = q_init;
+    robot->dq = dq_init;
+    robot->UpdateFrames();
+
+  }
+  return true;
+}
+
+HeadlessEnvironmentLoader::HeadlessEnvironmentLoader(const char *file_name_)
+{
+  file_name = file_name_;
+
+  std::cout << "[HeadlessEnvironmentLoader] loading from file " << file_name << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+
+  if(!world.LoadXML(file_name.c_str()))
+  {
+    std::cout << "XML file does not exists or corrupted: "<< file_name << std::endl;
+    throw "Invalid name";
+  }
+  if(!SetupWorld(world, pin, file_name.c_str()))
+  {
+    std::cout << "No Planner Settings. No Planning" << std::endl;
+  }
+}
+
+RobotWorld* HeadlessEnvironmentLoader::GetWorldPtr(){
+  return &world;
+}
+PlannerMultiInput HeadlessEnvironmentLoader::GetPlannerInput(){
+  return pin;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "planner/planner_input.h"
+#include <Modeling/World.h>
+#include <KrisLibrary/geometry/CollisionMesh.h>
+#include <ompl/util/Console.h>
+#include <string>
+
+//HeadlessEnvironmentLoader: loads the world and planner settings of an
+//environment without the simulation backend and GUI (see EnvironmentLoader),
+//e.g. for batch planning on machines without display.
+class HeadlessEnvironmentLoader{
+  private:
+    std::string file_name;
+    RobotWorld world;
+    PlannerMultiInput pin;
+
+  public:
+    HeadlessEnvironmentLoader(const char *xml_file);
+
+    RobotWorld* GetWorldPtr();
+    PlannerMultiInput GetPlannerInput();
+
+    //load planner settings of file and apply them to the robots of world
+    //(joint limits, start configuration). False if there are no planner
+    //settings.
+    static bool SetupWorld(RobotWorld &world, PlannerMultiInput &pin, const char *file_name);
+};
@@ -344,15 +344,16 @@ namespace GLDraw{
 
     SmartPointer<ContactStabilityController>& controller = *reinterpret_cast<SmartPointer<ContactStabilityController>*>(&sim.robotControllers[0]);
 
-    ControllerState output = controller->GetControllerState();
+    const ControllerState &output = controller->GetControllerState();
+    const std::vector<Vector3> &predicted_com = output.GetPredictedCOM();
 
     glDisable(GL_LIGHTING);
     glEnable(GL_BLEND); 
 
     GLColor color(1,0,0);
-    for(int i = 0; i < int(output.predicted_com.size())-1; i++){
-      Vector3 com_cur = output.predicted_com.at(i);
-      Vector3 com_next = output.predicted_com.at(i+1);
+    for(int i = 0; i < int(predicted_com.size())-1; i++){
+      Vector3 com_cur = predicted_com.at(i);
+      Vector3 com_next = predicted_com.at(i+1);
 
       Vector3 dc = com_next - com_cur;
         
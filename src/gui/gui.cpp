@@ -20,7 +20,7 @@ const double sweptvolumeScale = 0.98;
 const double sweptVolume_q_spacing = 0.01;
 
 ForceFieldBackend::ForceFieldBackend(RobotWorld *world)
-    : SimTestBackend(world)
+    : SimTestBackend(world), wrenchsimulation(&sim, &wrenchfield)
 {
   std::string guidef = util::GetDataFolder()+"/../settings/gui.xml";
   state.Load(guidef.c_str());
@@ -30,6 +30,7 @@ ForceFieldBackend::ForceFieldBackend(RobotWorld *world)
     MapButtonToggle(v->name.c_str(), &v->active);
   }
   active_robot = 0;
+  wrenchsimulation.SetStepFunction([this](double dt){ SimStep(dt); });
 }
 
 //############################################################################
@@ -41,33 +42,14 @@ bool ForceFieldBackend::OnIdle()
     drawTime = 1;
     sim.odesim.SetGravity(Vector3(0,0,0));
     ODERobot *simrobot = sim.odesim.robot(active_robot);
-    uint Nlinks = simrobot->robot.links.size();
-
-    sim.hooks.clear();
-
-    for(uint i = 0; i < Nlinks; i++){
-      dBodyID bodyid = simrobot->body(i);
-
-      if(bodyid){
-        if(!simrobot->robot.IsGeometryEmpty(i)){
-          Vector3 com;
-          RobotLink3D *link = &simrobot->robot.links[i];
-          link->GetWorldCOM(com);
-          wrenchfield.setPosition(i, com);
-          Vector3 linmom = simrobot->robot.GetLinearMomentum(i);
-          Vector3 force = wrenchfield.getForce(com, linmom/link->mass);
-
-          //std::cout << "link " << i << " pos " << com << " force " << force << std::endl;
-          Vector3 torque(0,0,0);
-
-          wrenchfield.setForce(i, force);
-          wrenchfield.setTorque(i, torque);
-
-          sim.hooks.push_back(new WrenchHook(bodyid, force, torque));
-        }
-      }
-    }
 
+    //fixed-rate simulation: all steps within the elapsed (wall-clock) time,
+    //wrench hooks are updated in place before each step
+    double dt=settings["updateStep"];
+    wrenchsimulation.SetRobot(active_robot);
+    wrenchsimulation.SetTimeStep(dt);
+    uint Nsteps = wrenchsimulation.Advance(idle_timer.ElapsedTime());
+    idle_timer.Reset();
 
     Vector3 com = simrobot->robot.GetCOM();
     //Real mass = robot->robot.GetTotalMass();
@@ -80,17 +62,11 @@ bool ForceFieldBackend::OnIdle()
     wrenchfield.setCOMLinearMomentum(LM);
     wrenchfield.setCOMAngularMomentum(AM);
 
-    double dt=settings["updateStep"];
-    Timer timer;
-    SimStep(dt);
-    SendRefresh();
-
-    SensorPlotUpdate();
-
-    Real elapsedTime = timer.ElapsedTime();
-    Real remainingTime = Max(0.0,dt-elapsedTime);
-    //printf("Simulated time %g took time %g, pausing for time %g\n",dt,elapsedTime,remainingTime);
-    SendPauseIdle(remainingTime);
+    if(Nsteps > 0){
+      SendRefresh();
+      SensorPlotUpdate();
+    }
+    SendPauseIdle(wrenchsimulation.GetTimeToNextStep());
 
     return true;
   }
@@ -328,9 +304,11 @@ bool ForceFieldBackend::OnCommand(const string& cmd,const string& args){
   }else if(cmd=="simulate"){
     state("simulate").toggle();
     simulate = state("simulate").active;
+    idle_timer.Reset();
     state("draw_robot").activate();
 
   }else if(cmd=="reset"){
+    wrenchsimulation.Clear();
     sim.hooks.clear();
 
     for(uint k = 0; k < sim.robotControllers.size(); k++){
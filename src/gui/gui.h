@@ -1,6 +1,7 @@
 #pragma once
 #include "elements/swept_volume.h"
 #include "elements/wrench_field.h"
+#include "elements/wrench_field_simulation.h"
 #include "controller/controller.h"
 #include "gui/gui_state.h"
 
@@ -18,6 +19,7 @@
 #include <KrisLibrary/GLdraw/GLUTString.h>
 
 #include <View/ViewIK.h>
+#include <KrisLibrary/Timer.h>
 #include <ode/ode.h>
 
 #define DEBUG 0
@@ -34,6 +36,7 @@ class ForceFieldBackend : public SimTestBackend
   public:
 
     WrenchField wrenchfield;
+    WrenchFieldSimulation wrenchsimulation;
 
     ForceFieldBackend(RobotWorld *world);
     virtual void Start();
@@ -59,6 +62,10 @@ class ForceFieldBackend : public SimTestBackend
 
     uint active_robot;
     GUIState state;
+
+  private:
+    //wall-clock time since the last simulation update
+    Timer idle_timer;
 };
 
 
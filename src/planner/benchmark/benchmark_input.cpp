@@ -1,5 +1,7 @@
 #include "benchmark_input.h"
 #include "util.h"
+#include <algorithm>
+#include <thread>
 
 BenchmarkInput::BenchmarkInput(std::string name_):
   name(name_)
@@ -31,6 +33,8 @@ bool BenchmarkInput::Load(TiXmlElement *node)
       maxPlanningTime = GetSubNodeTextDefault(bnode, "maxplanningtime", 5.0);
       runCount = GetSubNodeTextDefault(bnode, "runcount", 10);
       maxMemory = GetSubNodeTextDefault(bnode, "maxmemory", 10000);
+      threads = GetSubNodeTextDefault(bnode, "threads", 1);
+      if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
 
       TiXmlElement* node_algorithm = FindFirstSubNode(bnode, "algorithm");
       algorithms.clear();
@@ -12,6 +12,8 @@ class BenchmarkInput
     double maxPlanningTime;
     int maxMemory;
     int runCount;
+    //number of worker threads (1: serial, 0: one per hardware thread)
+    uint threads;
     std::vector<std::string> algorithms;
     std::string name;
 };
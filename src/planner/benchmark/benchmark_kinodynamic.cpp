@@ -0,0 +1,186 @@
+#include "benchmark_kinodynamic.h"
+#include "planner/cspace/integrator/propagation_cache.h"
+#include <ompl/control/PathControl.h>
+#include <ompl/util/Time.h>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+
+namespace{
+  template<typename F>
+  void TimedSample(const F &sample)
+  {
+    KinodynamicRunStatistics &statistics = KinodynamicRunStatistics::Get();
+    ompl::time::point start = ompl::time::now();
+    sample();
+    statistics.controlSamplingTime += ompl::time::seconds(ompl::time::now() - start);
+    statistics.controlSamples++;
+  }
+}
+
+KinodynamicRunStatistics& KinodynamicRunStatistics::Get()
+{
+  thread_local KinodynamicRunStatistics statistics;
+  return statistics;
+}
+
+void KinodynamicRunStatistics::Clear()
+{
+  *this = KinodynamicRunStatistics();
+}
+
+//#############################################################################
+CountingStatePropagator::CountingStatePropagator(oc::SpaceInformation *si, const oc::StatePropagatorPtr &propagator_):
+  oc::StatePropagator(si), propagator(propagator_)
+{
+}
+
+void CountingStatePropagator::propagate(const ob::State *state, const oc::Control* control,
+    const double duration, ob::State *result) const
+{
+  KinodynamicRunStatistics &statistics = KinodynamicRunStatistics::Get();
+  ompl::time::point start = ompl::time::now();
+  propagator->propagate(state, control, duration, result);
+  statistics.propagationTime += ompl::time::seconds(ompl::time::now() - start);
+  statistics.propagations++;
+}
+
+bool CountingStatePropagator::steer(const ob::State *from, const ob::State *to, oc::Control *result, double &duration) const
+{
+  return propagator->steer(from, to, result, duration);
+}
+
+bool CountingStatePropagator::canSteer() const
+{
+  return propagator->canSteer();
+}
+
+const oc::StatePropagatorPtr& CountingStatePropagator::GetPropagator() const
+{
+  return propagator;
+}
+
+//#############################################################################
+CountingStateValidityChecker::CountingStateValidityChecker(ob::SpaceInformation *si, const ob::StateValidityCheckerPtr &checker_):
+  ob::StateValidityChecker(si), checker(checker_)
+{
+  specs_ = checker->getSpecs();
+}
+
+bool CountingStateValidityChecker::isValid(const ob::State *state) const
+{
+  KinodynamicRunStatistics::Get().validityChecks++;
+  return checker->isValid(state);
+}
+
+bool CountingStateValidityChecker::isValid(const ob::State *state, double &dist) const
+{
+  KinodynamicRunStatistics::Get().validityChecks++;
+  return checker->isValid(state, dist);
+}
+
+double CountingStateValidityChecker::clearance(const ob::State *state) const
+{
+  return checker->clearance(state);
+}
+
+const ob::StateValidityCheckerPtr& CountingStateValidityChecker::GetChecker() const
+{
+  return checker;
+}
+
+//#############################################################################
+TimedControlSampler::TimedControlSampler(const oc::ControlSpace *space):
+  oc::ControlSampler(space), sampler(space->allocDefaultControlSampler())
+{
+}
+
+void TimedControlSampler::sample(oc::Control *control)
+{
+  TimedSample([&]{ sampler->sample(control); });
+}
+
+void TimedControlSampler::sample(oc::Control *control, const ob::State *state)
+{
+  TimedSample([&]{ sampler->sample(control, state); });
+}
+
+void TimedControlSampler::sampleNext(oc::Control *control, const oc::Control *previous)
+{
+  TimedSample([&]{ sampler->sampleNext(control, previous); });
+}
+
+void TimedControlSampler::sampleNext(oc::Control *control, const oc::Control *previous, const ob::State *state)
+{
+  TimedSample([&]{ sampler->sampleNext(control, previous, state); });
+}
+
+unsigned int TimedControlSampler::sampleStepCount(unsigned int minSteps, unsigned int maxSteps)
+{
+  return sampler->sampleStepCount(minSteps, maxSteps);
+}
+
+//#############################################################################
+void InstallKinodynamicRunStatistics(const oc::SpaceInformationPtr &si)
+{
+  si->setStatePropagator(std::make_shared<CountingStatePropagator>(si.get(), si->getStatePropagator()));
+  si->setStateValidityChecker(std::make_shared<CountingStateValidityChecker>(si.get(), si->getStateValidityChecker()));
+  si->getControlSpace()->setControlSamplerAllocator(
+      [](const oc::ControlSpace *space){ return std::make_shared<TimedControlSampler>(space); });
+}
+
+void UninstallKinodynamicRunStatistics(const oc::SpaceInformationPtr &si)
+{
+  si->getControlSpace()->clearControlSamplerAllocator();
+}
+
+namespace{
+  PropagationCache* GetPropagationCache(const ob::PlannerPtr &planner)
+  {
+    const oc::SpaceInformation *si = dynamic_cast<const oc::SpaceInformation*>(planner->getSpaceInformation().get());
+    if(si == nullptr) return nullptr;
+    oc::StatePropagatorPtr propagator = si->getStatePropagator();
+    const CountingStatePropagator *counter = dynamic_cast<const CountingStatePropagator*>(propagator.get());
+    if(counter != nullptr) propagator = counter->GetPropagator();
+    return dynamic_cast<PropagationCache*>(propagator.get());
+  }
+}
+
+void ClearKinodynamicRunStatistics(const ob::PlannerPtr &planner)
+{
+  KinodynamicRunStatistics::Get().Clear();
+  //runs should not profit from propagations of previous runs
+  PropagationCache *cache = GetPropagationCache(planner);
+  if(cache != nullptr) cache->Clear();
+}
+
+void AddKinodynamicRunProperties(const ob::PlannerPtr &planner, ot::Benchmark::RunProperties &run)
+{
+  const KinodynamicRunStatistics &statistics = KinodynamicRunStatistics::Get();
+  run["propagations INTEGER"] = std::to_string(statistics.propagations);
+  run["propagation time REAL"] = boost::lexical_cast<std::string>(statistics.propagationTime);
+  run["validity checks INTEGER"] = std::to_string(statistics.validityChecks);
+  run["control samples INTEGER"] = std::to_string(statistics.controlSamples);
+  run["control sampling time REAL"] = boost::lexical_cast<std::string>(statistics.controlSamplingTime);
+
+  PropagationCache *cache = GetPropagationCache(planner);
+  if(cache != nullptr){
+    run["propagation cache hits INTEGER"] = std::to_string(cache->GetNumberOfHits());
+    run["propagation cache time saved REAL"] = boost::lexical_cast<std::string>(cache->GetTimeSaved());
+  }
+
+  ob::ProblemDefinitionPtr pdef = planner->getProblemDefinition();
+  if(!pdef->hasSolution()) return;
+
+  ob::PathPtr solution = pdef->getSolutionPath();
+  const oc::PathControl *path = dynamic_cast<const oc::PathControl*>(solution.get());
+  if(path == nullptr || path->getControlCount() == 0) return;
+
+  const std::vector<double> &durations = path->getControlDurations();
+  double total = 0;
+  for(uint k = 0; k < durations.size(); k++) total += durations.at(k);
+  run["solution duration REAL"] = boost::lexical_cast<std::string>(total);
+  run["solution controls INTEGER"] = std::to_string(durations.size());
+  run["solution control duration min REAL"] = boost::lexical_cast<std::string>(*std::min_element(durations.begin(), durations.end()));
+  run["solution control duration max REAL"] = boost::lexical_cast<std::string>(*std::max_element(durations.begin(), durations.end()));
+  run["solution control duration mean REAL"] = boost::lexical_cast<std::string>(total/durations.size());
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <ompl/tools/benchmark/Benchmark.h>
+#include <ompl/control/SpaceInformation.h>
+#include <ompl/control/StatePropagator.h>
+#include <ompl/control/ControlSampler.h>
+
+namespace ob = ompl::base;
+namespace oc = ompl::control;
+namespace ot = ompl::tools;
+
+//Counters of a single benchmark run of a control planner. A run executes on a
+//single thread (also in BenchmarkParallel), so the counters are
+//thread-private and are cleared before each run.
+struct KinodynamicRunStatistics
+{
+  unsigned long propagations{0};
+  unsigned long validityChecks{0};
+  unsigned long controlSamples{0};
+  double propagationTime{0};
+  double controlSamplingTime{0};
+
+  static KinodynamicRunStatistics& Get();
+  void Clear();
+};
+
+//Wrappers which count (and time) calls into KinodynamicRunStatistics
+class CountingStatePropagator: public oc::StatePropagator
+{
+  public:
+    CountingStatePropagator(oc::SpaceInformation *si, const oc::StatePropagatorPtr &propagator);
+
+    void propagate(const ob::State *state, const oc::Control* control,
+        const double duration, ob::State *result) const override;
+    bool steer(const ob::State *from, const ob::State *to, oc::Control *result, double &duration) const override;
+    bool canSteer() const override;
+
+    const oc::StatePropagatorPtr& GetPropagator() const;
+
+  private:
+    oc::StatePropagatorPtr propagator;
+};
+
+class CountingStateValidityChecker: public ob::StateValidityChecker
+{
+  public:
+    CountingStateValidityChecker(ob::SpaceInformation *si, const ob::StateValidityCheckerPtr &checker);
+
+    bool isValid(const ob::State *state) const override;
+    bool isValid(const ob::State *state, double &dist) const override;
+    double clearance(const ob::State *state) const override;
+
+    const ob::StateValidityCheckerPtr& GetChecker() const;
+
+  private:
+    ob::StateValidityCheckerPtr checker;
+};
+
+class TimedControlSampler: public oc::ControlSampler
+{
+  public:
+    TimedControlSampler(const oc::ControlSpace *space);
+
+    void sample(oc::Control *control) override;
+    void sample(oc::Control *control, const ob::State *state) override;
+    void sampleNext(oc::Control *control, const oc::Control *previous) override;
+    void sampleNext(oc::Control *control, const oc::Control *previous, const ob::State *state) override;
+    unsigned int sampleStepCount(unsigned int minSteps, unsigned int maxSteps) override;
+
+  private:
+    oc::ControlSamplerPtr sampler;
+};
+
+//wraps propagator and validity checker of si, and the control sampler of its
+//control space (which is shared with other space informations, see
+//UninstallKinodynamicRunStatistics)
+void InstallKinodynamicRunStatistics(const oc::SpaceInformationPtr &si);
+void UninstallKinodynamicRunStatistics(const oc::SpaceInformationPtr &si);
+
+//clears counters (and the propagation cache, if any) before a run
+void ClearKinodynamicRunStatistics(const ob::PlannerPtr &planner);
+
+//adds counters of the current run and statistics of the control durations of
+//the solution path (if any) to the run properties
+void AddKinodynamicRunProperties(const ob::PlannerPtr &planner, ot::Benchmark::RunProperties &run);
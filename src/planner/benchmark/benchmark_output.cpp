@@ -107,7 +107,9 @@ bool BenchmarkOutput::Save(TiXmlElement *node)
   for(uint k = 0; k < experiment.planners.size(); k++){
     TiXmlElement pknode("planner");
     ot::Benchmark::PlannerExperiment planner_experiment = experiment.planners.at(k);
-    std::string name = util::RemoveStringBeginning(planner_experiment.name, "geometric");
+    std::string name = planner_experiment.name;
+    if(util::StartsWith(name, "control")) name = util::RemoveStringBeginning(name, "control");
+    else name = util::RemoveStringBeginning(name, "geometric");
     AddSubNode(pknode, "name", name);
 
     std::vector<ot::Benchmark::RunProperties> runs = planner_experiment.runs;
@@ -0,0 +1,170 @@
+#include "benchmark_parallel.h"
+#include "benchmark_kinodynamic.h"
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include <ompl/util/Console.h>
+#include <ompl/util/Time.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+BenchmarkParallel::BenchmarkParallel(og::SimpleSetup &setup, const std::string &name,
+    BenchmarkWorkerAllocator allocator_, uint Nthreads_):
+  ot::Benchmark(setup, name), allocator(allocator_), Nthreads(Nthreads_)
+{
+  if(Nthreads < 1) Nthreads = 1;
+}
+
+BenchmarkParallel::BenchmarkParallel(oc::SimpleSetup &setup, const std::string &name,
+    BenchmarkWorkerAllocator allocator_, uint Nthreads_):
+  ot::Benchmark(setup, name), allocator(allocator_), Nthreads(Nthreads_)
+{
+  if(Nthreads < 1) Nthreads = 1;
+}
+
+uint BenchmarkParallel::GetNumberOfThreads() const
+{
+  return Nthreads;
+}
+
+bool BenchmarkParallel::IsThreadSafe(const ob::StateValidityChecker *checker)
+{
+  //kinodynamic benchmarks wrap the checker of the cspace
+  const CountingStateValidityChecker *counting = dynamic_cast<const CountingStateValidityChecker*>(checker);
+  if(counting != nullptr) return IsThreadSafe(counting->GetChecker().get());
+  return dynamic_cast<const OMPLValidityChecker*>(checker) != nullptr;
+}
+
+void BenchmarkParallel::benchmark(const Request &req)
+{
+  const ob::SpaceInformationPtr &si = (gsetup_ != nullptr ?
+      gsetup_->getSpaceInformation() : csetup_->getSpaceInformation());
+  if(Nthreads > 1 && !IsThreadSafe(si->getStateValidityChecker().get())){
+    OMPL_INFORM("Validity checker is not thread-safe, running benchmark serially.");
+    Nthreads = 1;
+  }
+  if(Nthreads <= 1){
+    ot::Benchmark::benchmark(req);
+    return;
+  }
+
+  uint Nplanners = planners_.size();
+  uint Njobs = Nplanners * req.runCount;
+  if(Njobs < 1) return;
+
+  //workers are allocated serially, because planner and space setup modify
+  //the (shared) state spaces
+  uint Nworkers = std::min(Nthreads, Njobs);
+  std::vector<BenchmarkWorker> workers;
+  for(uint k = 0; k < Nworkers; k++){
+    BenchmarkWorker worker = allocator();
+    if((gsetup_ != nullptr && !worker.setup) || (csetup_ != nullptr && !worker.csetup)){
+      OMPL_ERROR("Worker %d has no setup of the type of the benchmark.", (int)k);
+      throw "Invalid benchmark worker.";
+    }
+    if(worker.planners.size() != Nplanners){
+      OMPL_ERROR("Worker %d has %d planners, but benchmark has %d.", (int)k, (int)worker.planners.size(), (int)Nplanners);
+      throw "Invalid benchmark worker.";
+    }
+    workers.push_back(worker);
+  }
+
+  //each job is a single run of a single planner. Console output and progress
+  //display of ot::Benchmark are global, so they are disabled for the jobs.
+  Request reqJob(req);
+  reqJob.runCount = 1;
+  reqJob.displayProgress = false;
+  reqJob.saveConsoleOutput = false;
+
+  std::vector<CompleteExperiment> results(Njobs);
+  std::atomic<uint> nextJob{0};
+
+  auto work = [&](uint w)
+  {
+    BenchmarkWorker &worker = workers.at(w);
+    while(true){
+      uint j = nextJob++;
+      if(j >= Njobs) break;
+      uint p = j / req.runCount;
+
+      std::unique_ptr<ot::Benchmark> job;
+      if(gsetup_ != nullptr) job.reset(new ot::Benchmark(*worker.setup, exp_.name));
+      else job.reset(new ot::Benchmark(*worker.csetup, exp_.name));
+      job->addPlanner(worker.planners.at(p));
+      job->setPlannerSwitchEvent(plannerSwitch_);
+      job->setPreRunEvent(preRun_);
+      job->setPostRunEvent(postRun_);
+      try{
+        job->benchmark(reqJob);
+        results.at(j) = job->getRecordedExperimentData();
+      }catch(const std::exception &e){
+        OMPL_ERROR("Run %d of planner %s failed: %s", (int)(j % req.runCount),
+            worker.planners.at(p)->getName().c_str(), e.what());
+      }catch(const char *e){
+        OMPL_ERROR("Run %d of planner %s failed: %s", (int)(j % req.runCount),
+            worker.planners.at(p)->getName().c_str(), e);
+      }catch(...){
+        OMPL_ERROR("Run %d of planner %s failed.", (int)(j % req.runCount),
+            worker.planners.at(p)->getName().c_str());
+      }
+    }
+  };
+
+  status_.running = true;
+  status_.activeRun = 0;
+  status_.progressPercentage = 0;
+
+  ompl::time::point start = ompl::time::now();
+
+  std::vector<std::thread> threads;
+  for(uint k = 0; k < Nworkers; k++){
+    threads.push_back(std::thread(work, k));
+  }
+  for(uint k = 0; k < threads.size(); k++){
+    threads.at(k).join();
+  }
+
+  //############################################################################
+  //merge runs (ordered by planner, then by run)
+  //############################################################################
+  exp_.planners.clear();
+  exp_.maxTime = req.maxTime;
+  exp_.maxMem = req.maxMem;
+  exp_.runCount = req.runCount;
+  exp_.startTime = start;
+  exp_.totalDuration = ompl::time::seconds(ompl::time::now() - start);
+
+  bool headerSet = false;
+  for(uint p = 0; p < Nplanners; p++){
+    PlannerExperiment experiment;
+    experiment.name = planners_.at(p)->getName();
+    for(uint r = 0; r < req.runCount; r++){
+      const CompleteExperiment &result = results.at(p*req.runCount + r);
+      if(result.planners.empty()) continue;
+      if(!headerSet){
+        exp_.setupInfo = result.setupInfo;
+        exp_.seed = result.seed;
+        exp_.host = result.host;
+        exp_.cpuInfo = result.cpuInfo;
+        headerSet = true;
+      }
+      const PlannerExperiment &run = result.planners.front();
+      if(experiment.runs.empty()){
+        experiment.name = run.name;
+        experiment.common = run.common;
+        experiment.progressPropertyNames = run.progressPropertyNames;
+      }
+      for(uint k = 0; k < run.runs.size(); k++){
+        experiment.runs.push_back(run.runs.at(k));
+        //process-wide memory of concurrent runs
+        experiment.runs.back().erase("memory REAL");
+      }
+      experiment.runsProgressData.insert(experiment.runsProgressData.end(),
+          run.runsProgressData.begin(), run.runsProgressData.end());
+    }
+    exp_.planners.push_back(experiment);
+  }
+
+  status_.running = false;
+  status_.progressPercentage = 100.0;
+}
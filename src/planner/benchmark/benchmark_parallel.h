@@ -0,0 +1,55 @@
+#pragma once
+#include <ompl/tools/benchmark/Benchmark.h>
+#include <ompl/geometric/SimpleSetup.h>
+#include <ompl/control/SimpleSetup.h>
+#include <functional>
+
+namespace ob = ompl::base;
+namespace og = ompl::geometric;
+namespace oc = ompl::control;
+namespace ot = ompl::tools;
+
+//Setup and planner instances owned by one worker thread. The planners have to
+//be defined on the space information of the setup, and have to be in the same
+//order as the planners added to the BenchmarkParallel. Either setup
+//(geometric) or csetup (control) is set, matching the benchmark.
+struct BenchmarkWorker
+{
+  og::SimpleSetupPtr setup;
+  oc::SimpleSetupPtr csetup;
+  std::vector<ob::PlannerPtr> planners;
+};
+typedef std::function<BenchmarkWorker()> BenchmarkWorkerAllocator;
+
+//BenchmarkParallel: executes the (planner, run) pairs of a benchmark on a pool
+//of threads. Each thread owns a worker created by the allocator, and pops the
+//next pair from a shared counter. The runs are merged into a single
+//CompleteExperiment (in the same order as ot::Benchmark would have produced),
+//such that saving and evaluating results does not change.
+//
+//Runs serially if the validity checker of the benchmark is not thread-safe
+//(see IsThreadSafe).
+//
+//NOTE: memory is measured for the whole process, so it is meaningless for
+//concurrent runs and "memory REAL" is removed from the merged runs. maxMem
+//applies to all runs executing in parallel.
+class BenchmarkParallel: public ot::Benchmark
+{
+  public:
+    BenchmarkParallel(og::SimpleSetup &setup, const std::string &name,
+        BenchmarkWorkerAllocator allocator, uint Nthreads);
+    BenchmarkParallel(oc::SimpleSetup &setup, const std::string &name,
+        BenchmarkWorkerAllocator allocator, uint Nthreads);
+
+    virtual void benchmark(const Request &req) override;
+
+    uint GetNumberOfThreads() const;
+
+    //only OMPLValidityCheckers are thread-safe (per-thread collision
+    //contexts), also if wrapped by a CountingStateValidityChecker
+    static bool IsThreadSafe(const ob::StateValidityChecker *checker);
+
+  private:
+    BenchmarkWorkerAllocator allocator;
+    uint Nthreads{1};
+};
@@ -3,9 +3,12 @@
 #include "planner/cspace/cspace.h"
 #include "planner/cspace/validitychecker/validity_checker_ompl.h"
 #include "planner/cspace/validitychecker/validity_checker_ompl_relaxation.h"
+#include "planner/cspace/validitychecker/motion_validator_ompl.h"
 #include <ompl/base/spaces/SO2StateSpace.h>
 #include <ompl/control/spaces/RealVectorControlSpace.h>
 #include <ompl/base/spaces/SE3StateSpace.h>
+#include <algorithm>
+#include <cstring>
 
 CSpaceOMPL::CSpaceOMPL(RobotWorld *world_, int robot_idx_):
   si(nullptr), world(world_), robot_idx(robot_idx_)
@@ -93,6 +96,51 @@ Config CSpaceOMPL::OMPLStateToVelocity(const ob::State *)
   return dq;
 }
 
+void CSpaceOMPL::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
+void CSpaceOMPL::ComputeCopyPlan()
+{
+  copy_plan.clear();
+  //some subclasses do not use the index maps (Nompl is then unrelated)
+  uint N = std::min((uint)ompl_to_klampt.size(), Nompl);
+  for(uint i = 0; i < N; i++){
+    uint idx = ompl_to_klampt.at(i);
+    if(!copy_plan.empty()){
+      IndexRun &run = copy_plan.back();
+      if(run.ompl + run.length == i && run.klampt + run.length == idx){
+        run.length++;
+        continue;
+      }
+    }
+    IndexRun run;
+    run.ompl = i;
+    run.klampt = idx;
+    run.length = 1;
+    copy_plan.push_back(run);
+  }
+}
+
+void CSpaceOMPL::CopyOMPLToKlampt(const double *qomplRn, Config &q) const
+{
+  double *qv = q.getPointer();
+  for(uint k = 0; k < copy_plan.size(); k++){
+    const IndexRun &run = copy_plan.at(k);
+    std::memcpy(qv + run.klampt, qomplRn + run.ompl, run.length*sizeof(double));
+  }
+}
+
+void CSpaceOMPL::CopyKlamptToOMPL(const Config &q, double *qomplRn) const
+{
+  const double *qv = q.getPointer();
+  for(uint k = 0; k < copy_plan.size(); k++){
+    const IndexRun &run = copy_plan.at(k);
+    std::memcpy(qomplRn + run.ompl, qv + run.klampt, run.length*sizeof(double));
+  }
+}
+
 Config CSpaceOMPL::OMPLStateToConfig(const ob::ScopedState<> &qompl){
   const ob::State* s = qompl.get();
   return OMPLStateToConfig(s);
@@ -106,6 +154,7 @@ ob::ScopedState<> CSpaceOMPL::ConfigToOMPLState(const Config &q){
 
 void CSpaceOMPL::Init()
 {
+  ComputeCopyPlan();
   this->initSpace();
 }
 
@@ -125,10 +174,27 @@ ob::SpaceInformationPtr CSpaceOMPL::SpaceInformationPtr()
     si = std::make_shared<ob::SpaceInformation>(SpacePtr());
     validity_checker = StateValidityCheckerPtr(si);
     si->setStateValidityChecker(validity_checker);
+    si->setMotionValidator(MotionValidatorPtr(si));
   }
   return si;
 }
 
+ob::SpaceInformationPtr CSpaceOMPL::CreateSpaceInformation()
+{
+  ob::SpaceInformationPtr si_copy = std::make_shared<ob::SpaceInformation>(SpacePtr());
+  //StateValidityCheckerPtr(si) overwrites the checker of the default si
+  ob::StateValidityCheckerPtr checker = validity_checker;
+  si_copy->setStateValidityChecker(StateValidityCheckerPtr(si_copy));
+  validity_checker = checker;
+  si_copy->setMotionValidator(MotionValidatorPtr(si_copy));
+  return si_copy;
+}
+
+const ob::MotionValidatorPtr CSpaceOMPL::MotionValidatorPtr(ob::SpaceInformationPtr si)
+{
+  return std::make_shared<OMPLMotionValidator>(si);
+}
+
 const ob::StateSpacePtr CSpaceOMPL::SpacePtr()
 {
   return space;
@@ -198,21 +264,33 @@ const ob::StateValidityCheckerPtr CSpaceOMPL::StateValidityCheckerPtr()
 void CSpaceOMPL::setStateValidityCheckerConstraintRelaxation(ob::State *xCenter, double r)
 {
   si = SpaceInformationPtr();
-  validity_checker = std::make_shared<OMPLValidityCheckerRelaxation>(si, this, xCenter, r);
+  OMPLValidityCheckerPtr checker = std::make_shared<OMPLValidityCheckerRelaxation>(si, this, xCenter, r);
+  SetClearanceCache(checker.get());
+  validity_checker = checker;
   si->setStateValidityChecker(validity_checker);
 }
 
 const ob::StateValidityCheckerPtr CSpaceOMPL::StateValidityCheckerPtr(ob::SpaceInformationPtr si)
 {
+  OMPLValidityCheckerPtr checker;
   if(enableSufficiency)
   {
-    validity_checker = std::make_shared<OMPLValidityCheckerNecessarySufficient>(si, this, klampt_cspace_outer);
+    checker = std::make_shared<OMPLValidityCheckerNecessarySufficient>(si, this, klampt_cspace_outer);
   }else{
-    validity_checker = std::make_shared<OMPLValidityChecker>(si, this);
+    checker = std::make_shared<OMPLValidityChecker>(si, this);
   }
+  SetClearanceCache(checker.get());
+  validity_checker = checker;
   return validity_checker;
 }
 
+void CSpaceOMPL::SetClearanceCache(OMPLValidityChecker *checker)
+{
+  if(input.clearance_cache_size == 0) return;
+  checker->SetNeighborhood(input.neighborhood_constant);
+  checker->SetClearanceCache(input.clearance_cache_size, input.clearance_cache_resolution, input.clearance_cache_error);
+}
+
 void CSpaceOMPL::SetSufficient(const uint robot_idx_outer_)
 {
   robot_idx_outer = robot_idx_outer_;
@@ -282,16 +360,21 @@ void CSpaceOMPL::drawConfig(const Config &q, const Config &dq, GLColor color)
 
 #include <unsupported/Eigen/Splines>
 #include <Eigen/Geometry> 
-std::vector<double> CSpaceOMPL::EulerZYXFromOMPLSO3StateSpace( const ob::SO3StateSpace::StateType *q )
+void CSpaceOMPL::EulerZYXFromOMPLSO3StateSpace( const ob::SO3StateSpace::StateType *q, double &rz, double &ry, double &rx )
 {
   Eigen::Quaterniond qEigen(q->w, q->x, q->y, q->z);
 
   Eigen::Vector3d euler = qEigen.toRotationMatrix().eulerAngles(0, 1, 2);
 
-  std::vector<double> out;
-  out.push_back(euler[2]);
-  out.push_back(euler[1]);
-  out.push_back(euler[0]);
+  rz = euler[2];
+  ry = euler[1];
+  rx = euler[0];
+}
+
+std::vector<double> CSpaceOMPL::EulerZYXFromOMPLSO3StateSpace( const ob::SO3StateSpace::StateType *q )
+{
+  std::vector<double> out(3);
+  EulerZYXFromOMPLSO3StateSpace(q, out.at(0), out.at(1), out.at(2));
   return out;
 
   //############################################################################
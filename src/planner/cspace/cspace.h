@@ -23,6 +23,8 @@ namespace ompl{
   }
 }
 
+class OMPLValidityChecker;
+
 class CSpaceOMPL
 {
   friend class CSpaceOMPLMultiAgent;
@@ -32,6 +34,9 @@ class CSpaceOMPL
 
     void Init();
     virtual ob::SpaceInformationPtr SpaceInformationPtr();
+    //new space information with its own validity checker (on the same state
+    //space), for planners which run in parallel to the default one
+    virtual ob::SpaceInformationPtr CreateSpaceInformation();
 
     //############################################################################
     //Mapping Functions OMPL <--> KLAMPT
@@ -42,6 +47,11 @@ class CSpaceOMPL
     virtual Config OMPLStateToConfig(const ob::State *qompl) = 0;
     virtual Config OMPLStateToVelocity(const ob::State *qompl);
 
+    //In-place version. Does not allocate if q has already the right size.
+    //Note: a subclass which overrides OMPLStateToConfig(qompl) needs to
+    //override this version, too (or the one of its parent is used).
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q);
+
     Config OMPLStateToConfig(const ob::ScopedState<> &qompl);
     ob::ScopedState<> ConfigToOMPLState(const Config &q);
     //############################################################################
@@ -76,6 +86,7 @@ class CSpaceOMPL
 
     //Yaw, Pitch, Roll
     std::vector<double> EulerZYXFromOMPLSO3StateSpace( const ob::SO3StateSpace::StateType *q );
+    void EulerZYXFromOMPLSO3StateSpace( const ob::SO3StateSpace::StateType *q, double &rz, double &ry, double &rx );
     void OMPLSO3StateSpaceFromEulerZYX( double rz, double ry, double rx, ob::SO3StateSpace::StateType *q );
 
     virtual bool isDynamic() const = 0;
@@ -93,6 +104,10 @@ class CSpaceOMPL
     virtual Config ControlToConfig(const double*);
   protected:
     virtual const ob::StateValidityCheckerPtr StateValidityCheckerPtr(ob::SpaceInformationPtr si);
+    //motion validator of space information created by this cspace
+    virtual const ob::MotionValidatorPtr MotionValidatorPtr(ob::SpaceInformationPtr si);
+    //enable the clearance cache of checker if set in the cspace input
+    void SetClearanceCache(OMPLValidityChecker *checker);
     virtual void initSpace() = 0;
 
     CSpaceInput input;
@@ -114,6 +129,18 @@ class CSpaceOMPL
     std::vector<int> ompl_to_klampt;
     std::vector<int> klampt_to_ompl;
 
+    //Copy plan: ompl_to_klampt as contiguous runs of indices, such that the
+    //R^Nompl part of a state can be copied with memcpy (computed in Init)
+    struct IndexRun{
+      uint ompl;
+      uint klampt;
+      uint length;
+    };
+    std::vector<IndexRun> copy_plan;
+    void ComputeCopyPlan();
+    void CopyOMPLToKlampt(const double *qomplRn, Config &q) const;
+    void CopyKlamptToOMPL(const Config &q, double *qomplRn) const;
+
     ob::StateValidityCheckerPtr validity_checker;
     ob::SpaceInformationPtr si{nullptr};
     ob::StateSpacePtr space{nullptr};
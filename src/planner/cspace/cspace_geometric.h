@@ -15,7 +15,9 @@ class GeometricCSpaceOMPL: public CSpaceOMPL
     virtual void initSpace() override;
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     Config OMPLStateToConfig(const ob::SE3StateSpace::StateType *qomplSE3, const ob::RealVectorStateSpace::StateType *qomplRnState);
+    void OMPLStateToConfig(const ob::SE3StateSpace::StateType *qomplSE3, const ob::RealVectorStateSpace::StateType *qomplRnState, Config &q);
 
     virtual void print(std::ostream& out = std::cout) const override;
     virtual bool isDynamic() const override;
@@ -193,6 +193,11 @@ double GeometricCSpaceOMPLAnnulus::OMPLStateToRValue(const ob::State *qompl)
     return qomplRnSpace->values[0];
 }
 
+void GeometricCSpaceOMPLAnnulus::OMPLStateToConfig(const ob::State *x, Config &q)
+{
+  q = OMPLStateToConfig(x);
+}
+
 Config GeometricCSpaceOMPLAnnulus::OMPLStateToConfig(const ob::State *x)
 {
     double u = OMPLStateToSO2Value(x);
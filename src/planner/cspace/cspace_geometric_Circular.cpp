@@ -95,6 +95,11 @@ Config GeometricCSpaceOMPLCircular::ProjectToConfig(double u)
     return q;
 }
 
+void GeometricCSpaceOMPLCircular::OMPLStateToConfig(const ob::State *x, Config &q)
+{
+  q = OMPLStateToConfig(x);
+}
+
 Config GeometricCSpaceOMPLCircular::OMPLStateToConfig(const ob::State *x)
 {
     double u = OMPLStateToSO2Value(x);
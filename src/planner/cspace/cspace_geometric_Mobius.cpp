@@ -132,6 +132,11 @@ double GeometricCSpaceOMPLMobius::OMPLStateToRValue(const ob::State *qompl)
     return qomplRnSpace->values[0];
 }
 
+void GeometricCSpaceOMPLMobius::OMPLStateToConfig(const ob::State *x, Config &q)
+{
+  q = OMPLStateToConfig(x);
+}
+
 Config GeometricCSpaceOMPLMobius::OMPLStateToConfig(const ob::State *x)
 {
     double u = OMPLStateToSO2Value(x);
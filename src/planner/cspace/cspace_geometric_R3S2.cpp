@@ -47,6 +47,11 @@ void GeometricCSpaceOMPLR3S2::ConfigToOMPLState(const Config &q, ob::State *qomp
   }
 }
 
+void GeometricCSpaceOMPLR3S2::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLR3S2::OMPLStateToConfig(const ob::State *qompl){
   const ob::RealVectorStateSpace::StateType *qomplR3Space = qompl->as<ob::CompoundState>()->as<ob::RealVectorStateSpace::StateType>(0);
   const ob::SO2StateSpace::StateType *qomplSO2SpaceA = qompl->as<ob::CompoundState>()->as<ob::SO2StateSpace::StateType>(1);
@@ -7,6 +7,7 @@ class GeometricCSpaceOMPLR3S2: public GeometricCSpaceOMPL
     virtual void initSpace();
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl);
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     virtual Vector3 getXYZ(const ob::State*) override;
 };
 
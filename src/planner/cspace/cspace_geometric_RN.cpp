@@ -2,6 +2,7 @@
 
 #include "planner/cspace/validitychecker/validity_checker_ompl.h"
 #include <ompl/base/spaces/RealVectorStateSpace.h>
+#include <cstring>
 
 GeometricCSpaceOMPLRN::GeometricCSpaceOMPLRN(RobotWorld *world_, int robot_idx, int dimension):
   GeometricCSpaceOMPL(world_, robot_idx), N(dimension)
@@ -42,15 +43,17 @@ void GeometricCSpaceOMPLRN::ConfigToOMPLState(const Config &q, ob::State *qompl)
 }
 
 Config GeometricCSpaceOMPLRN::OMPLStateToConfig(const ob::State *qompl){
+  Config q;
+  GeometricCSpaceOMPLRN::OMPLStateToConfig(qompl, q);
+  return q;
+}
 
+void GeometricCSpaceOMPLRN::OMPLStateToConfig(const ob::State *qompl, Config &q){
   const ob::RealVectorStateSpace::StateType *qomplRN = qompl->as<ob::RealVectorStateSpace::StateType>();
 
-  Config q;q.resize(robot->q.size());q.setZero();
-  for(uint k = 0; k < N; k++){
-    q(k) = qomplRN->values[k];
-  }
-  return q;
-
+  if(q.size() != robot->q.size()) q.resize(robot->q.size());
+  q.setZero();
+  std::memcpy(q.getPointer(), qomplRN->values, N*sizeof(double));
 }
 void GeometricCSpaceOMPLRN::print(std::ostream& out) const
 {
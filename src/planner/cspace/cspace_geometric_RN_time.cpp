@@ -48,6 +48,11 @@ void GeometricCSpaceOMPLRNTime::ConfigToOMPLState(const Config &q, ob::State *qo
   qOMPLTime->position = q(N);
 }
 
+void GeometricCSpaceOMPLRNTime::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLRNTime::OMPLStateToConfig(const ob::State *qompl){
 
   const ob::RealVectorStateSpace::StateType *qOMPLRN = qompl->as<ob::CompoundState>()->as<ob::RealVectorStateSpace::StateType>(0);
@@ -82,6 +82,11 @@ void GeometricCSpaceOMPLRCONTACT::ConfigToOMPLState(const Config &q, ob::State *
     qompl->as<ob::ConstrainedStateSpace::StateType>()->copy(x);
 }
 
+void GeometricCSpaceOMPLRCONTACT::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLRCONTACT::OMPLStateToConfig(const ob::State *qompl)
 {
     auto &&x = *qompl->as<ob::ConstrainedStateSpace::StateType>();
@@ -20,6 +20,7 @@ public:
     virtual void initSpace() override;
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     Config EigenVectorToConfig(const Eigen::VectorXd &xd) const;
     virtual void print(std::ostream& out = std::cout) const override;
 
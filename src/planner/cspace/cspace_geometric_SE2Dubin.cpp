@@ -45,6 +45,11 @@ void GeometricCSpaceOMPLSE2Dubin::ConfigToOMPLState(const Config &q, ob::State *
   qomplDubin->setYaw(q(3));
 }
 
+void GeometricCSpaceOMPLSE2Dubin::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLSE2Dubin::OMPLStateToConfig(const ob::State *qompl){
   const ob::SE2StateSpace::StateType *qomplDubins = qompl->as<ob::SE2StateSpace::StateType>();
   Config q;q.resize(robot->q.size());q.setZero();
@@ -54,9 +59,7 @@ Config GeometricCSpaceOMPLSE2Dubin::OMPLStateToConfig(const ob::State *qompl){
 
   return q;
 }
-ob::SpaceInformationPtr GeometricCSpaceOMPLSE2Dubin::SpaceInformationPtr()
+const ob::MotionValidatorPtr GeometricCSpaceOMPLSE2Dubin::MotionValidatorPtr(ob::SpaceInformationPtr si)
 {
-    si = BaseT::SpaceInformationPtr();
-    si->setMotionValidator(std::make_shared<ob::DubinsMotionValidator>(si));
-    return si;
+    return std::make_shared<ob::DubinsMotionValidator>(si);
 }
@@ -9,9 +9,11 @@ class GeometricCSpaceOMPLSE2Dubin: public GeometricCSpaceOMPLSE2RN
     virtual void initSpace();
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     // virtual void print(std::ostream& out = std::cout) const;
     // virtual Vector3 getXYZ(const ob::State*) override;
-    virtual ob::SpaceInformationPtr SpaceInformationPtr() override;
+  protected:
+    virtual const ob::MotionValidatorPtr MotionValidatorPtr(ob::SpaceInformationPtr si) override;
   private:
     double turningRadius_;
 };
@@ -101,6 +101,12 @@ void GeometricCSpaceOMPLSE2RN::ConfigToOMPLState(const Config &q, ob::State *qom
 }
 
 Config GeometricCSpaceOMPLSE2RN::OMPLStateToConfig(const ob::State *qompl){
+  Config q;
+  GeometricCSpaceOMPLSE2RN::OMPLStateToConfig(qompl, q);
+  return q;
+}
+
+void GeometricCSpaceOMPLSE2RN::OMPLStateToConfig(const ob::State *qompl, Config &q){
   const ob::SE2StateSpace::StateType *qomplSE2{nullptr};
   const ob::RealVectorStateSpace::StateType *qomplRnSpace{nullptr};
 
@@ -112,17 +118,15 @@ Config GeometricCSpaceOMPLSE2RN::OMPLStateToConfig(const ob::State *qompl){
     qomplRnSpace = nullptr;
   }
 
-  Config q;q.resize(robot->q.size());q.setZero();
+  if(q.size() != robot->q.size()) q.resize(robot->q.size());
+  q.setZero();
   q(0)=qomplSE2->getX();
   q(1)=qomplSE2->getY();
   q(3)=qomplSE2->getYaw();
 
-  for(uint i = 0; i < Nompl; i++){
-    uint idx = ompl_to_klampt.at(i);
-    q(idx) = qomplRnSpace->values[i];
+  if(Nompl>0){
+    CopyOMPLToKlampt(qomplRnSpace->values, q);
   }
-
-  return q;
 }
 
 void GeometricCSpaceOMPLSE2RN::print(std::ostream& out) const
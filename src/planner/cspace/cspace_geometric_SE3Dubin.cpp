@@ -50,6 +50,11 @@ void GeometricCSpaceOMPLSE3Dubin::ConfigToOMPLState(const Config &q, ob::State *
   qomplDubin->setYaw(q(3));
 }
 
+void GeometricCSpaceOMPLSE3Dubin::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLSE3Dubin::OMPLStateToConfig(const ob::State *qompl)
 {
 
@@ -65,9 +70,7 @@ Config GeometricCSpaceOMPLSE3Dubin::OMPLStateToConfig(const ob::State *qompl)
 
   return q;
 }
-ob::SpaceInformationPtr GeometricCSpaceOMPLSE3Dubin::SpaceInformationPtr()
+const ob::MotionValidatorPtr GeometricCSpaceOMPLSE3Dubin::MotionValidatorPtr(ob::SpaceInformationPtr si)
 {
-    si = BaseT::SpaceInformationPtr();
-    si->setMotionValidator(std::make_shared<ob::DubinsAirplaneMotionValidator>(si));
-    return si;
+    return std::make_shared<ob::DubinsAirplaneMotionValidator>(si);
 }
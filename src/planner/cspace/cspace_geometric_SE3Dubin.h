@@ -10,7 +10,9 @@ class GeometricCSpaceOMPLSE3Dubin: public GeometricCSpaceOMPL
     virtual void initSpace() override;
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
-    virtual ob::SpaceInformationPtr SpaceInformationPtr() override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
+  protected:
+    virtual const ob::MotionValidatorPtr MotionValidatorPtr(ob::SpaceInformationPtr si) override;
   private:
     double turningRadius_;
     double climbingAngle_;
@@ -140,19 +140,20 @@ void GeometricCSpaceOMPLSE3RN::ConfigToOMPLState(const Config &q, ob::State *qom
 
   if(Nompl>0){
     double* qomplRn = static_cast<ob::RealVectorStateSpace::StateType*>(qomplRnSpace)->values;
-    for(uint i = 0; i < Nklampt; i++){
-      int idx = klampt_to_ompl.at(i);
-      if(idx<0) continue;
-      else qomplRn[idx]=q(6+i);
-    }
+    CopyKlamptToOMPL(q, qomplRn);
   }
 }
 
 Config GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::SE3StateSpace::StateType *qomplSE3, const ob::RealVectorStateSpace::StateType *qomplRnState){
+  Config q;
+  OMPLStateToConfig(qomplSE3, qomplRnState, q);
+  return q;
+}
+
+void GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::SE3StateSpace::StateType *qomplSE3, const ob::RealVectorStateSpace::StateType *qomplRnState, Config &q){
   const ob::SO3StateSpace::StateType *qomplSO3 = &qomplSE3->rotation();
 
-  Config q;
-  q.resize(6+Nklampt);
+  if(q.size() != (int)(6+Nklampt)) q.resize(6+Nklampt);
   q.setZero();
 
   q(0) = qomplSE3->getX();
@@ -169,26 +170,27 @@ Config GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::SE3StateSpace::Stat
     throw "SO3 element is NaN.";
   }
 
-  std::vector<double> rzyx = EulerZYXFromOMPLSO3StateSpace(qomplSO3);
-  q(3) = rzyx.at(0);
-  q(4) = rzyx.at(1);
-  q(5) = rzyx.at(2);
+  EulerZYXFromOMPLSO3StateSpace(qomplSO3, q(3), q(4), q(5));
 
-  for(uint i = 0; i < Nompl; i++){
-    uint idx = ompl_to_klampt.at(i);
-    q(idx) = qomplRnState->values[i];
+  if(Nompl>0){
+    CopyOMPLToKlampt(qomplRnState->values, q);
   }
+}
 
+Config GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::State *qompl){
+  Config q;
+  GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(qompl, q);
   return q;
 }
-Config GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::State *qompl){
+
+void GeometricCSpaceOMPLSE3RN::OMPLStateToConfig(const ob::State *qompl, Config &q){
   if(Nompl>0){
     const ob::SE3StateSpace::StateType *qomplSE3 = qompl->as<ob::CompoundState>()->as<ob::SE3StateSpace::StateType>(0);
     const ob::RealVectorStateSpace::StateType *qomplRnState = qompl->as<ob::CompoundState>()->as<ob::RealVectorStateSpace::StateType>(1);
-    return OMPLStateToConfig(qomplSE3, qomplRnState);
+    OMPLStateToConfig(qomplSE3, qomplRnState, q);
   }else{
     const ob::SE3StateSpace::StateType *qomplSE3 = qompl->as<ob::SE3StateSpace::StateType>();
-    return OMPLStateToConfig(qomplSE3, NULL);
+    OMPLStateToConfig(qomplSE3, NULL, q);
   }
 }
 
@@ -64,6 +64,11 @@ void GeometricCSpaceOMPLSE3Constrained::ConfigToOMPLState(const Config &q, ob::S
   qomplR2->values[1] = q[5];
 }
 
+void GeometricCSpaceOMPLSE3Constrained::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLSE3Constrained::OMPLStateToConfig(const ob::State *qompl)
 {
   const ob::RealVectorStateSpace::StateType *qomplR3 = 
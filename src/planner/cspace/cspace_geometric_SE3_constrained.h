@@ -10,6 +10,7 @@ class GeometricCSpaceOMPLSE3Constrained: public GeometricCSpaceOMPL
     virtual void initSpace() override;
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     Config OMPLStateToConfig(const ob::SE3StateSpace::StateType *qomplSE3, const ob::RealVectorStateSpace::StateType *qomplRnState);
 
     virtual void print(std::ostream& out = std::cout) const;
@@ -109,6 +109,12 @@ void GeometricCSpaceOMPLSO2RN::ConfigToOMPLState(const Config &q, ob::State *qom
 }
 
 Config GeometricCSpaceOMPLSO2RN::OMPLStateToConfig(const ob::State *qompl){
+  Config q;
+  GeometricCSpaceOMPLSO2RN::OMPLStateToConfig(qompl, q);
+  return q;
+}
+
+void GeometricCSpaceOMPLSO2RN::OMPLStateToConfig(const ob::State *qompl, Config &q){
   const ob::SO2StateSpace::StateType *qomplSO2{nullptr};
   const ob::RealVectorStateSpace::StateType *qomplRnSpace{nullptr};
 
@@ -120,15 +126,13 @@ Config GeometricCSpaceOMPLSO2RN::OMPLStateToConfig(const ob::State *qompl){
     qomplRnSpace = nullptr;
   }
 
-  Config q;q.resize(robot->q.size());q.setZero();
+  if(q.size() != robot->q.size()) q.resize(robot->q.size());
+  q.setZero();
   q(6)=qomplSO2->value;
 
-  for(uint i = 0; i < Nompl; i++){
-    uint idx = ompl_to_klampt.at(i);
-    q(idx) = qomplRnSpace->values[i];
+  if(Nompl>0){
+    CopyOMPLToKlampt(qomplRnSpace->values, q);
   }
-
-  return q;
 }
 
 void GeometricCSpaceOMPLSO2RN::print(std::ostream& out) const
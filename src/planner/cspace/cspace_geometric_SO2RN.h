@@ -7,6 +7,7 @@ class GeometricCSpaceOMPLSO2RN: public GeometricCSpaceOMPL
     virtual void initSpace();
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     virtual void print(std::ostream& out = std::cout) const;
     virtual Vector3 getXYZ(const ob::State*) override;
 };
@@ -82,6 +82,11 @@ double GeometricCSpaceOMPLSolidCylinder::OMPLStateToHeightValue(const ob::State
     return qomplRnSpace->values[1];
 }
 
+void GeometricCSpaceOMPLSolidCylinder::OMPLStateToConfig(const ob::State *x, Config &q)
+{
+  q = OMPLStateToConfig(x);
+}
+
 Config GeometricCSpaceOMPLSolidCylinder::OMPLStateToConfig(const ob::State *x)
 {
     double u = OMPLStateToSO2Value(x);
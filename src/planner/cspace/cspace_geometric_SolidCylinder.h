@@ -9,6 +9,7 @@ class GeometricCSpaceOMPLSolidCylinder: public GeometricCSpaceOMPL
     virtual void initSpace();
     virtual void ConfigToOMPLState(const Config &q, ob::State *qompl) override;
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     virtual void print(std::ostream& out = std::cout) const override;
     virtual Vector3 getXYZ(const ob::State*) override;
 
@@ -80,6 +80,11 @@ double GeometricCSpaceOMPLSolidTorus::OMPLStateToAngleValue(const ob::State *qom
     return qomplRnSpace->values[1];
 }
 
+void GeometricCSpaceOMPLSolidTorus::OMPLStateToConfig(const ob::State *x, Config &q)
+{
+  q = OMPLStateToConfig(x);
+}
+
 Config GeometricCSpaceOMPLSolidTorus::OMPLStateToConfig(const ob::State *x)
 {
     double u = OMPLStateToSO2Value(x);
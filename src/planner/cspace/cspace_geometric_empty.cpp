@@ -49,6 +49,11 @@ void GeometricCSpaceOMPLEmpty::ConfigToOMPLState(const Config &q, ob::State *qom
 {
 }
 
+void GeometricCSpaceOMPLEmpty::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config GeometricCSpaceOMPLEmpty::OMPLStateToConfig(const ob::State *qompl){
   Config q;
   return q;
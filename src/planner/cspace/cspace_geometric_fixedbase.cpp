@@ -85,14 +85,15 @@ void GeometricCSpaceOMPLFixedBase::ConfigToOMPLState(const Config &q, ob::State
 }
 
 Config GeometricCSpaceOMPLFixedBase::OMPLStateToConfig(const ob::State *qompl){
-  const ob::RealVectorStateSpace::StateType *qomplRN = qompl->as<ob::RealVectorStateSpace::StateType>();
-  Config q = robot->q; //do not change first 6 values (robot might have been translated from origin)
-  for(uint i = 0; i < Nompl; i++){
-    uint idx = ompl_to_klampt.at(i);
-    q(idx) = qomplRN->values[i];
-  }
+  Config q;
+  GeometricCSpaceOMPLFixedBase::OMPLStateToConfig(qompl, q);
   return q;
+}
 
+void GeometricCSpaceOMPLFixedBase::OMPLStateToConfig(const ob::State *qompl, Config &q){
+  const ob::RealVectorStateSpace::StateType *qomplRN = qompl->as<ob::RealVectorStateSpace::StateType>();
+  q = robot->q; //do not change first 6 values (robot might have been translated from origin)
+  CopyOMPLToKlampt(qomplRN->values, q);
 }
 void GeometricCSpaceOMPLFixedBase::print(std::ostream& out) const
 {
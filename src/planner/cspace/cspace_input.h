@@ -1,9 +1,27 @@
 #pragma once
 #include <KrisLibrary/robotics/RobotKinematics3D.h> //Config
+#include <string>
 
 struct CSpaceInput{
   double timestep_min;
   double timestep_max;
+  //memoization of propagations (0: disabled), see PropagationCache
+  uint propagation_cache_size{0};
+  double propagation_cache_memory{64};
+  //threads to propagate the agents of a multi-agent cspace (1: serial, 0:
+  //hardware concurrency), see MultiAgentIntegrator
+  uint propagation_threads{1};
+  //integration of the dynamics (euler|rk4|rk45), see TangentBundleIntegrator
+  std::string integrator_method{"euler"};
+  double integrator_tolerance{1e-6};
+  double integrator_max_step{0.1};
+  double integrator_mass_matrix_tolerance{0};
+  //memoization of clearance queries (0: disabled), see ClearanceCache.
+  //neighborhood_constant: cspace distance per workspace distance
+  uint clearance_cache_size{0};
+  double clearance_cache_resolution{0.01};
+  double clearance_cache_error{0.01};
+  double neighborhood_constant{1};
   Config uMin;
   Config uMax;
   Config dqMin;
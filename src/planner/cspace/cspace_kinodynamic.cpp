@@ -1,5 +1,6 @@
 #include "planner/cspace/cspace_kinodynamic.h"
 #include "planner/cspace/integrator/tangentbundle.h"
+#include "planner/cspace/integrator/propagation_cache.h"
 #include "planner/cspace/validitychecker/validity_checker_ompl.h"
 #include <ompl/base/spaces/SE3StateSpace.h>
 #include "common.h"
@@ -292,6 +293,11 @@ Config KinodynamicCSpaceOMPL::OMPLStateToVelocity(const ob::State *qompl)
   return dq;
 }
 
+void KinodynamicCSpaceOMPL::OMPLStateToConfig(const ob::State *qompl, Config &q)
+{
+  q = OMPLStateToConfig(qompl);
+}
+
 Config KinodynamicCSpaceOMPL::OMPLStateToConfig(const ob::State *qompl)
 {
   if(Nompl>0){
@@ -307,7 +313,22 @@ Config KinodynamicCSpaceOMPL::OMPLStateToConfig(const ob::State *qompl)
 
 const oc::StatePropagatorPtr KinodynamicCSpaceOMPL::StatePropagatorPtr(oc::SpaceInformationPtr si)
 {
-  return std::make_shared<TangentBundleIntegrator>(si, this);
+  auto integrator = std::make_shared<TangentBundleIntegrator>(si, this);
+  integrator->SetMethod(TangentBundleIntegrator::MethodFromString(input.integrator_method));
+  integrator->SetTolerance(input.integrator_tolerance);
+  integrator->SetMaxStepSize(input.integrator_max_step);
+  integrator->SetMassMatrixTolerance(input.integrator_mass_matrix_tolerance);
+  return integrator;
+}
+
+oc::StatePropagatorPtr KinodynamicCSpaceOMPL::CreateStatePropagator(oc::SpaceInformationPtr si)
+{
+  oc::StatePropagatorPtr propagator = StatePropagatorPtr(si);
+  if(input.propagation_cache_size > 0){
+    propagator = std::make_shared<PropagationCache>(si.get(), propagator,
+        input.propagation_cache_size, input.propagation_cache_memory);
+  }
+  return propagator;
 }
 
 //#############################################################################
@@ -320,7 +341,7 @@ ob::SpaceInformationPtr KinodynamicCSpaceOMPL::SpaceInformationPtr()
     si->setStateValidityChecker(checker);
 
     oc::SpaceInformationPtr siC = static_pointer_cast<oc::SpaceInformation>(si);
-    const oc::StatePropagatorPtr integrator = StatePropagatorPtr(siC);
+    const oc::StatePropagatorPtr integrator = CreateStatePropagator(siC);
     siC->setStatePropagator(integrator);
 
     siC->setMinMaxControlDuration(0.01, 0.1);
@@ -329,6 +350,20 @@ ob::SpaceInformationPtr KinodynamicCSpaceOMPL::SpaceInformationPtr()
   return si;
 }
 
+ob::SpaceInformationPtr KinodynamicCSpaceOMPL::CreateSpaceInformation()
+{
+  oc::SpaceInformationPtr siC = std::make_shared<oc::SpaceInformation>(SpacePtr(), ControlSpacePtr());
+
+  ob::StateValidityCheckerPtr checker = validity_checker;
+  siC->setStateValidityChecker(StateValidityCheckerPtr(siC));
+  validity_checker = checker;
+
+  siC->setStatePropagator(CreateStatePropagator(siC));
+  siC->setMinMaxControlDuration(0.01, 0.1);
+  siC->setPropagationStepSize(1);
+  return siC;
+}
+
 Vector3 KinodynamicCSpaceOMPL::getXYZ(const ob::State *s)
 {
   const ob::SE3StateSpace::StateType *qomplSE3 = s->as<ob::CompoundState>()->as<ob::SE3StateSpace::StateType>(0);
@@ -13,6 +13,8 @@ class KinodynamicCSpaceOMPL: public GeometricCSpaceOMPL
     KinodynamicCSpaceOMPL(RobotWorld *world_, int robot_idx);
 
     virtual const oc::StatePropagatorPtr StatePropagatorPtr(oc::SpaceInformationPtr si);
+    //StatePropagatorPtr, memoized by a PropagationCache if enabled in input
+    oc::StatePropagatorPtr CreateStatePropagator(oc::SpaceInformationPtr si);
     virtual void initSpace() override;
     virtual void initControlSpace();
     virtual void print(std::ostream& out = std::cout) const override;
@@ -24,10 +26,12 @@ class KinodynamicCSpaceOMPL: public GeometricCSpaceOMPL
     virtual ob::ScopedState<> ConfigVelocityToOMPLState(const Config &q, const Config &dq) override;
 
     virtual Config OMPLStateToConfig(const ob::State *qompl) override;
+    virtual void OMPLStateToConfig(const ob::State *qompl, Config &q) override;
     virtual Config OMPLStateToVelocity(const ob::State *qompl) override;
     //############################################################################
 
     virtual ob::SpaceInformationPtr SpaceInformationPtr() override;
+    virtual ob::SpaceInformationPtr CreateSpaceInformation() override;
     virtual bool isDynamic() const override;
 
     virtual Vector3 getXYZ(const ob::State*) override;
@@ -3,6 +3,7 @@
 #include "planner/cspace/cspace_multiagent.h"
 #include "planner/cspace/validitychecker/validity_checker_multiagent.h"
 #include "planner/cspace/integrator/multiagent.h"
+#include "planner/cspace/integrator/kinematic.h"
 #include <ompl/base/spaces/RealVectorStateSpace.h>
 #include <ompl/control/ControlSpace.h>
 
@@ -90,6 +91,10 @@ std::vector<int> CSpaceOMPLMultiAgent::GetRobotIdxs() const
 {
   return robot_ids;
 }
+std::vector<int> CSpaceOMPLMultiAgent::GetControlIdxs() const
+{
+  return control_idxs;
+}
 std::vector<int> CSpaceOMPLMultiAgent::GetProjectionIdxs() const
 {
   return ptr_to_next_level_robot_ids;
@@ -116,8 +121,8 @@ ob::SpaceInformationPtr CSpaceOMPLMultiAgent::SpaceInformationPtr(){
 
       oc::SpaceInformationPtr siC = static_pointer_cast<oc::SpaceInformation>(si);
 
-      const oc::StatePropagatorPtr integrator = 
-        std::make_shared<MultiAgentIntegrator>(siC, this, cspaces_);
+      auto integrator = std::make_shared<MultiAgentIntegrator>(siC, this, cspaces_);
+      integrator->SetNumberOfThreads(input.propagation_threads);
 
       siC->setStatePropagator(integrator);
 
@@ -131,6 +136,24 @@ ob::SpaceInformationPtr CSpaceOMPLMultiAgent::SpaceInformationPtr(){
   }
 }
 
+ob::SpaceInformationPtr CSpaceOMPLMultiAgent::CreateSpaceInformation()
+{
+  if(!isDynamic()) return BaseT::CreateSpaceInformation();
+
+  oc::SpaceInformationPtr siC = std::make_shared<oc::SpaceInformation>(SpacePtr(), ControlSpacePtr());
+
+  ob::StateValidityCheckerPtr checker = validity_checker;
+  siC->setStateValidityChecker(StateValidityCheckerPtr(siC));
+  validity_checker = checker;
+
+  auto integrator = std::make_shared<MultiAgentIntegrator>(siC, this, cspaces_);
+  integrator->SetNumberOfThreads(input.propagation_threads);
+  siC->setStatePropagator(integrator);
+  siC->setMinMaxControlDuration(0.01, 0.1);
+  siC->setPropagationStepSize(1);
+  return siC;
+}
+
 const ob::StateValidityCheckerPtr CSpaceOMPLMultiAgent::StateValidityCheckerPtr(ob::SpaceInformationPtr si)
 {
   validity_checker = std::make_shared<OMPLValidityCheckerMultiAgent>(si, this, cspaces_);
@@ -142,12 +165,21 @@ void CSpaceOMPLMultiAgent::initControlSpace()
   if(!isDynamic()) return;
 
   control_space = std::make_shared<oc::CompoundControlSpace>(SpacePtr());
+  control_idxs.clear();
+  int Ncontrols = 0;
   for(uint k = 0; k < cspaces_.size(); k++){
     CSpaceOMPL *ck = cspaces_.at(k);
     if(ck->isDynamic())
     {
-      // OMPL_ERROR("Need to add subspace to ControlSpace");
       static_pointer_cast<oc::CompoundControlSpace>(control_space)->addSubspace(ck->ControlSpacePtr());
+      control_idxs.push_back(Ncontrols++);
+    }else if(ck->GetDimensionality() > 0){
+      //kinematic agent, controlled by velocities (see KinematicIntegrator)
+      KinematicIntegrator integrator(ck->SpacePtr());
+      static_pointer_cast<oc::CompoundControlSpace>(control_space)->addSubspace(integrator.CreateControlSpace());
+      control_idxs.push_back(Ncontrols++);
+    }else{
+      control_idxs.push_back(-1);
     }
   }
 }
@@ -158,6 +190,7 @@ void CSpaceOMPLMultiAgent::initSpace()
 
   for(uint k = 0; k < cspaces_.size(); k++){
     CSpaceOMPL *ck = cspaces_.at(k);
+    ck->ComputeCopyPlan();
     ck->initSpace();
 
     static_pointer_cast<ob::CompoundStateSpace>(space)->addSubspace(ck->SpacePtr(), 1);
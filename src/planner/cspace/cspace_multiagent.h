@@ -41,11 +41,14 @@ class CSpaceOMPLMultiAgent: public CSpaceOMPL
     virtual bool isMultiAgent() const override;
 
     virtual ob::SpaceInformationPtr SpaceInformationPtr() override;
+    virtual ob::SpaceInformationPtr CreateSpaceInformation() override;
 
     virtual void print(std::ostream& out) const override;
 
     std::vector<int> GetRobotIdxs() const;
     std::vector<int> GetProjectionIdxs() const;
+    //index of control subspace of each agent (-1 if agent has no controls)
+    std::vector<int> GetControlIdxs() const;
     virtual Vector3 getXYZ(const ob::State*) override;
     virtual Vector3 getXYZ(const ob::State*, int) override;
 
@@ -63,6 +66,7 @@ class CSpaceOMPLMultiAgent: public CSpaceOMPL
 
     std::vector<int> ptr_to_next_level_robot_ids;
     std::vector<int> robot_ids;
+    std::vector<int> control_idxs;
 
     std::vector<int> Nklampts;
     std::vector<int> Nompls;
@@ -0,0 +1,40 @@
+#include "planner/cspace/integrator/kinematic.h"
+#include <ompl/control/spaces/RealVectorControlSpace.h>
+
+KinematicIntegrator::KinematicIntegrator(const ob::StateSpacePtr &space_, double maxSpeed_):
+  space(space_), maxSpeed(maxSpeed_)
+{
+  //value locations are only computed on setup of the space
+  space->computeLocations();
+  Ncontrol = space->getValueLocations().size();
+}
+
+uint KinematicIntegrator::GetControlDimension() const
+{
+  return Ncontrol;
+}
+
+oc::ControlSpacePtr KinematicIntegrator::CreateControlSpace() const
+{
+  auto control_space = std::make_shared<oc::RealVectorControlSpace>(space, Ncontrol);
+  ob::RealVectorBounds bounds(Ncontrol);
+  bounds.setLow(-1);
+  bounds.setHigh(+1);
+  control_space->setBounds(bounds);
+  return control_space;
+}
+
+void KinematicIntegrator::propagate(const ob::State *state, const oc::Control* control,
+    const double duration, ob::State *result) const
+{
+  const double *u = control->as<oc::RealVectorControlSpace::ControlType>()->values;
+
+  //thread-private buffer (propagate is called concurrently)
+  thread_local std::vector<double> reals;
+  space->copyToReals(reals, state);
+  for(uint k = 0; k < Ncontrol; k++){
+    reals.at(k) += duration*maxSpeed*u[k];
+  }
+  space->copyFromReals(result, reals);
+  space->enforceBounds(result);
+}
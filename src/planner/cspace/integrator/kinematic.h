@@ -0,0 +1,33 @@
+#pragma once
+#include <ompl/base/StateSpace.h>
+#include <ompl/control/ControlSpace.h>
+#include <vector>
+
+namespace ob = ompl::base;
+namespace oc = ompl::control;
+
+//Integrator for kinematic (non-dynamic) agents: the control is a velocity in
+//the real-valued coordinates of the state space (see
+//ob::StateSpace::copyToReals), which is applied directly:
+//
+//  x1 = x0 + duration * maxSpeed * u,  u \in [-1,1]^N
+//
+//The result is projected back onto the state space by enforceBounds (which
+//also normalizes rotations).
+class KinematicIntegrator
+{
+  public:
+    KinematicIntegrator(const ob::StateSpacePtr &space, double maxSpeed = 1.0);
+
+    void propagate(const ob::State *state, const oc::Control* control,
+        const double duration, ob::State *result) const;
+
+    //real vector control space with bounds [-1,1]
+    oc::ControlSpacePtr CreateControlSpace() const;
+    uint GetControlDimension() const;
+
+  private:
+    ob::StateSpacePtr space;
+    double maxSpeed;
+    uint Ncontrol;
+};
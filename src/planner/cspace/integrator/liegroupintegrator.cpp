@@ -78,16 +78,83 @@ void LieGroupIntegrator::Simulate(const State& x0, const ControlInput& u,std::ve
   }
 }
 
+namespace{
+  bool IsTwist(const Matrix4& x)
+  {
+    const double eps = 1e-12;
+    for(int j = 0; j < 4; j++){
+      if(fabs(x(3,j)) > eps) return false;
+    }
+    for(int i = 0; i < 3; i++){
+      if(fabs(x(i,i)) > eps) return false;
+      for(int j = i+1; j < 3; j++){
+        if(fabs(x(i,j) + x(j,i)) > eps) return false;
+      }
+    }
+    return true;
+  }
+}
+
+//exp([W v; 0 0]) = [R Vv; 0 1] with theta = |w| and
+//
+//  R = I + A W + B W^2,  V = I + B W + C W^2,
+//  A = sin(t)/t, B = (1-cos(t))/t^2, C = (t-sin(t))/t^3
+//
+//For small angles, A, B, C are replaced by their Taylor series (the closed
+//form loses precision due to cancellation).
 Matrix4 LieGroupIntegrator::MatrixExponential(const Matrix4& x)
 {
-  Eigen::MatrixXd A(4,4);
+  if(!IsTwist(x)) return MatrixExponentialPade(x);
+
+  Eigen::Matrix3d W;
+  Eigen::Vector3d v;
+  for(int i = 0; i < 3; i++){
+    for(int j = 0; j < 3; j++){
+      W(i,j) = x(i,j);
+    }
+    v(i) = x(i,3);
+  }
+  double t2 = W(2,1)*W(2,1) + W(0,2)*W(0,2) + W(1,0)*W(1,0);
+  double A, B, C;
+  if(t2 < 1e-4){
+    double t4 = t2*t2;
+    A = 1.0 - t2/6.0 + t4/120.0;
+    B = 0.5 - t2/24.0 + t4/720.0;
+    C = 1.0/6.0 - t2/120.0 + t4/5040.0;
+  }else{
+    double t = sqrt(t2);
+    double st = sin(t);
+    double ct = cos(t);
+    A = st/t;
+    B = (1.0 - ct)/t2;
+    C = (t - st)/(t2*t);
+  }
+  Eigen::Matrix3d W2 = W*W;
+  Eigen::Matrix3d R = Eigen::Matrix3d::Identity() + A*W + B*W2;
+  Eigen::Vector3d p = v + B*(W*v) + C*(W2*v);
+
+  Matrix4 result;
+  for(int i = 0; i < 3; i++){
+    for(int j = 0; j < 3; j++){
+      result(i,j) = R(i,j);
+    }
+    result(i,3) = p(i);
+    result(3,i) = 0;
+  }
+  result(3,3) = 1;
+  return result;
+}
+
+Matrix4 LieGroupIntegrator::MatrixExponentialPade(const Matrix4& x)
+{
+  Eigen::Matrix4d A;
   for(int i = 0; i < 4; i++){
     for(int j = 0; j < 4; j++){
       A(i,j) = x(i,j);
     }
   }
 
-  Eigen::MatrixXd Aexp = A.exp();
+  Eigen::Matrix4d Aexp = A.exp();
   Matrix4 result;
   //std::cout << "The matrix exponential of A is:\n" << Aexp << "\n\n";
   for(int i = 0; i < 4; i++){
@@ -27,7 +27,11 @@ class LieGroupIntegrator
     void SimulateEndpoint(const State& x0, const ControlInput& u,State& x1);
 
     void Euler_step(std::vector<Matrix4>& p, const Matrix4& dp0, double dt);
+    //closed-form exponential for elements of se(3), i.e. [w v; 0 0] with w
+    //skew-symmetric (falls back to MatrixExponentialPade otherwise)
     Matrix4 MatrixExponential(const Matrix4& x);
+    //generic Pade approximation of the exponential of a 4x4 matrix
+    Matrix4 MatrixExponentialPade(const Matrix4& x);
     Matrix4 SE3Derivative(const ControlInput& u);
 
     Matrix4 StateToSE3(const State& x);
@@ -1,4 +1,7 @@
 #include "multiagent.h"
+#include "planner/cspace/cspace_multiagent.h"
+#include <map>
+#include <mutex>
 
 namespace oc = ompl::control;
 MultiAgentIntegrator::MultiAgentIntegrator(
@@ -10,32 +13,91 @@ MultiAgentIntegrator::MultiAgentIntegrator(
     cspace_(cspace), 
     cspaces_(cspaces)
 {
+  control_idxs_ = cspace_->GetControlIdxs();
   for(uint k = 0; k < cspaces_.size(); k++){
-    SingleRobotCSpace *kck = static_cast<SingleRobotCSpace*>(cspaces.at(k)->GetCSpaceKlamptPtr());
+    CSpaceOMPL *ck = cspaces_.at(k);
+    SingleRobotCSpace *kck = static_cast<SingleRobotCSpace*>(ck->GetCSpaceKlamptPtr());
     klampt_single_robot_cspaces_.push_back(kck);
+
+    oc::StatePropagatorPtr propagator = nullptr;
+    std::shared_ptr<KinematicIntegrator> integrator = nullptr;
+    if(ck->isDynamic()){
+      oc::SpaceInformationPtr sikC = static_pointer_cast<oc::SpaceInformation>(ck->SpaceInformationPtr());
+      propagator = sikC->getStatePropagator();
+    }else if(ck->GetDimensionality() > 0){
+      integrator = std::make_shared<KinematicIntegrator>(ck->SpacePtr());
+    }
+    propagators_.push_back(propagator);
+    kinematic_integrators_.push_back(integrator);
   }
 }
 
-void MultiAgentIntegrator::propagate(const ob::State *state, const oc::Control* control, const double duration, ob::State *result) const
+//one pool per number of threads, shared by all integrators (e.g. of all
+//levels and all benchmark workers), such that they do not oversubscribe
+static std::shared_ptr<ThreadPool> GetSharedPool(uint Nthreads)
 {
-  for(uint k = 0; k < cspaces_.size(); k++){
-    CSpaceOMPL *ck = cspaces_.at(k);
+  static std::mutex mutex;
+  static std::map<uint, std::weak_ptr<ThreadPool>> pools;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<ThreadPool> pool = pools[Nthreads].lock();
+  if(!pool){
+    pool = std::make_shared<ThreadPool>(Nthreads);
+    pools[Nthreads] = pool;
+  }
+  return pool;
+}
+
+void MultiAgentIntegrator::SetNumberOfThreads(uint Nthreads)
+{
+  if(Nthreads == 1){
+    pool_ = nullptr;
+  }else{
+    pool_ = GetSharedPool(Nthreads);
+  }
+}
+
+uint MultiAgentIntegrator::GetNumberOfThreads() const
+{
+  return (pool_ ? pool_->GetNumberOfThreads() : 1);
+}
+
+void MultiAgentIntegrator::SetMinimumParallelAgents(uint N)
+{
+  minimumParallelAgents_ = N;
+}
+
+void MultiAgentIntegrator::PropagateAgent(uint k, const ob::State *state, const oc::Control* control, const double duration, ob::State *result) const
+{
+  CSpaceOMPL *ck = cspaces_.at(k);
+  const ob::State *statek = static_cast<const ob::CompoundState*>(state)->as<ob::State>(k);
+  ob::State *resultk = static_cast<ob::CompoundState*>(result)->as<ob::State>(k);
 
-    if(ck->isDynamic())
-    {
-      const ob::State *statek = static_cast<const ob::CompoundState*>(state)->as<ob::State>(k);
-      const oc::Control *controlk = static_cast<const oc::CompoundControl*>(control)->as<oc::Control>(k);
-      ob::State *resultk = static_cast<ob::CompoundState*>(result)->as<ob::State>(k);
-
-      ob::SpaceInformationPtr sik = ck->SpaceInformationPtr();
-      oc::SpaceInformationPtr sikC = static_pointer_cast<oc::SpaceInformation>(sik);
-      sikC->getStatePropagator()->propagate(statek, controlk, duration, resultk);
-    }else{
-      if(ck->GetDimensionality() > 0)
-      {
-        OMPL_ERROR("NYI");
-        throw "NYI";
-      }
+  int ik = control_idxs_.at(k);
+  if(ik < 0){
+    //agent without degrees of freedom
+    ck->SpacePtr()->copyState(resultk, statek);
+    return;
+  }
+  const oc::Control *controlk = static_cast<const oc::CompoundControl*>(control)->as<oc::Control>(ik);
+
+  if(propagators_.at(k)){
+    propagators_.at(k)->propagate(statek, controlk, duration, resultk);
+  }else{
+    kinematic_integrators_.at(k)->propagate(statek, controlk, duration, resultk);
+  }
+}
+
+void MultiAgentIntegrator::propagate(const ob::State *state, const oc::Control* control, const double duration, ob::State *result) const
+{
+  uint N = cspaces_.size();
+  if(pool_ && N >= minimumParallelAgents_){
+    pool_->ParallelFor(N, [&](uint k){
+        PropagateAgent(k, state, control, duration, result);
+    });
+  }else{
+    for(uint k = 0; k < N; k++){
+      PropagateAgent(k, state, control, duration, result);
     }
   }
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include "tangentbundle.h"
+#include "kinematic.h"
+#include "algorithms/thread_pool.h"
 
 // using namespace Math3D;
 class CSpaceOMPL;
@@ -14,6 +16,11 @@ class CSpaceOMPLMultiAgent;
 namespace oc = ompl::control;
 namespace ob = ompl::base;
 
+//Propagates all agents for the same duration. Dynamic agents use the state
+//propagator of their own space, kinematic agents a KinematicIntegrator.
+//Agents are independent, so with enough agents they can be propagated in
+//parallel (each agent writes only into its own substate). Propagation is
+//serial by default.
 class MultiAgentIntegrator : public oc::StatePropagator
 {
   public:
@@ -21,9 +28,27 @@ class MultiAgentIntegrator : public oc::StatePropagator
 
     virtual void propagate(const ob::State *state, const oc::Control* control, const double duration, ob::State *result) const override;
 
+    //Nthreads = 1: propagate agents serially. Otherwise agents are propagated
+    //on a thread pool with Nthreads threads (0: hardware concurrency), which is
+    //shared by all integrators of the process (propagations which find the
+    //pool busy run serially).
+    void SetNumberOfThreads(uint Nthreads);
+    uint GetNumberOfThreads() const;
+    //minimum number of agents to propagate in parallel
+    void SetMinimumParallelAgents(uint N);
+
   protected:
+    void PropagateAgent(uint k, const ob::State *state, const oc::Control* control, const double duration, ob::State *result) const;
+
     CSpaceOMPLMultiAgent *cspace_;
     std::vector<CSpaceOMPL*> cspaces_;
     std::vector<SingleRobotCSpace*> klampt_single_robot_cspaces_;
-};
 
+    //per agent: propagator (dynamic agents) or integrator (kinematic agents)
+    std::vector<oc::StatePropagatorPtr> propagators_;
+    std::vector<std::shared_ptr<KinematicIntegrator>> kinematic_integrators_;
+    std::vector<int> control_idxs_;
+
+    std::shared_ptr<ThreadPool> pool_{nullptr};
+    uint minimumParallelAgents_{4};
+};
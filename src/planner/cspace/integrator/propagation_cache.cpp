@@ -0,0 +1,153 @@
+#include "planner/cspace/integrator/propagation_cache.h"
+#include <ompl/util/Time.h>
+#include <cstring>
+
+PropagationCache::PropagationCache(oc::SpaceInformation *si, const oc::StatePropagatorPtr &propagator_,
+    uint maxEntries_, double maxMemoryMB):
+  oc::StatePropagator(si), propagator(propagator_),
+  space(si->getStateSpace()), controlSpace(si->getControlSpace()),
+  maxEntries(maxEntries_), maxMemory(maxMemoryMB*1024*1024)
+{
+  //key, result state, list and hash map nodes
+  uint keyLength = space->getSerializationLength() + controlSpace->getSerializationLength() + sizeof(double);
+  entryMemory = 2*keyLength + space->getSerializationLength() + sizeof(Entry) + 6*sizeof(void*);
+}
+
+PropagationCache::~PropagationCache()
+{
+  Clear();
+}
+
+void PropagationCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for(auto it = entries.begin(); it != entries.end(); it++){
+    space->freeState(it->result);
+  }
+  entries.clear();
+  index.clear();
+  memory = 0;
+  hits = 0;
+  misses = 0;
+  evictions = 0;
+  missTime = 0;
+}
+
+void PropagationCache::BuildKey(const ob::State *state, const oc::Control *control, double duration, std::string &key) const
+{
+  uint Ns = space->getSerializationLength();
+  uint Nc = controlSpace->getSerializationLength();
+  key.resize(Ns + Nc + sizeof(double));
+  space->serialize(&key[0], state);
+  controlSpace->serialize(&key[Ns], control);
+  std::memcpy(&key[Ns + Nc], &duration, sizeof(double));
+}
+
+void PropagationCache::propagate(const ob::State *state, const oc::Control* control,
+    const double duration, ob::State *result) const
+{
+  thread_local std::string key;
+  BuildKey(state, control, duration, key);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if(it != index.end()){
+      space->copyState(result, it->second->result);
+      entries.splice(entries.begin(), entries, it->second);
+      hits++;
+      return;
+    }
+  }
+
+  ompl::time::point start = ompl::time::now();
+  propagator->propagate(state, control, duration, result);
+  double t = ompl::time::seconds(ompl::time::now() - start);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  misses++;
+  missTime += t;
+  Insert(key, result);
+}
+
+//needs lock on mutex
+void PropagationCache::Insert(const std::string &key, const ob::State *result) const
+{
+  if(maxEntries == 0 || entryMemory > maxMemory) return;
+  //another thread might have inserted the same key in the meantime
+  if(index.find(key) != index.end()) return;
+
+  while(!entries.empty() && (entries.size() >= maxEntries || memory + entryMemory > maxMemory)){
+    Entry &last = entries.back();
+    space->freeState(last.result);
+    index.erase(last.key);
+    entries.pop_back();
+    memory -= entryMemory;
+    evictions++;
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.result = space->allocState();
+  space->copyState(entry.result, result);
+  entries.push_front(entry);
+  index[key] = entries.begin();
+  memory += entryMemory;
+}
+
+bool PropagationCache::steer(const ob::State *from, const ob::State *to, oc::Control *result, double &duration) const
+{
+  return propagator->steer(from, to, result, duration);
+}
+
+bool PropagationCache::canSteer() const
+{
+  return propagator->canSteer();
+}
+
+unsigned long PropagationCache::GetNumberOfHits() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
+unsigned long PropagationCache::GetNumberOfMisses() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return misses;
+}
+unsigned long PropagationCache::GetNumberOfEvictions() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return evictions;
+}
+double PropagationCache::GetTimeSaved() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return (misses > 0 ? hits*missTime/misses : 0);
+}
+unsigned long PropagationCache::GetMemory() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return memory;
+}
+uint PropagationCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+void PropagationCache::Print(std::ostream& out) const
+{
+  unsigned long h = GetNumberOfHits();
+  unsigned long m = GetNumberOfMisses();
+  out << "PropagationCache: " << GetNumberOfEntries() << " entries (" << GetMemory()/(1024.0*1024.0) << " MB)"
+    << ", hits " << h << ", misses " << m
+    << ", hit rate " << (h+m > 0 ? 100.0*h/(h+m) : 0) << "%"
+    << ", evictions " << GetNumberOfEvictions()
+    << ", time saved " << GetTimeSaved() << "s";
+}
+
+std::ostream& operator<< (std::ostream& out, const PropagationCache& cache)
+{
+  cache.Print(out);
+  return out;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <ompl/control/SpaceInformation.h>
+#include <ompl/control/StatePropagator.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ob = ompl::base;
+namespace oc = ompl::control;
+
+//PropagationCache: memoizes the results of another state propagator. The key
+//is the serialization of (state, control, duration), i.e. only bitwise equal
+//inputs hit (e.g. a tree node expanded again with a control of a discrete
+//control set). Results are kept in a least-recently-used list, bounded by
+//the number of entries and the (estimated) memory of keys and states.
+class PropagationCache: public oc::StatePropagator
+{
+  public:
+    PropagationCache(oc::SpaceInformation *si, const oc::StatePropagatorPtr &propagator,
+        uint maxEntries = 100000, double maxMemoryMB = 64);
+    ~PropagationCache();
+
+    void propagate(const ob::State *state, const oc::Control* control,
+        const double duration, ob::State *result) const override;
+    bool steer(const ob::State *from, const ob::State *to, oc::Control *result, double &duration) const override;
+    bool canSteer() const override;
+
+    //removes all entries and resets statistics
+    void Clear();
+
+    unsigned long GetNumberOfHits() const;
+    unsigned long GetNumberOfMisses() const;
+    unsigned long GetNumberOfEvictions() const;
+    //estimated time saved by hits (hits times average propagation time)
+    double GetTimeSaved() const;
+    //estimated memory of all entries (bytes)
+    unsigned long GetMemory() const;
+    uint GetNumberOfEntries() const;
+
+    void Print(std::ostream& out) const;
+    friend std::ostream& operator<< (std::ostream& out, const PropagationCache& cache);
+
+  private:
+    struct Entry
+    {
+      std::string key;
+      ob::State *result;
+    };
+    void BuildKey(const ob::State *state, const oc::Control *control, double duration, std::string &key) const;
+    void Insert(const std::string &key, const ob::State *result) const;
+
+    oc::StatePropagatorPtr propagator;
+    //state space and control space own their allocations, such that entries
+    //can be freed even while the space information is destroyed
+    ob::StateSpacePtr space;
+    oc::ControlSpacePtr controlSpace;
+
+    uint maxEntries;
+    unsigned long maxMemory;
+    unsigned long entryMemory;
+
+    mutable std::mutex mutex;
+    //most recently used entry first
+    mutable std::list<Entry> entries;
+    mutable std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    mutable unsigned long memory{0};
+
+    mutable unsigned long hits{0};
+    mutable unsigned long misses{0};
+    mutable unsigned long evictions{0};
+    mutable double missTime{0};
+};
@@ -1,6 +1,152 @@
 #include "planner/cspace/integrator/tangentbundle.h"
 #include "planner/cspace/cspace_kinodynamic.h"
 #include "planner/cspace/integrator/liegroupintegrator.h"
+#include <KrisLibrary/math/LDL.h>
+#include <atomic>
+#include <unordered_map>
+
+namespace{
+  std::atomic<unsigned long> integratorCounter{0};
+
+  //Butcher tableaus (a is lower triangular, row-major s x s)
+  struct Tableau{
+    uint s;
+    const double *a;
+    const double *b;
+    //embedded lower order weights (nullptr: no error estimate)
+    const double *bhat;
+  };
+
+  const double RK4_a[16] = {
+    0, 0, 0, 0,
+    0.5, 0, 0, 0,
+    0, 0.5, 0, 0,
+    0, 0, 1, 0};
+  const double RK4_b[4] = {1.0/6, 1.0/3, 1.0/3, 1.0/6};
+  const Tableau RK4Tableau = {4, RK4_a, RK4_b, nullptr};
+
+  const double DOPRI_a[49] = {
+    0, 0, 0, 0, 0, 0, 0,
+    1.0/5, 0, 0, 0, 0, 0, 0,
+    3.0/40, 9.0/40, 0, 0, 0, 0, 0,
+    44.0/45, -56.0/15, 32.0/9, 0, 0, 0, 0,
+    19372.0/6561, -25360.0/2187, 64448.0/6561, -212.0/729, 0, 0, 0,
+    9017.0/3168, -355.0/33, 46732.0/5247, 49.0/176, -5103.0/18656, 0, 0,
+    35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0};
+  const double DOPRI_b[7] = {35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0};
+  const double DOPRI_bhat[7] = {5179.0/57600, 0, 7571.0/16695, 393.0/640, -92097.0/339200, 187.0/2100, 1.0/40};
+  const Tableau DOPRITableau = {7, DOPRI_a, DOPRI_b, DOPRI_bhat};
+
+  //coefficients of the generators X1..X6 of a twist matrix (inverse of
+  //LieGroupIntegrator::SE3Derivative)
+  void Vee(const Matrix4 &M, Config &x)
+  {
+    x.resize(6);
+    x(0) = M(0,3);
+    x(1) = M(1,3);
+    x(2) = M(2,3);
+    x(3) = M(1,0);
+    x(4) = M(0,2);
+    x(5) = M(2,1);
+  }
+}
+
+struct TangentBundleIntegrator::ThreadData
+{
+  RobotDynamics3D robot;
+  //configuration at which the mass matrix was factorized
+  Config qB;
+  Math::LDLDecomposition<Real> ldl;
+  LieGroupIntegrator lie;
+};
+
+TangentBundleIntegrator::TangentBundleIntegrator(oc::SpaceInformationPtr si, KinodynamicCSpaceOMPL *cspace_) : 
+    oc::StatePropagator(si.get()), cspace(cspace_), id(++integratorCounter)
+{
+}
+
+TangentBundleIntegrator::ThreadData& TangentBundleIntegrator::GetThreadData() const
+{
+  thread_local std::unordered_map<unsigned long, ThreadData> data;
+  auto it = data.find(id);
+  if(it == data.end()){
+    it = data.emplace(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple()).first;
+    it->second.robot = *cspace->GetRobotPtr();
+  }
+  return it->second;
+}
+
+void TangentBundleIntegrator::SetMethod(Method method_)
+{
+  method = method_;
+}
+void TangentBundleIntegrator::SetTolerance(double tolerance_)
+{
+  tolerance = tolerance_;
+}
+void TangentBundleIntegrator::SetMaxStepSize(double maxStepSize_)
+{
+  maxStepSize = maxStepSize_;
+}
+void TangentBundleIntegrator::SetMassMatrixTolerance(double massMatrixTolerance_)
+{
+  massMatrixTolerance = massMatrixTolerance_;
+}
+TangentBundleIntegrator::Method TangentBundleIntegrator::MethodFromString(const std::string &name)
+{
+  if(name == "euler") return EULER;
+  if(name == "rk4") return RK4;
+  if(name == "rk45") return RK45;
+  std::cout << "Unknown integration method " << name << " (euler|rk4|rk45)" << std::endl;
+  throw "Unknown integration method.";
+}
+unsigned long TangentBundleIntegrator::GetNumberOfDynamicsEvaluations() const
+{
+  return Nevaluations;
+}
+unsigned long TangentBundleIntegrator::GetNumberOfFactorizations() const
+{
+  return Nfactorizations;
+}
+void TangentBundleIntegrator::ResetCounters()
+{
+  Nevaluations = 0;
+  Nfactorizations = 0;
+}
+
+void TangentBundleIntegrator::Acceleration(const Config &q, const Config &dq, const Config &u, Config &ddq) const
+{
+  ThreadData &data = GetThreadData();
+  RobotDynamics3D &robot = data.robot;
+  robot.UpdateConfig(q);
+  robot.dq = dq;
+  robot.UpdateDynamics();
+  Nevaluations++;
+
+  bool factorize = (massMatrixTolerance <= 0 || data.qB.n != q.n);
+  for(int i = 0; !factorize && i < q.n; i++){
+    if(fabs(q(i) - data.qB(i)) > massMatrixTolerance) factorize = true;
+  }
+  if(factorize){
+    if(robot.GetTotalMass() <= 0)
+    {
+        OMPL_WARN("Computing dynamics with zero-mass robot.");
+    }
+    Math::Matrix B;
+    robot.GetKineticEnergyMatrix(B);
+    data.ldl.set(B);
+    data.qB = q;
+    Nfactorizations++;
+  }
+
+  Math::Vector C;
+  robot.GetCoriolisForces(C);
+  Math::Vector f(q.n, 0.0);
+  for(int i = 0; i < u.n && i < q.n; i++) f(i) = u(i);
+  f -= C;
+  ddq.resize(q.n);
+  data.ldl.backSub(f, ddq);
+}
 
 Matrix3 GetTotalInertiaAtPoint(const Robot *robot, const Vector3 &p)
 {
@@ -134,48 +280,152 @@ void TangentBundleIntegrator::propagate_dynamics(const ob::State *state, const o
     throw "Negative prop step size.";
   }
 
-  //###########################################################################
-  // (2) compute ddq0 (without drift)
-  //###########################################################################
+  Config q1, dq1;
+  if(method == EULER){
+    //###########################################################################
+    // (2) compute ddq0 (without drift)
+    //###########################################################################
+    Config ddq0;
+    Acceleration(q0, dq0, u, ddq0);
 
-  Robot *robot = cspace->GetRobotPtr();
-  robot->UpdateConfig(q0);
-  robot->dq = dq0;
-  robot->UpdateDynamics();
+    //###########################################################################
+    //(3) integrate ddq0, dq0 to dq1
+    //###########################################################################
+    q1 = q0;
+    dq1 = dq0;
 
-  Config ddq0;
-  robot->CalcAcceleration(ddq0, u);
+    for(int i = 0; i < ddq0.size(); i++){
+      dq1(i) = dq0(i) + dt*ddq0(i);
+    }
+    //###########################################################################
+    //(4) integrate dq1 using lie group operation
+    //###########################################################################
+    LieGroupIntegrator integrator;
+    Matrix4 q0_SE3 = integrator.StateToSE3(q0);
+    Matrix4 dq1_SE3 = integrator.SE3Derivative(dq1);
+    Matrix4 q1_SE3 = integrator.Integrate(q0_SE3, dq1_SE3, dt);
 
-  double m = robot->GetTotalMass();
-  if(m <= 0)
-  {
-      OMPL_WARN("Computing dynamics with zero-mass robot.");
+    integrator.SE3ToState(q1, q1_SE3);
+  }else{
+    auto acceleration = [&](const Config &q, const Config &dq, Config &ddq){ Acceleration(q, dq, u, ddq); };
+    propagate_rk(q0, dq0, dt, acceleration, q1, dq1);
   }
 
   //###########################################################################
-  //(3) integrate ddq0, dq0 to dq1
+  //(5) convert (q1,dq1) to result
   //###########################################################################
-  Config q1(q0);
-  Config dq1(dq0);
 
-  for(int i = 0; i < ddq0.size(); i++){
-    dq1(i) = dq0(i) + dt*ddq0(i);
+  cspace->ConfigVelocityToOMPLState(q1, dq1, result);
+}
+
+// Runge-Kutta-Munthe-Kaas: each step starts at (g0,r0,v0) with g0 \in SE(3),
+// shape r0 and velocity v0 and integrates y = (sigma, r, v) with
+//
+//  g = g0 exp(sigma), dsigma = dexp^{-1}_{-sigma}(v_SE3), dr = v_shape, dv = ddq
+//
+// starting at sigma = 0. v_SE3 is a body velocity (dg = g v_SE3, as in the
+// Euler step), hence the inverse of the right-trivialized dexp. It is
+// truncated after the second bracket (sufficient for order 4 and 5 up to the
+// error estimate). The step ends at g1 = g0 exp(sigma1).
+void TangentBundleIntegrator::propagate_rk(const Config &q0, const Config &dq0, double dt,
+    const AccelerationFunction &acceleration, Config &q1, Config &dq1) const
+{
+  LieGroupIntegrator &lie = GetThreadData().lie;
+  const int N = q0.n;
+  const int Ny = 2*N;
+  const Tableau &tableau = (method == RK4 ? RK4Tableau : DOPRITableau);
+  const uint S = tableau.s;
+
+  Matrix4 g = lie.StateToSE3(q0);
+  Config y0(Ny, 0.0);
+  for(int i = 6; i < N; i++) y0(i) = q0(i);
+  for(int i = 0; i < N; i++) y0(N + i) = dq0(i);
+
+  Config q(q0), dq(N), ddq, sigma(6), xi(6), ad(6);
+  std::vector<Config> k(S, Config(Ny));
+  Config y(Ny), y1(Ny), yhat(Ny);
+
+  //derivative of y (in exponential coordinates around g)
+  auto F = [&](const Config &yk, Config &dy)
+  {
+    for(int i = 0; i < 6; i++) sigma(i) = yk(i);
+    Matrix4 S_se3 = lie.SE3Derivative(sigma);
+    lie.SE3ToState(q, g*lie.MatrixExponential(S_se3));
+    for(int i = 6; i < N; i++) q(i) = yk(i);
+    for(int i = 0; i < N; i++) dq(i) = yk(N + i);
+
+    acceleration(q, dq, ddq);
+
+    //dexp^{-1}_{-sigma}(xi) = xi + 1/2 [sigma,xi] + 1/12 [sigma,[sigma,xi]]
+    for(int i = 0; i < 6; i++) xi(i) = dq(i);
+    Matrix4 X = lie.SE3Derivative(xi);
+    Matrix4 ad1 = S_se3*X - X*S_se3;
+    Matrix4 ad2 = S_se3*ad1 - ad1*S_se3;
+    Vee(ad1, ad);
+    for(int i = 0; i < 6; i++) dy(i) = xi(i) + 0.5*ad(i);
+    Vee(ad2, ad);
+    for(int i = 0; i < 6; i++) dy(i) += ad(i)/12.0;
+    for(int i = 6; i < N; i++) dy(i) = dq(i);
+    for(int i = 0; i < N; i++) dy(N + i) = ddq(i);
+  };
+
+  double t = 0;
+  double h = std::min(dt, maxStepSize);
+  if(method == RK4){
+    uint Nsteps = std::max(1, (int)ceil(dt/maxStepSize - 1e-10));
+    h = dt/Nsteps;
   }
-  //###########################################################################
-  //(4) integrate dq1 using lie group operation
-  //###########################################################################
-  LieGroupIntegrator integrator;
-  Matrix4 q0_SE3 = integrator.StateToSE3(q0);
-  Matrix4 dq1_SE3 = integrator.SE3Derivative(dq1);
-  Matrix4 q1_SE3 = integrator.Integrate(q0_SE3, dq1_SE3, dt);
+  const double hmin = 1e-6*dt;
 
-  integrator.SE3ToState(q1, q1_SE3);
+  while(dt - t > 1e-12*dt){
+    h = std::min(h, dt - t);
+    for(uint i = 0; i < S; i++){
+      y = y0;
+      for(uint j = 0; j < i; j++){
+        double aij = tableau.a[i*S + j];
+        if(aij != 0) y.madd(k.at(j), h*aij);
+      }
+      F(y, k.at(i));
+    }
+    y1 = y0;
+    for(uint i = 0; i < S; i++){
+      if(tableau.b[i] != 0) y1.madd(k.at(i), h*tableau.b[i]);
+    }
 
-  //###########################################################################
-  //(5) convert (q1,dq1) to result
-  //###########################################################################
+    if(tableau.bhat != nullptr){
+      yhat = y0;
+      for(uint i = 0; i < S; i++){
+        if(tableau.bhat[i] != 0) yhat.madd(k.at(i), h*tableau.bhat[i]);
+      }
+      double error = 0;
+      for(int i = 0; i < Ny; i++){
+        double scale = tolerance*(1.0 + std::max(fabs(y0(i)), fabs(y1(i))));
+        error = std::max(error, fabs(y1(i) - yhat(i))/scale);
+      }
+      double factor = (error > 0 ? 0.9*pow(error, -0.2) : 5.0);
+      factor = std::min(5.0, std::max(0.2, factor));
+      if(error > 1 && h > hmin){
+        h = std::max(hmin, h*factor);
+        continue;
+      }
+      t += h;
+      h = std::min(maxStepSize, h*factor);
+    }else{
+      t += h;
+    }
 
-  cspace->ConfigVelocityToOMPLState(q1, dq1, result);
+    //recenter exponential coordinates
+    for(int i = 0; i < 6; i++) sigma(i) = y1(i);
+    g = g*lie.MatrixExponential(lie.SE3Derivative(sigma));
+    y0 = y1;
+    for(int i = 0; i < 6; i++) y0(i) = 0;
+  }
+
+  q1 = q0;
+  lie.SE3ToState(q1, g);
+  for(int i = 6; i < N; i++) q1(i) = y0(i);
+  dq1.resize(N);
+  for(int i = 0; i < N; i++) dq1(i) = y0(N + i);
 }
 
 bool TangentBundleIntegrator::steer(const ob::State * /*from*/, const ob::State * /*to*/, oc::Control * /*result*/,
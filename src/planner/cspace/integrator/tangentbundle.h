@@ -5,6 +5,8 @@
 #include <KrisLibrary/math3d/rotation.h>
 #include <KrisLibrary/math/diffeq.h>
 #include <Planning/RobotCSpace.h>
+#include <atomic>
+#include <functional>
 #include <vector>
 #include "planner/cspace/cspace.h"
 
@@ -33,14 +35,27 @@ class KinodynamicCSpaceOMPL;
 namespace oc = ompl::control;
 namespace ob = ompl::base;
 
+//Integration of the dynamics over the time step dt (last control entry):
+//
+//  EULER: one semi-implicit Euler step (dq1 = dq0 + dt ddq0, q1 = q0 exp(dt dq1))
+//  RK4  : classical Runge-Kutta on the Lie group (Munthe-Kaas, i.e. in
+//         exponential coordinates around the SE(3) element of each step),
+//         with ceil(dt/maxStepSize) equal steps
+//  RK45 : embedded Dormand-Prince 5(4) on the Lie group, with error control
+//         (relative/absolute tolerance) and adaptive step size
+//
+//The factorization of the mass matrix is reused while the configuration
+//stays within massMatrixTolerance (inf-norm) of the configuration it was
+//computed at (0: factorize at every evaluation).
+//
+//Defaults are EULER and exact factorizations; RK4/RK45 and the tolerances are
+//set from the <integrator> settings of the planner input.
 class TangentBundleIntegrator : public oc::StatePropagator
 {
   public:
+      enum Method{EULER, RK4, RK45};
 
-      TangentBundleIntegrator(oc::SpaceInformationPtr si, KinodynamicCSpaceOMPL *cspace_) : 
-          oc::StatePropagator(si.get()), cspace(cspace_)
-      {
-      }
+      TangentBundleIntegrator(oc::SpaceInformationPtr si, KinodynamicCSpaceOMPL *cspace_);
       virtual void propagate(
           const ob::State *state, 
           const oc::Control* control, 
@@ -56,8 +71,46 @@ class TangentBundleIntegrator : public oc::StatePropagator
 
       virtual bool canSteer() const override;
 
+      void SetMethod(Method method_);
+      void SetTolerance(double tolerance_);
+      void SetMaxStepSize(double maxStepSize_);
+      void SetMassMatrixTolerance(double massMatrixTolerance_);
+      //euler|rk4|rk45
+      static Method MethodFromString(const std::string &name);
 
+      //ddq as function of (q,dq)
+      typedef std::function<void(const Config &q, const Config &dq, Config &ddq)> AccelerationFunction;
+
+      //RK4 (if method is RK4, RK45 otherwise) integration of (q0,dq0) over dt
+      //for a given acceleration (the dynamics in propagate, or any other
+      //field, e.g. to check the integrator against closed-form solutions)
+      void propagate_rk(const Config &q0, const Config &dq0, double dt,
+          const AccelerationFunction &acceleration, Config &q1, Config &dq1) const;
+
+      unsigned long GetNumberOfDynamicsEvaluations() const;
+      unsigned long GetNumberOfFactorizations() const;
+      void ResetCounters();
 
       KinodynamicCSpaceOMPL *cspace;
+
+  protected:
+      struct ThreadData;
+
+      //dynamics are computed on a thread-private copy of the robot, such that
+      //several agents (or planner threads) can propagate concurrently
+      ThreadData& GetThreadData() const;
+
+      //ddq = B(q)^{-1} (f - C(q,dq)) with f = (u,0)
+      void Acceleration(const Config &q, const Config &dq, const Config &u, Config &ddq) const;
+
+      unsigned long id{0};
+
+      Method method{EULER};
+      double tolerance{1e-6};
+      double maxStepSize{0.1};
+      double massMatrixTolerance{0};
+
+      mutable std::atomic<unsigned long> Nevaluations{0};
+      mutable std::atomic<unsigned long> Nfactorizations{0};
 };
 
@@ -0,0 +1,131 @@
+#include "planner/cspace/validitychecker/clearance_cache.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <cstring>
+
+ClearanceCache::ClearanceCache(const ob::StateSpacePtr &space_, double resolution_,
+    double lipschitz_, double maxError_, uint maxEntries_):
+  space(space_), resolution(resolution_), lipschitz(lipschitz_),
+  maxError(maxError_), maxEntries(maxEntries_)
+{
+  if(resolution <= 0){
+    std::cout << "[ClearanceCache] resolution needs to be positive (is " << resolution << ")." << std::endl;
+    throw "Invalid resolution.";
+  }
+}
+
+ClearanceCache::~ClearanceCache()
+{
+  Clear();
+}
+
+void ClearanceCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for(auto it = entries.begin(); it != entries.end(); it++){
+    space->freeState(it->state);
+  }
+  entries.clear();
+  index.clear();
+  hits = 0;
+  misses = 0;
+}
+
+void ClearanceCache::BuildKey(const ob::State *state, std::string &key) const
+{
+  thread_local std::vector<double> reals;
+  space->copyToReals(reals, state);
+  key.resize(reals.size()*sizeof(long));
+  for(uint k = 0; k < reals.size(); k++){
+    long cell = std::floor(reals.at(k)/resolution);
+    std::memcpy(&key[k*sizeof(long)], &cell, sizeof(long));
+  }
+}
+
+bool ClearanceCache::Lookup(const ob::State *state, double &dist) const
+{
+  thread_local std::string key;
+  BuildKey(state, key);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = index.find(key);
+  if(it != index.end()){
+    const Entry &entry = *it->second;
+    double error = lipschitz*space->distance(state, entry.state);
+    if(error <= maxError){
+      dist = std::max(0.0, entry.dist - error);
+      entries.splice(entries.begin(), entries, it->second);
+      hits++;
+      return true;
+    }
+  }
+  misses++;
+  return false;
+}
+
+void ClearanceCache::Insert(const ob::State *state, double dist) const
+{
+  if(maxEntries == 0) return;
+  thread_local std::string key;
+  BuildKey(state, key);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  //the newest exact query replaces the state of its cell, such that the cell
+  //follows the region which is currently queried
+  auto it = index.find(key);
+  if(it != index.end()){
+    Entry &entry = *it->second;
+    space->copyState(entry.state, state);
+    entry.dist = dist;
+    entries.splice(entries.begin(), entries, it->second);
+    return;
+  }
+
+  while(!entries.empty() && entries.size() >= maxEntries){
+    Entry &last = entries.back();
+    space->freeState(last.state);
+    index.erase(last.key);
+    entries.pop_back();
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.state = space->allocState();
+  space->copyState(entry.state, state);
+  entry.dist = dist;
+  entries.push_front(entry);
+  index[key] = entries.begin();
+}
+
+unsigned long ClearanceCache::GetNumberOfHits() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
+unsigned long ClearanceCache::GetNumberOfMisses() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return misses;
+}
+uint ClearanceCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+void ClearanceCache::Print(std::ostream& out) const
+{
+  unsigned long h = GetNumberOfHits();
+  unsigned long m = GetNumberOfMisses();
+  out << "ClearanceCache: " << GetNumberOfEntries() << " entries (resolution " << resolution
+    << ", lipschitz " << lipschitz << ", max error " << maxError << ")"
+    << ", hits " << h << ", misses " << m
+    << ", hit rate " << (h+m > 0 ? 100.0*h/(h+m) : 0) << "%";
+}
+
+std::ostream& operator<< (std::ostream& out, const ClearanceCache& cache)
+{
+  cache.Print(out);
+  return out;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <ompl/base/StateSpace.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ob = ompl::base;
+
+//ClearanceCache: memoizes clearance queries (workspace distance of the robot
+//to the environment). Configurations are quantized into cells of the given
+//resolution, and each cell keeps the last exactly computed state and its
+//distance d0. A query in the same cell returns the conservative lower bound
+//
+//  d0 - L*dist(state, cached state)
+//
+//where L is the Lipschitz constant of the clearance w.r.t. the cspace metric
+//(workspace displacement per unit cspace distance, see Neighborhood). The
+//lookup misses if L*dist exceeds the maximum error. Cells are kept in a
+//least-recently-used list bounded by the number of entries.
+class ClearanceCache
+{
+  public:
+    ClearanceCache(const ob::StateSpacePtr &space, double resolution,
+        double lipschitz, double maxError, uint maxEntries = 100000);
+    ~ClearanceCache();
+
+    //true on a hit, then dist is a lower bound on the clearance of state
+    bool Lookup(const ob::State *state, double &dist) const;
+    void Insert(const ob::State *state, double dist) const;
+
+    //removes all entries and resets statistics
+    void Clear();
+
+    unsigned long GetNumberOfHits() const;
+    unsigned long GetNumberOfMisses() const;
+    uint GetNumberOfEntries() const;
+
+    void Print(std::ostream& out) const;
+    friend std::ostream& operator<< (std::ostream& out, const ClearanceCache& cache);
+
+  private:
+    struct Entry
+    {
+      std::string key;
+      ob::State *state;
+      double dist;
+    };
+    void BuildKey(const ob::State *state, std::string &key) const;
+
+    ob::StateSpacePtr space;
+    double resolution;
+    double lipschitz;
+    double maxError;
+    uint maxEntries;
+
+    mutable std::mutex mutex;
+    //most recently used entry first
+    mutable std::list<Entry> entries;
+    mutable std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+    mutable unsigned long hits{0};
+    mutable unsigned long misses{0};
+};
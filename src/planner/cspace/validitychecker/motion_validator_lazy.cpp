@@ -0,0 +1,111 @@
+#include "planner/cspace/validitychecker/motion_validator_lazy.h"
+
+LazyMotionValidator::LazyMotionValidator(const ob::SpaceInformationPtr &si):
+  OMPLMotionValidator(si)
+{
+}
+
+LazyMotionValidator::LazyMotionValidator(ob::SpaceInformation *si):
+  OMPLMotionValidator(si)
+{
+}
+
+void LazyMotionValidator::BuildKey(const ob::State *s1, const ob::State *s2, std::string &key) const
+{
+  thread_local std::string k1, k2;
+  const ob::StateSpacePtr &space = si_->getStateSpace();
+  uint N = space->getSerializationLength();
+  k1.resize(N);
+  k2.resize(N);
+  space->serialize(&k1[0], s1);
+  space->serialize(&k2[0], s2);
+  if(k2 < k1) k1.swap(k2);
+  key = k1;
+  key += k2;
+}
+
+bool LazyMotionValidator::Lookup(const std::string &key, bool &valid) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = edges.find(key);
+  if(it == edges.end()) return false;
+  valid = it->second;
+  hits++;
+  return true;
+}
+
+bool LazyMotionValidator::checkMotion(const ob::State *s1, const ob::State *s2) const
+{
+  thread_local std::string key;
+  BuildKey(s1, s2, key);
+  bool valid = false;
+  if(Lookup(key, valid)) return valid;
+
+  if(!si_->isValid(s2)) return false;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  deferred++;
+  return true;
+}
+
+bool LazyMotionValidator::ValidateEdge(const ob::State *s1, const ob::State *s2) const
+{
+  thread_local std::string key;
+  BuildKey(s1, s2, key);
+  bool valid = false;
+  if(Lookup(key, valid)) return valid;
+
+  valid = OMPLMotionValidator::checkMotion(s1, s2);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  validated++;
+  if(!valid) invalid++;
+  edges[key] = valid;
+  return valid;
+}
+
+void LazyMotionValidator::Clear()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  edges.clear();
+  deferred = 0;
+  validated = 0;
+  invalid = 0;
+  hits = 0;
+}
+
+unsigned long LazyMotionValidator::GetNumberOfDeferredChecks() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return deferred;
+}
+unsigned long LazyMotionValidator::GetNumberOfValidatedEdges() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return validated;
+}
+unsigned long LazyMotionValidator::GetNumberOfInvalidEdges() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return invalid;
+}
+unsigned long LazyMotionValidator::GetNumberOfCacheHits() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return hits;
+}
+
+void LazyMotionValidator::Print(std::ostream& out) const
+{
+  unsigned long d = GetNumberOfDeferredChecks();
+  unsigned long v = GetNumberOfValidatedEdges();
+  out << "LazyMotionValidator: " << d << " motions accepted lazily, " << v << " edges validated ("
+    << GetNumberOfInvalidEdges() << " invalid), " << (d > v ? d - v : 0) << " motion checks avoided"
+    << ", cache hits " << GetNumberOfCacheHits();
+}
+
+std::ostream& operator<< (std::ostream& out, const LazyMotionValidator& validator)
+{
+  validator.Print(out);
+  return out;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "planner/cspace/validitychecker/motion_validator_ompl.h"
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//LazyMotionValidator: motion validator for lazy roadmap planning. A motion is
+//accepted optimistically if its end state is valid, without checking the
+//interpolated states. Edges are validated (ValidateEdge) only once they lie
+//on a candidate solution path. The result is cached per edge, so each edge
+//is validated at most once, and checkMotion returns the cached result for
+//edges which have been validated before.
+//
+//checkMotion with last valid state (used by tree planners to extend towards a
+//state) is always eager.
+class LazyMotionValidator: public OMPLMotionValidator
+{
+  public:
+    LazyMotionValidator(const ob::SpaceInformationPtr &si);
+    LazyMotionValidator(ob::SpaceInformation *si);
+
+    using OMPLMotionValidator::checkMotion;
+    bool checkMotion(const ob::State *s1, const ob::State *s2) const override;
+
+    //full check of the motion between s1 and s2 (cached)
+    bool ValidateEdge(const ob::State *s1, const ob::State *s2) const;
+
+    //removes all cached edges and resets statistics
+    void Clear();
+
+    //motions accepted without checking the interpolated states
+    unsigned long GetNumberOfDeferredChecks() const;
+    unsigned long GetNumberOfValidatedEdges() const;
+    unsigned long GetNumberOfInvalidEdges() const;
+    unsigned long GetNumberOfCacheHits() const;
+
+    void Print(std::ostream& out) const;
+    friend std::ostream& operator<< (std::ostream& out, const LazyMotionValidator& validator);
+
+  private:
+    //undirected: key of (s1,s2) equals key of (s2,s1)
+    void BuildKey(const ob::State *s1, const ob::State *s2, std::string &key) const;
+    bool Lookup(const std::string &key, bool &valid) const;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<std::string, bool> edges;
+
+    mutable unsigned long deferred{0};
+    mutable unsigned long validated{0};
+    mutable unsigned long invalid{0};
+    mutable unsigned long hits{0};
+};
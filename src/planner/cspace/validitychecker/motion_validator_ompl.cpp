@@ -0,0 +1,183 @@
+#include "planner/cspace/validitychecker/motion_validator_ompl.h"
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include <algorithm>
+#include <atomic>
+#include <queue>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace{
+  //thread-private interpolation buffer of a motion validator. Holds the state
+  //space, such that states can be freed even if the space information has
+  //been deleted before the thread exits.
+  struct StateBlock
+  {
+    ob::StateSpacePtr space;
+    std::vector<ob::State*> states;
+    std::vector<const ob::State*> ordered;
+    //bisection order of the intermediate states 1..nd-1
+    std::vector<uint> order;
+    uint ndOrder{0};
+
+    ~StateBlock()
+    {
+      for(uint k = 0; k < states.size(); k++){
+        space->freeState(states.at(k));
+      }
+    }
+    void Reserve(uint K)
+    {
+      while(states.size() < K) states.push_back(space->allocState());
+      if(ordered.size() < K) ordered.resize(K);
+    }
+    void ComputeOrder(uint nd)
+    {
+      if(ndOrder == nd) return;
+      ndOrder = nd;
+      order.clear();
+      if(nd < 2) return;
+      std::queue<std::pair<uint, uint>> intervals;
+      intervals.push(std::make_pair(1, nd - 1));
+      while(!intervals.empty()){
+        std::pair<uint, uint> x = intervals.front();
+        intervals.pop();
+        uint mid = (x.first + x.second) / 2;
+        order.push_back(mid);
+        if(x.first < mid) intervals.push(std::make_pair(x.first, mid - 1));
+        if(x.second > mid) intervals.push(std::make_pair(mid + 1, x.second));
+      }
+    }
+  };
+
+  std::atomic<unsigned long> validatorCounter{0};
+
+  //ids of validators which have not been destroyed yet
+  std::mutex liveMutex;
+  std::unordered_set<unsigned long> liveValidators;
+
+  std::unordered_map<unsigned long, StateBlock>& GetStateBlocks()
+  {
+    thread_local std::unordered_map<unsigned long, StateBlock> blocks;
+    return blocks;
+  }
+
+  StateBlock& GetStateBlock(unsigned long id, const ob::StateSpacePtr &space)
+  {
+    std::unordered_map<unsigned long, StateBlock> &blocks = GetStateBlocks();
+    auto it = blocks.find(id);
+    if(it != blocks.end()) return it->second;
+
+    //new block: evict the blocks of this thread whose validator has been
+    //destroyed (by another thread)
+    {
+      std::lock_guard<std::mutex> lock(liveMutex);
+      for(auto jt = blocks.begin(); jt != blocks.end();){
+        if(liveValidators.count(jt->first) == 0) jt = blocks.erase(jt);
+        else jt++;
+      }
+    }
+    StateBlock &block = blocks[id];
+    block.space = space;
+    return block;
+  }
+}
+
+OMPLMotionValidator::OMPLMotionValidator(const ob::SpaceInformationPtr &si):
+  ob::MotionValidator(si), id(++validatorCounter)
+{
+  std::lock_guard<std::mutex> lock(liveMutex);
+  liveValidators.insert(id);
+}
+
+OMPLMotionValidator::OMPLMotionValidator(ob::SpaceInformation *si):
+  ob::MotionValidator(si), id(++validatorCounter)
+{
+  std::lock_guard<std::mutex> lock(liveMutex);
+  liveValidators.insert(id);
+}
+
+OMPLMotionValidator::~OMPLMotionValidator()
+{
+  {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    liveValidators.erase(id);
+  }
+  GetStateBlocks().erase(id);
+}
+
+uint OMPLMotionValidator::CheckStates(const ob::State* const* states, uint K) const
+{
+  const OMPLValidityChecker *checker =
+    dynamic_cast<const OMPLValidityChecker*>(si_->getStateValidityChecker().get());
+  if(checker != nullptr){
+    return checker->FirstInvalid(states, K);
+  }
+  for(uint k = 0; k < K; k++){
+    if(!si_->isValid(states[k])) return k;
+  }
+  return K;
+}
+
+bool OMPLMotionValidator::checkMotion(const ob::State *s1, const ob::State *s2) const
+{
+  //end state first (as ob::DiscreteMotionValidator), before any states are
+  //interpolated
+  if(CheckStates(&s2, 1) == 0){
+    invalid_++;
+    return false;
+  }
+
+  const ob::StateSpacePtr &space = si_->getStateSpace();
+  uint nd = space->validSegmentCount(s1, s2);
+
+  StateBlock &block = GetStateBlock(id, space);
+  block.Reserve(std::max(nd, 1u));
+  block.ComputeOrder(nd);
+
+  //intermediate states in bisection order
+  for(uint k = 0; k < block.order.size(); k++){
+    ob::State *x = block.states.at(k);
+    space->interpolate(s1, s2, (double)block.order.at(k) / (double)nd, x);
+    block.ordered.at(k) = x;
+  }
+  uint K = block.order.size();
+
+  bool result = (CheckStates(block.ordered.data(), K) == K);
+  if(result) valid_++;
+  else invalid_++;
+  return result;
+}
+
+bool OMPLMotionValidator::checkMotion(const ob::State *s1, const ob::State *s2,
+    std::pair<ob::State*, double> &lastValid) const
+{
+  const ob::StateSpacePtr &space = si_->getStateSpace();
+  uint nd = space->validSegmentCount(s1, s2);
+
+  uint K = std::max(nd, 1u);
+  StateBlock &block = GetStateBlock(id, space);
+  block.Reserve(K);
+
+  //intermediate states in order from s1 to s2, then s2
+  for(uint j = 1; j < nd; j++){
+    ob::State *x = block.states.at(j - 1);
+    space->interpolate(s1, s2, (double)j / (double)nd, x);
+    block.ordered.at(j - 1) = x;
+  }
+  block.ordered.at(K - 1) = s2;
+
+  uint j = CheckStates(block.ordered.data(), K);
+  bool result = (j == K);
+  if(!result){
+    //state j+1 along the motion is invalid
+    lastValid.second = (double)j / (double)nd;
+    if(lastValid.first != nullptr){
+      space->interpolate(s1, s2, lastValid.second, lastValid.first);
+    }
+    invalid_++;
+  }else{
+    valid_++;
+  }
+  return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <ompl/base/MotionValidator.h>
+#include <ompl/base/SpaceInformation.h>
+
+namespace ob = ompl::base;
+
+//OMPLMotionValidator: discrete motion validation (same resolution and order
+//as ob::DiscreteMotionValidator), but all interpolated states of a motion are
+//computed into a thread-private block first and checked in one batch by
+//OMPLValidityChecker::FirstInvalid (falls back to isValid for other
+//validity checkers).
+class OMPLMotionValidator: public ob::MotionValidator
+{
+  public:
+    OMPLMotionValidator(const ob::SpaceInformationPtr &si);
+    OMPLMotionValidator(ob::SpaceInformation *si);
+    //evicts the interpolation buffer of this thread (buffers of other threads
+    //are evicted when they allocate a new one)
+    ~OMPLMotionValidator() override;
+
+    bool checkMotion(const ob::State *s1, const ob::State *s2) const override;
+    bool checkMotion(const ob::State *s1, const ob::State *s2,
+        std::pair<ob::State*, double> &lastValid) const override;
+
+  private:
+    uint CheckStates(const ob::State* const* states, uint K) const;
+
+    unsigned long id{0};
+};
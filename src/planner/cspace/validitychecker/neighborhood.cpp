@@ -10,6 +10,11 @@ double Neighborhood::WorkspaceDistanceToConfigurationSpaceDistance(double d)
   return this->c*d;
 }
 
+double Neighborhood::ConfigurationSpaceDistanceToWorkspaceDistance(double d)
+{
+  return d/this->c;
+}
+
 // void Neighborhood::SetConfigurationSpaceConstant(double c_)
 // {
 //   this->c = c_;
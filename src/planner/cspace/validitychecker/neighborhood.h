@@ -16,6 +16,9 @@ struct Neighborhood
     Neighborhood() = delete;
     Neighborhood(double);
     double WorkspaceDistanceToConfigurationSpaceDistance(double d);
+    //inverse: bound on the workspace displacement of the robot if it moves
+    //by d in configuration space (Lipschitz constant 1/c)
+    double ConfigurationSpaceDistanceToWorkspaceDistance(double d);
 
   private:
     double c{1.0};
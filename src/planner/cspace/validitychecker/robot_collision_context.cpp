@@ -0,0 +1,365 @@
+#include "planner/cspace/validitychecker/robot_collision_context.h"
+#include <algorithm>
+#include <unordered_map>
+
+//distance from point to axis-aligned box (zero if inside)
+static double DistancePointToAABB(const Vector3 &p, const AABB3D &bb)
+{
+  double d2 = 0;
+  for(int k = 0; k < 3; k++){
+    double dk = 0;
+    if(p[k] < bb.bmin[k]) dk = bb.bmin[k] - p[k];
+    else if(p[k] > bb.bmax[k]) dk = p[k] - bb.bmax[k];
+    d2 += dk*dk;
+  }
+  return sqrt(d2);
+}
+
+//bound on the displacement of any point within radius of center (link frame)
+//if the link moves from T0 to T1
+static double DisplacementBound(const RigidTransform &T0, const RigidTransform &T1,
+    const Vector3 &center, double radius)
+{
+  //||R1-R0||_F bounds the spectral norm
+  double dR2 = 0;
+  for(int i = 0; i < 3; i++){
+    for(int j = 0; j < 3; j++){
+      double dij = T1.R(i,j) - T0.R(i,j);
+      dR2 += dij*dij;
+    }
+  }
+  return (T1*center - T0*center).norm() + radius*sqrt(dR2);
+}
+
+static bool IsSameTransform(const RigidTransform &T0, const RigidTransform &T1)
+{
+  for(int i = 0; i < 3; i++){
+    if(T0.t[i] != T1.t[i]) return false;
+    for(int j = 0; j < 3; j++){
+      if(T0.R(i,j) != T1.R(i,j)) return false;
+    }
+  }
+  return true;
+}
+
+//############################################################################
+//RobotCollisionCandidates
+//############################################################################
+RobotCollisionCandidates::RobotCollisionCandidates(SingleRobotCSpace *space)
+{
+  Robot *robot = space->GetRobot();
+  RobotWorld &world = space->world;
+  WorldPlannerSettings *settings = space->settings;
+
+  Nterrains = world.terrains.size();
+  NrigidObjects = world.rigidObjects.size();
+
+  //bounding spheres of links in their local frame
+  RigidTransform identity;
+  identity.setIdentity();
+  uint Nlinks = robot->links.size();
+  for(uint i = 0; i < Nlinks; i++){
+    Vector3 center(0.0);
+    double radius = 0;
+    if(!robot->geometry[i].Empty()){
+      Geometry3D local(*robot->geometry[i]);
+      local.SetTransform(identity);
+      AABB3D bb = local.GetAABB();
+      center = 0.5*(bb.bmin + bb.bmax);
+      radius = 0.5*(bb.bmax - bb.bmin).norm() + local.margin;
+    }
+    linkCenters.push_back(center);
+    linkRadii.push_back(radius);
+  }
+
+  //self-collision candidates
+  for(uint i = 0; i < Nlinks; i++){
+    if(robot->geometry[i].Empty()) continue;
+    int idi = world.RobotLinkID(space->index, i);
+    for(uint j = i+1; j < Nlinks; j++){
+      if(robot->geometry[j].Empty()) continue;
+      int idj = world.RobotLinkID(space->index, j);
+      if(settings->collisionEnabled(idi, idj) || settings->collisionEnabled(idj, idi)){
+        selfCollisionPairs.push_back(std::make_pair(i, j));
+      }
+    }
+  }
+
+  //environment candidates (terrains and rigid objects, other robots are
+  //ignored because the quotient-space hierarchy stacks several nested robots)
+  std::vector<int> environmentIds;
+  for(uint k = 0; k < Nterrains; k++){
+    if(world.terrains[k]->geometry.Empty()) continue;
+    environment.push_back(&*world.terrains[k]->geometry);
+    environmentIds.push_back(world.TerrainID(k));
+  }
+  for(uint k = 0; k < NrigidObjects; k++){
+    if(world.rigidObjects[k]->geometry.Empty()) continue;
+    environment.push_back(&*world.rigidObjects[k]->geometry);
+    environmentIds.push_back(world.RigidObjectID(k));
+  }
+  for(uint k = 0; k < environment.size(); k++){
+    AABB3D bb = environment.at(k)->GetAABB();
+    Vector3 margin(environment.at(k)->margin);
+    bb.bmin -= margin;
+    bb.bmax += margin;
+    environmentBounds.push_back(bb);
+    environmentTransforms.push_back(environment.at(k)->GetTransform());
+  }
+
+  for(uint i = 0; i < Nlinks; i++){
+    if(robot->geometry[i].Empty()) continue;
+    int idi = world.RobotLinkID(space->index, i);
+    for(uint k = 0; k < environment.size(); k++){
+      int idk = environmentIds.at(k);
+      if(settings->collisionEnabled(idi, idk) || settings->collisionEnabled(idk, idi)){
+        environmentPairs.push_back(std::make_pair(i, k));
+      }
+    }
+  }
+}
+
+bool RobotCollisionCandidates::IsOutdated(const RobotWorld &world) const
+{
+  if((world.terrains.size() != Nterrains) || (world.rigidObjects.size() != NrigidObjects)) return true;
+  //moved objects invalidate their bounds
+  for(uint k = 0; k < environment.size(); k++){
+    if(!IsSameTransform(environment.at(k)->GetTransform(), environmentTransforms.at(k))) return true;
+  }
+  return false;
+}
+
+//############################################################################
+//RobotCollisionContext
+//############################################################################
+RobotCollisionContext::RobotCollisionContext(SingleRobotCSpace *space_):
+  space(space_), kinematics(*space_->GetRobot())
+{
+  Robot *robot = space->GetRobot();
+
+  //copy link geometries. Collision meshes share their (read-only) bounding
+  //volume hierarchy, but each copy has its own transform.
+  uint Nlinks = robot->links.size();
+  for(uint i = 0; i < Nlinks; i++){
+    if(robot->geometry[i].Empty()){
+      links.push_back(nullptr);
+    }else{
+      links.push_back(std::unique_ptr<Geometry3D>(new Geometry3D(*robot->geometry[i])));
+    }
+  }
+  linkCentersWorld.resize(Nlinks);
+}
+
+RobotKinematics3D& RobotCollisionContext::GetKinematics()
+{
+  return kinematics;
+}
+
+Config& RobotCollisionContext::GetConfigBuffer()
+{
+  return qBuffer;
+}
+
+std::vector<Config>& RobotCollisionContext::GetConfigBlock(uint K)
+{
+  if(qBlock.size() < K) qBlock.resize(K);
+  return qBlock;
+}
+
+void RobotCollisionContext::SetCandidates(RobotCollisionCandidatesPtr candidates_, unsigned long generation_)
+{
+  candidates = candidates_;
+  generation = generation_;
+  ClearDistanceCache();
+}
+
+void RobotCollisionContext::ClearDistanceCache()
+{
+  distanceCache.clear();
+}
+
+unsigned long RobotCollisionContext::GetGeneration() const
+{
+  return generation;
+}
+
+bool RobotCollisionContext::IsOutdated() const
+{
+  return candidates->IsOutdated(space->world);
+}
+
+void RobotCollisionContext::UpdateConfig(const Config &q)
+{
+  kinematics.UpdateConfig(q);
+  for(uint i = 0; i < links.size(); i++){
+    if(!links.at(i)) continue;
+    const RigidTransform &T = kinematics.links[i].T_World;
+    links.at(i)->SetTransform(T);
+    linkCentersWorld.at(i) = T*candidates->linkCenters.at(i);
+  }
+}
+
+bool RobotCollisionContext::IsCollisionFree()
+{
+  const std::vector<double> &radii = candidates->linkRadii;
+
+  //selfcollision checking
+  for(uint k = 0; k < candidates->selfCollisionPairs.size(); k++){
+    const std::pair<int,int> &p = candidates->selfCollisionPairs.at(k);
+    double dc = (linkCentersWorld.at(p.first) - linkCentersWorld.at(p.second)).norm();
+    if(dc > radii.at(p.first) + radii.at(p.second)) continue;
+
+    Geometry::AnyCollisionQuery query(*links.at(p.first), *links.at(p.second));
+    if(query.Collide()) return false;
+  }
+  //environment collision checking
+  for(uint k = 0; k < candidates->environmentPairs.size(); k++){
+    const std::pair<int,int> &p = candidates->environmentPairs.at(k);
+    double dc = DistancePointToAABB(linkCentersWorld.at(p.first), candidates->environmentBounds.at(p.second));
+    if(dc > radii.at(p.first)) continue;
+
+    Geometry::AnyCollisionQuery query(*links.at(p.first), *candidates->environment.at(p.second));
+    if(query.Collide()) return false;
+  }
+  return true;
+}
+
+double RobotCollisionContext::DistanceLowerBound()
+{
+  const std::vector<double> &radii = candidates->linkRadii;
+
+  double dmin = dInf;
+  for(uint k = 0; k < candidates->environmentPairs.size(); k++){
+    const std::pair<int,int> &p = candidates->environmentPairs.at(k);
+    //lower bound from bounding volumes. Skip pair if it cannot improve dmin.
+    double dc = DistancePointToAABB(linkCentersWorld.at(p.first), candidates->environmentBounds.at(p.second));
+    if(dc - radii.at(p.first) >= dmin) continue;
+
+    Geometry::AnyCollisionQuery query(*links.at(p.first), *candidates->environment.at(p.second));
+    double d = query.Distance(0, 0, dmin);
+    if(d < dmin) dmin = d;
+  }
+  return dmin;
+}
+
+double RobotCollisionContext::DistanceLowerBoundCached()
+{
+  const std::vector<std::pair<int,int>> &pairs = candidates->environmentPairs;
+  const std::vector<double> &radii = candidates->linkRadii;
+  if(distanceCache.size() != pairs.size()){
+    distanceCache.assign(pairs.size(), DistanceCacheEntry());
+  }
+
+  //witness points are points on link and environment, their distance is an
+  //upper bound on the minimum distance
+  double dmin = dInf;
+  for(uint k = 0; k < pairs.size(); k++){
+    const DistanceCacheEntry &c = distanceCache.at(k);
+    if(!c.hasWitness) continue;
+    const std::pair<int,int> &p = pairs.at(k);
+    const Vector3 w = kinematics.links[p.first].T_World*c.witnessLink;
+    double d = (w - c.witnessEnvironment).norm()
+      - links.at(p.first)->margin - candidates->environment.at(p.second)->margin;
+    if(d < dmin) dmin = d;
+  }
+
+  //each pair is either queried or has a lower bound above the current dmin,
+  //such that the result is the minimum distance (as in DistanceLowerBound)
+  for(uint k = 0; k < pairs.size(); k++){
+    const std::pair<int,int> &p = pairs.at(k);
+    DistanceCacheEntry &c = distanceCache.at(k);
+    const RigidTransform &T = kinematics.links[p.first].T_World;
+
+    double dlower = DistancePointToAABB(linkCentersWorld.at(p.first), candidates->environmentBounds.at(p.second)) - radii.at(p.first);
+    if(c.hasLowerBound){
+      double dcache = c.lowerBound - DisplacementBound(c.T, T, candidates->linkCenters.at(p.first), radii.at(p.first));
+      if(dcache > dlower) dlower = dcache;
+    }
+    if(dlower >= dmin) continue;
+
+    Geometry3D *environment = candidates->environment.at(p.second);
+    Geometry::AnyCollisionQuery query(*links.at(p.first), *environment);
+    double d = query.Distance(0, 0, dmin);
+
+    //a bounded query only guarantees d >= dmin if it terminated early
+    c.lowerBound = std::min(d, dmin);
+    c.T = T;
+    c.hasLowerBound = true;
+
+    if(d < dmin){
+      dmin = d;
+      std::vector<Vector3> vp1, vp2;
+      query.InteractingPoints(vp1, vp2);
+      if(vp1.empty() || vp2.empty()) continue;
+      //closest points are given in the frames of the geometries. Keep them
+      //only if they reproduce the distance, otherwise the upper bound would
+      //be wrong.
+      Vector3 w1 = T*vp1.front();
+      Vector3 w2 = environment->GetTransform()*vp2.front();
+      double dw = (w1 - w2).norm() - links.at(p.first)->margin - environment->margin;
+      if(fabs(dw - d) <= 1e-6 + 1e-3*fabs(d)){
+        c.witnessLink = vp1.front();
+        c.witnessEnvironment = w2;
+        c.hasWitness = true;
+      }
+    }
+  }
+  return dmin;
+}
+
+//############################################################################
+//RobotCollisionContextPool
+//############################################################################
+static std::atomic<unsigned long> poolCounter{0};
+
+RobotCollisionContextPool::RobotCollisionContextPool(SingleRobotCSpace *space_):
+  space(space_), id(++poolCounter)
+{
+  candidates = std::make_shared<RobotCollisionCandidates>(space);
+}
+
+RobotCollisionContext* RobotCollisionContextPool::Get()
+{
+  //pools are identified by a unique id instead of their address, such that a
+  //pool allocated at the address of a deleted one does not pick up stale
+  //contexts.
+  thread_local std::unordered_map<unsigned long, RobotCollisionContext*> threadContexts;
+
+  RobotCollisionContext *context = nullptr;
+  auto it = threadContexts.find(id);
+  if(it != threadContexts.end()){
+    context = it->second;
+    if(context->GetGeneration() == generation && !context->IsOutdated()) return context;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if(candidates->IsOutdated(space->world)){
+    candidates = std::make_shared<RobotCollisionCandidates>(space);
+    generation++;
+  }
+  if(context == nullptr){
+    contexts.push_back(std::unique_ptr<RobotCollisionContext>(new RobotCollisionContext(space)));
+    context = contexts.back().get();
+    threadContexts[id] = context;
+  }
+  context->SetCandidates(candidates, generation);
+  return context;
+}
+
+void RobotCollisionContextPool::Invalidate()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  candidates = std::make_shared<RobotCollisionCandidates>(space);
+  generation++;
+}
+
+SingleRobotCSpace* RobotCollisionContextPool::GetSpace() const
+{
+  return space;
+}
+
+uint RobotCollisionContextPool::NumberOfContexts()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return contexts.size();
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "klampt.h"
+#include <Planning/RobotCSpace.h>
+#include <KrisLibrary/geometry/AnyGeometry.h>
+#include <KrisLibrary/math3d/AABB3D.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//RobotCollisionCandidates: all pairs (link, link) and (link, environment
+//object) which are enabled in the WorldPlannerSettings. Computed once per
+//robot and world, and shared by all threads. Each link is bounded by a sphere
+//in its local frame and each environment object by its world AABB, such that
+//pairs which are far apart can be discarded before the narrowphase.
+struct RobotCollisionCandidates
+{
+  typedef Geometry::AnyCollisionGeometry3D Geometry3D;
+
+  RobotCollisionCandidates(SingleRobotCSpace *space);
+
+  //true if terrains or rigid objects have been added/removed or moved since
+  //the candidates have been computed
+  bool IsOutdated(const RobotWorld &world) const;
+
+  std::vector<std::pair<int,int>> selfCollisionPairs;
+  //link index and index into environment
+  std::vector<std::pair<int,int>> environmentPairs;
+
+  std::vector<Geometry3D*> environment;
+  std::vector<AABB3D> environmentBounds;
+  //transforms of environment at the time environmentBounds were computed
+  std::vector<RigidTransform> environmentTransforms;
+
+  std::vector<Vector3> linkCenters;
+  std::vector<double> linkRadii;
+
+  uint Nterrains{0};
+  uint NrigidObjects{0};
+};
+typedef std::shared_ptr<const RobotCollisionCandidates> RobotCollisionCandidatesPtr;
+
+//RobotCollisionContext: Thread-private copy of the kinematic chain and the
+//link geometries of a robot. Updating the configuration only touches the copy,
+//such that several threads can check states at the same time. The environment
+//(terrains, rigid objects) is static during planning and is shared read-only.
+class RobotCollisionContext
+{
+  public:
+    RobotCollisionContext(SingleRobotCSpace *space);
+
+    void UpdateConfig(const Config &q);
+
+    bool IsCollisionFree();
+    double DistanceLowerBound();
+    //same result as DistanceLowerBound, but reuses the queries of the previous
+    //call on this context (see DistanceCacheEntry). Cheap if consecutive
+    //configurations are close to each other.
+    double DistanceLowerBoundCached();
+    void ClearDistanceCache();
+
+    RobotKinematics3D& GetKinematics();
+    //thread-private buffer for OMPL state to config conversions
+    Config& GetConfigBuffer();
+    //thread-private buffer of at least K configs (for batch conversions)
+    std::vector<Config>& GetConfigBlock(uint K);
+
+    void SetCandidates(RobotCollisionCandidatesPtr candidates, unsigned long generation);
+    unsigned long GetGeneration() const;
+    bool IsOutdated() const;
+
+  protected:
+    typedef Geometry::AnyCollisionGeometry3D Geometry3D;
+
+    SingleRobotCSpace *space{nullptr};
+
+    RobotKinematics3D kinematics;
+    std::vector<std::unique_ptr<Geometry3D>> links;
+    //bounding sphere centers in world coordinates (at last UpdateConfig)
+    std::vector<Vector3> linkCentersWorld;
+
+    Config qBuffer;
+    std::vector<Config> qBlock;
+
+    //per environment pair: a lower bound on the distance while the link was
+    //at transform T (it decreases at most by the displacement of the link
+    //since then), and the closest points of the last exact query (link frame
+    //and world frame), whose distance bounds the pair distance from above for
+    //any configuration.
+    struct DistanceCacheEntry
+    {
+      bool hasLowerBound{false};
+      double lowerBound{0};
+      RigidTransform T;
+      bool hasWitness{false};
+      Vector3 witnessLink;
+      Vector3 witnessEnvironment;
+    };
+    std::vector<DistanceCacheEntry> distanceCache;
+
+    RobotCollisionCandidatesPtr candidates;
+    unsigned long generation{0};
+};
+
+//RobotCollisionContextPool: hands out one RobotCollisionContext per calling
+//thread. Lookup after the first call of a thread is lock-free.
+class RobotCollisionContextPool
+{
+  public:
+    RobotCollisionContextPool(SingleRobotCSpace *space);
+
+    RobotCollisionContext* Get();
+    SingleRobotCSpace* GetSpace() const;
+    uint NumberOfContexts();
+
+    //recompute collision candidates (call after the world changed)
+    void Invalidate();
+
+  private:
+    SingleRobotCSpace *space{nullptr};
+    unsigned long id{0};
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<RobotCollisionContext>> contexts;
+
+    RobotCollisionCandidatesPtr candidates;
+    std::atomic<unsigned long> generation{1};
+};
+typedef std::shared_ptr<RobotCollisionContextPool> RobotCollisionContextPoolPtr;
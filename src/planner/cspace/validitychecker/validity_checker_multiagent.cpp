@@ -2,6 +2,36 @@
 #include "common.h"
 #include <ompl/base/StateSpaceTypes.h>
 
+static bool Overlap(const AABB3D &a, const AABB3D &b)
+{
+  for(int k = 0; k < 3; k++){
+    if(a.bmax[k] < b.bmin[k] || b.bmax[k] < a.bmin[k]) return false;
+  }
+  return true;
+}
+
+static bool IsSameTransform(const RigidTransform &T0, const RigidTransform &T1)
+{
+  for(int i = 0; i < 3; i++){
+    if(T0.t[i] != T1.t[i]) return false;
+    for(int j = 0; j < 3; j++){
+      if(T0.R(i,j) != T1.R(i,j)) return false;
+    }
+  }
+  return true;
+}
+
+//distance between axis-aligned boxes (zero if overlapping)
+static double Distance(const AABB3D &a, const AABB3D &b)
+{
+  double d2 = 0;
+  for(int k = 0; k < 3; k++){
+    double dk = std::max(0.0, std::max(a.bmin[k] - b.bmax[k], b.bmin[k] - a.bmax[k]));
+    d2 += dk*dk;
+  }
+  return sqrt(d2);
+}
+
 OMPLValidityCheckerMultiAgent::OMPLValidityCheckerMultiAgent(const ob::SpaceInformationPtr &si, 
     CSpaceOMPLMultiAgent *cspace, std::vector<CSpaceOMPL*> cspaces):
   ob::StateValidityChecker(si), cspace_(cspace), cspaces_(cspaces)
@@ -11,6 +41,128 @@ OMPLValidityCheckerMultiAgent::OMPLValidityCheckerMultiAgent(const ob::SpaceInfo
     SingleRobotCSpace *kck = static_cast<SingleRobotCSpace*>(cspaces.at(k)->GetCSpaceKlamptPtr());
     klampt_single_robot_cspaces_.push_back(kck);
   }
+
+  std::vector<int> ridxs = cspace_->GetRobotIdxs();
+  RigidTransform identity;
+  identity.setIdentity();
+  for(uint k = 0; k < ridxs.size(); k++)
+  {
+    int rk = ridxs.at(k);
+    if(rk<0) continue;
+    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(k);
+    agents.push_back(k);
+    agentIds.push_back(space->world.RobotID(rk));
+
+    Robot *robot = cspaces_.at(k)->GetRobotPtr();
+    std::vector<Vector3> centers;
+    std::vector<double> radii;
+    for(uint i = 0; i < robot->links.size(); i++){
+      Vector3 center(0.0);
+      double radius = -1;
+      if(!robot->geometry[i].Empty()){
+        Geometry::AnyCollisionGeometry3D local(*robot->geometry[i]);
+        local.SetTransform(identity);
+        AABB3D bb = local.GetAABB();
+        center = 0.5*(bb.bmin + bb.bmax);
+        radius = 0.5*(bb.bmax - bb.bmin).norm() + local.margin;
+      }
+      centers.push_back(center);
+      radii.push_back(radius);
+    }
+    linkCenters.push_back(centers);
+    linkRadii.push_back(radii);
+  }
+  agentBounds.resize(agents.size());
+  for(uint k = 0; k < agents.size(); k++){
+    sweepOrder.push_back(k);
+  }
+}
+
+void OMPLValidityCheckerMultiAgent::UpdateEnvironment() const
+{
+  if(agents.empty()) return;
+  RobotWorld &world = klampt_single_robot_cspaces_.at(agents.front())->world;
+  if(environmentCached && world.terrains.size() == Nterrains
+      && world.rigidObjects.size() == NrigidObjects){
+    bool moved = false;
+    for(uint k = 0; k < environmentGeometries.size() && !moved; k++){
+      moved = !IsSameTransform(environmentGeometries.at(k)->GetTransform(), environmentTransforms.at(k));
+    }
+    if(!moved) return;
+  }
+  environmentCached = true;
+  Nterrains = world.terrains.size();
+  NrigidObjects = world.rigidObjects.size();
+  environmentIds.clear();
+  environmentBounds.clear();
+  environmentGeometries.clear();
+  environmentTransforms.clear();
+
+  auto add = [&](Geometry::AnyCollisionGeometry3D &geometry, int id)
+  {
+    AABB3D bb = geometry.GetAABB();
+    Vector3 margin(geometry.margin);
+    bb.bmin -= margin;
+    bb.bmax += margin;
+    environmentIds.push_back(id);
+    environmentBounds.push_back(bb);
+    environmentGeometries.push_back(&geometry);
+    environmentTransforms.push_back(geometry.GetTransform());
+  };
+  for(uint i = 0; i < Nterrains; i++){
+    if(world.terrains[i]->geometry.Empty()) continue;
+    add(*world.terrains[i]->geometry, world.TerrainID(i));
+  }
+  for(uint i = 0; i < NrigidObjects; i++){
+    if(world.rigidObjects[i]->geometry.Empty()) continue;
+    add(*world.rigidObjects[i]->geometry, world.RigidObjectID(i));
+  }
+}
+
+void OMPLValidityCheckerMultiAgent::UpdateAgentBounds() const
+{
+  for(uint j = 0; j < agents.size(); j++){
+    Robot *robot = cspaces_.at(agents.at(j))->GetRobotPtr();
+    AABB3D &bb = agentBounds.at(j);
+    bb.bmin.set(dInf, dInf, dInf);
+    bb.bmax.set(-dInf, -dInf, -dInf);
+    const std::vector<double> &radii = linkRadii.at(j);
+    for(uint i = 0; i < radii.size(); i++){
+      if(radii.at(i) < 0) continue;
+      Vector3 c = robot->links[i].T_World*linkCenters.at(j).at(i);
+      Vector3 r(radii.at(i));
+      for(int d = 0; d < 3; d++){
+        bb.bmin[d] = std::min(bb.bmin[d], c[d] - r[d]);
+        bb.bmax[d] = std::max(bb.bmax[d], c[d] + r[d]);
+      }
+    }
+  }
+}
+
+void OMPLValidityCheckerMultiAgent::ComputeOverlappingPairs() const
+{
+  //insertion sort by lower x-bound, starting from the order of the last call
+  for(uint i = 1; i < sweepOrder.size(); i++){
+    uint a = sweepOrder.at(i);
+    int j = i - 1;
+    while(j >= 0 && agentBounds.at(sweepOrder.at(j)).bmin[0] > agentBounds.at(a).bmin[0]){
+      sweepOrder.at(j + 1) = sweepOrder.at(j);
+      j--;
+    }
+    sweepOrder.at(j + 1) = a;
+  }
+
+  overlappingPairs.clear();
+  for(uint i = 0; i < sweepOrder.size(); i++){
+    const AABB3D &bi = agentBounds.at(sweepOrder.at(i));
+    for(uint j = i + 1; j < sweepOrder.size(); j++){
+      const AABB3D &bj = agentBounds.at(sweepOrder.at(j));
+      if(bj.bmin[0] > bi.bmax[0]) break;
+      if(Overlap(bi, bj)){
+        overlappingPairs.push_back(std::make_pair(sweepOrder.at(i), sweepOrder.at(j)));
+      }
+    }
+  }
 }
 
 bool OMPLValidityCheckerMultiAgent::isValid(const ob::State* state) const
@@ -20,48 +172,48 @@ bool OMPLValidityCheckerMultiAgent::isValid(const ob::State* state) const
   Config q = cspace_->OMPLStateToConfig(state);
   cspace_->UpdateRobotConfig(q);
 
-  std::vector<int> ridxs = cspace_->GetRobotIdxs();
+  UpdateEnvironment();
+  UpdateAgentBounds();
 
-  for(uint k = 0; k < ridxs.size(); k++)
+  pair<int,int> res;
+  for(uint j = 0; j < agents.size(); j++)
   {
-    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(k);
-
-    int rk = ridxs.at(k);
-    if(rk<0) continue;
-
-    int id = space->world.RobotID(rk);
-    vector<int> idrobot(1, id);
+    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(agents.at(j));
+    vector<int> idrobot(1, agentIds.at(j));
 
-    vector<int> idothers;
-    for(size_t i=0;i<space->world.terrains.size();i++)
-      idothers.push_back(space->world.TerrainID(i));
-    for(size_t i=0;i<space->world.rigidObjects.size();i++)
-      idothers.push_back(space->world.RigidObjectID(i));
+    res = space->settings->CheckCollision(space->world, idrobot);
+    if(res.first >= 0) return false;
 
-    //all remaining robots
-    for(size_t i=k;i<ridxs.size();i++)
-    {
-      int ri = ridxs.at(i);
-      if((ri >= 0))
-      {
-        idothers.push_back(space->world.RobotID(ridxs.at(i)));
+    //environment objects close to agent
+    idBuffer.clear();
+    for(uint i = 0; i < environmentIds.size(); i++){
+      if(Overlap(agentBounds.at(j), environmentBounds.at(i))){
+        idBuffer.push_back(environmentIds.at(i));
       }
     }
+    if(!idBuffer.empty()){
+      res = space->settings->CheckCollision(space->world, idrobot, idBuffer);
+      if(res.first >= 0) return false;
+    }
+  }
 
-    pair<int,int> res;
-    res = space->settings->CheckCollision(space->world, idrobot);
-    if(res.first >= 0) return false;
-    res = space->settings->CheckCollision(space->world, idrobot, idothers);
+  ComputeOverlappingPairs();
+  for(uint k = 0; k < overlappingPairs.size(); k++)
+  {
+    uint a = overlappingPairs.at(k).first;
+    uint b = overlappingPairs.at(k).second;
+    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(agents.at(a));
+    vector<int> ida(1, agentIds.at(a));
+    vector<int> idb(1, agentIds.at(b));
+    res = space->settings->CheckCollision(space->world, ida, idb);
     if(res.first >= 0) return false;
-
   }
   return true;
 }
 
 double OMPLValidityCheckerMultiAgent::clearance(const ob::State* state) const
 {
-  double c = DistanceToConstraints(state);
-  return 1.0/c;
+  return DistanceToConstraints(state);
 }
 
 double OMPLValidityCheckerMultiAgent::DistanceToConstraints(const ob::State* state) const
@@ -69,37 +221,32 @@ double OMPLValidityCheckerMultiAgent::DistanceToConstraints(const ob::State* sta
   Config q = cspace_->OMPLStateToConfig(state);
   cspace_->UpdateRobotConfig(q);
 
-  std::vector<int> ridxs = cspace_->GetRobotIdxs();
+  UpdateEnvironment();
+  UpdateAgentBounds();
 
   double dmin = dInf;
-  for(uint k = 0; k < ridxs.size(); k++)
+  for(uint j = 0; j < agents.size(); j++)
   {
-    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(k);
+    SingleRobotCSpace* space = klampt_single_robot_cspaces_.at(agents.at(j));
+    vector<int> idrobot(1, agentIds.at(j));
 
-    int rk = ridxs.at(k);
-    if(rk<0) continue;
-
-    int id = space->world.RobotID(rk);
-    vector<int> idrobot(1, id);
-
-    vector<int> idothers;
-    for(size_t i=0;i<space->world.terrains.size();i++)
-      idothers.push_back(space->world.TerrainID(i));
-    for(size_t i=0;i<space->world.rigidObjects.size();i++)
-      idothers.push_back(space->world.RigidObjectID(i));
-
-    //all remaining robots
-    for(size_t i=k;i<ridxs.size();i++)
-    {
-        int ri = ridxs.at(i);
-        if((ri >= 0))
-        {
-            idothers.push_back(space->world.RobotID(ridxs.at(i)));
-        }
+    //objects which might be closer than dmin (bounding box distance is a
+    //lower bound), including the agent itself and all remaining agents
+    idBuffer.clear();
+    for(uint i = 0; i < environmentIds.size(); i++){
+      if(Distance(agentBounds.at(j), environmentBounds.at(i)) < dmin){
+        idBuffer.push_back(environmentIds.at(i));
+      }
+    }
+    idBuffer.push_back(agentIds.at(j));
+    for(uint i = j + 1; i < agents.size(); i++){
+      if(Distance(agentBounds.at(j), agentBounds.at(i)) < dmin){
+        idBuffer.push_back(agentIds.at(i));
+      }
     }
 
     int closest1, closest2;
-    double d = space->settings->DistanceLowerBound(space->world, idrobot, idothers, 0, dInf, &closest1, &closest2);
+    double d = space->settings->DistanceLowerBound(space->world, idrobot, idBuffer, 0, dInf, &closest1, &closest2);
 
     if( d < dmin )
     {
@@ -108,4 +255,3 @@ double OMPLValidityCheckerMultiAgent::DistanceToConstraints(const ob::State* sta
   }
   return dmin;
 }
-
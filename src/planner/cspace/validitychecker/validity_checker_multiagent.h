@@ -2,7 +2,17 @@
 #include "planner/cspace/cspace.h"
 #include "planner/cspace/cspace_multiagent.h"
 #include "neighborhood.h"
+#include <KrisLibrary/math3d/AABB3D.h>
 
+//Validity of all agents (self-collision, collision with environment and with
+//other agents). Agents are bounded by axis-aligned boxes (from bounding
+//spheres of their links), and only agent pairs whose boxes overlap are
+//passed to the narrowphase (sweep and prune along x, the sweep order is kept
+//between calls, such that it is almost sorted for nearby states).
+//Ids and bounding boxes of environment objects are cached, and recomputed if
+//objects are added, removed or moved.
+//
+//NOTE: not thread-safe (robots of the world are updated)
 class OMPLValidityCheckerMultiAgent: public ob::StateValidityChecker
 {
   public:
@@ -15,9 +25,37 @@ class OMPLValidityCheckerMultiAgent: public ob::StateValidityChecker
   protected:
     double DistanceToConstraints(const ob::State* state) const;
 
+    //update agent bounding boxes (robots need to be at current config)
+    void UpdateAgentBounds() const;
+    //agent pairs (indices into agents) with overlapping boxes
+    void ComputeOverlappingPairs() const;
+    void UpdateEnvironment() const;
+
     CSpaceOMPLMultiAgent *cspace_;
     std::vector<CSpaceOMPL*> cspaces_;
     std::vector<SingleRobotCSpace*> klampt_single_robot_cspaces_;
+
+    //agents with a robot (index into cspaces_)
+    std::vector<uint> agents;
+    std::vector<int> agentIds;
+    //bounding spheres of links in their local frames
+    std::vector<std::vector<Vector3>> linkCenters;
+    std::vector<std::vector<double>> linkRadii;
+
+    //environment (terrains and rigid objects)
+    mutable std::vector<int> environmentIds;
+    mutable std::vector<AABB3D> environmentBounds;
+    //geometries and their transforms at the time the bounds were computed
+    mutable std::vector<Geometry::AnyCollisionGeometry3D*> environmentGeometries;
+    mutable std::vector<RigidTransform> environmentTransforms;
+    mutable uint Nterrains{0};
+    mutable uint NrigidObjects{0};
+    mutable bool environmentCached{false};
+
+    mutable std::vector<AABB3D> agentBounds;
+    mutable std::vector<uint> sweepOrder;
+    mutable std::vector<std::pair<uint, uint>> overlappingPairs;
+    mutable std::vector<int> idBuffer;
 };
 
 typedef std::shared_ptr<OMPLValidityCheckerMultiAgent> OMPLValidityCheckerMultiAgentPtr;
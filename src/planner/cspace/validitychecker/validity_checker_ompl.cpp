@@ -6,6 +6,7 @@ OMPLValidityChecker::OMPLValidityChecker(const ob::SpaceInformationPtr &si, CSpa
   ob::StateValidityChecker(si), cspace(cspace_)
 {
     klampt_single_robot_cspace = static_cast<SingleRobotCSpace*>(cspace_->GetCSpaceKlamptPtr());
+    contexts = std::make_shared<RobotCollisionContextPool>(klampt_single_robot_cspace);
     specs_.clearanceComputationType = ob::StateValidityCheckerSpecs::BOUNDED_APPROXIMATE;
 }
 
@@ -15,17 +16,98 @@ void OMPLValidityChecker::SetNeighborhood(double cspace_constant)
   neighborhood = new Neighborhood(cspace_constant);
 }
 
+void OMPLValidityChecker::SetClearanceCache(uint size, double resolution, double maxError)
+{
+  if(size == 0){
+    clearanceCache.reset();
+    return;
+  }
+  if(neighborhood == nullptr){
+    std::cout << "[OMPLValidityChecker] clearance cache requires a neighborhood (see SetNeighborhood)." << std::endl;
+    throw "No neighborhood.";
+  }
+  double lipschitz = neighborhood->ConfigurationSpaceDistanceToWorkspaceDistance(1.0);
+  clearanceCache.reset(new ClearanceCache(si_->getStateSpace(), resolution, lipschitz, maxError, size));
+}
+
+ClearanceCache* OMPLValidityChecker::GetClearanceCache() const
+{
+  return clearanceCache.get();
+}
+
 CSpaceOMPL* OMPLValidityChecker::GetCSpaceOMPLPtr() const
 {
   return cspace;
 }
 bool OMPLValidityChecker::isValid(const ob::State* state) const
 {
-  Config q = cspace->OMPLStateToConfig(state);
+  RobotCollisionContext *context = contexts->Get();
+  Config &q = context->GetConfigBuffer();
+  cspace->OMPLStateToConfig(state, q);
   if(cspace->isTimeDependent()){
     cspace->GetTime(state);
   }
-  return IsCollisionFree(klampt_single_robot_cspace, q) && si_->satisfiesBounds(state);
+  context->UpdateConfig(q);
+  return context->IsCollisionFree() && si_->satisfiesBounds(state);
+}
+
+bool OMPLValidityChecker::isValid(const ob::State* state, double &dist) const
+{
+  return IsValidWithClearance(state, dist, false);
+}
+
+bool OMPLValidityChecker::IsValidCached(const ob::State* state, double &dist) const
+{
+  return IsValidWithClearance(state, dist, true);
+}
+
+bool OMPLValidityChecker::IsValidWithClearance(const ob::State* state, double &dist, bool cached) const
+{
+  dist = 0;
+  if(!si_->satisfiesBounds(state)) return false;
+
+  RobotCollisionContext *context = contexts->Get();
+  Config &q = context->GetConfigBuffer();
+  cspace->OMPLStateToConfig(state, q);
+  context->UpdateConfig(q);
+  if(!context->IsCollisionFree()) return false;
+
+  dist = (cached ? context->DistanceLowerBoundCached() : context->DistanceLowerBound());
+  return true;
+}
+
+uint OMPLValidityChecker::FirstInvalid(const ob::State* const* states, uint K) const
+{
+  if(K == 0) return 0;
+  RobotCollisionContext *context = contexts->Get();
+
+  //the first state (the end state of a motion) is checked on its own, such
+  //that the block is only filled if it is valid
+  if(!si_->satisfiesBounds(states[0])) return 0;
+  Config &q = context->GetConfigBuffer();
+  cspace->OMPLStateToConfig(states[0], q);
+  context->UpdateConfig(q);
+  if(!context->IsCollisionFree()) return 0;
+
+  //bounds are cheap, so they are checked for all states before any forward
+  //kinematics or collision checking
+  uint Kbounds = K;
+  for(uint k = 1; k < K; k++){
+    if(!si_->satisfiesBounds(states[k])){
+      Kbounds = k;
+      break;
+    }
+  }
+
+  std::vector<Config> &block = context->GetConfigBlock(Kbounds);
+  for(uint k = 1; k < Kbounds; k++){
+    cspace->OMPLStateToConfig(states[k], block.at(k));
+  }
+  for(uint k = 1; k < Kbounds; k++){
+    context->UpdateConfig(block.at(k));
+    if(!context->IsCollisionFree()) return k;
+  }
+  return Kbounds;
 }
 
 bool OMPLValidityChecker::operator ==(const ob::StateValidityChecker &rhs) const
@@ -43,40 +125,26 @@ double OMPLValidityChecker::SufficientDistance(const ob::State* state) const
 
 double OMPLValidityChecker::clearance(const ob::State* state) const
 {
-  double c = DistanceToRobot(state, klampt_single_robot_cspace);
-  return 1.0/c;
+  //OMPL clearance samplers and objectives expect larger values further away
+  //from obstacles
+  double d = 0;
+  if(clearanceCache && clearanceCache->Lookup(state, d)) return d;
+  d = DistanceToRobot(state, contexts.get());
+  //states in collision do not bound their neighbors
+  if(clearanceCache && d > 0) clearanceCache->Insert(state, d);
+  return d;
 }
 
-double OMPLValidityChecker::DistanceToRobot(const ob::State* state, SingleRobotCSpace *space) const
+double OMPLValidityChecker::DistanceToRobot(const ob::State* state, RobotCollisionContextPool *pool) const
 {
-  Config q = cspace->OMPLStateToConfig(state);
-  Robot* robot = space->GetRobot();
-  robot->UpdateConfig(q);
-  robot->UpdateGeometry();
-
-  int id = space->world.RobotID(space->index);
-  vector<int> idrobot(1,id);
-  vector<int> idothers;
-  for(size_t i=0;i<space->world.terrains.size();i++)
-  {
-    idothers.push_back(space->world.TerrainID(i));
-  }
-  for(size_t i=0;i<space->world.rigidObjects.size();i++)
-  {
-    idothers.push_back(space->world.RigidObjectID(i));
-  }
-
-  pair<int,int> res;
+  RobotCollisionContext *context = pool->Get();
+  Config &q = context->GetConfigBuffer();
+  cspace->OMPLStateToConfig(state, q);
+  context->UpdateConfig(q);
 
-  //selfcollision checking
-  res = space->settings->CheckCollision(space->world,idrobot);
-  if(res.first >= 0) return 0;
-  //environment collision checking
-  res = space->settings->CheckCollision(space->world,idrobot,idothers);
-  if(res.first >= 0) return 0;
+  if(!context->IsCollisionFree()) return 0;
 
-  int closest1, closest2;
-  double d = space->settings->DistanceLowerBound(space->world, idrobot, idothers, 0, dInf, &closest1, &closest2);
+  double d = context->DistanceLowerBound();
 
   return d;
   // return neighborhood->WorkspaceDistanceToConfigurationSpaceDistance(d);
@@ -84,31 +152,12 @@ double OMPLValidityChecker::DistanceToRobot(const ob::State* state, SingleRobotC
 
 
 //same as Singlerobotcspace but ignore other robots (because QS requires
-//multiple nested robots)
-bool OMPLValidityChecker::IsCollisionFree(SingleRobotCSpace *space, Config q) const{
-  Robot* robot = space->GetRobot();
-  robot->UpdateConfig(q);
-  robot->UpdateGeometry();
-
-  int id = space->world.RobotID(space->index);
-  vector<int> idrobot(1,id);
-  vector<int> idothers;
-  for(size_t i=0;i<space->world.terrains.size();i++)
-    idothers.push_back(space->world.TerrainID(i));
-  for(size_t i=0;i<space->world.rigidObjects.size();i++)
-    idothers.push_back(space->world.RigidObjectID(i));
-
-  pair<int,int> res;
-
-  //selfcollision checking
-  res = space->settings->CheckCollision(space->world,idrobot);
-  if(res.first >= 0) return false;
-  //environment collision checking
-  res = space->settings->CheckCollision(space->world,idrobot,idothers);
-
-  if(res.first >= 0) return false;
-
-  return true;
+//multiple nested robots). The robot is not modified, instead each thread
+//updates its own copy (see RobotCollisionContext).
+bool OMPLValidityChecker::IsCollisionFree(RobotCollisionContextPool *pool, const Config &q) const{
+  RobotCollisionContext *context = pool->Get();
+  context->UpdateConfig(q);
+  return context->IsCollisionFree();
 }
 bool OMPLValidityChecker::IsFeasible(const ob::State* state) const
 {
@@ -123,17 +172,21 @@ OMPLValidityCheckerNecessarySufficient::OMPLValidityCheckerNecessarySufficient(c
   OMPLValidityChecker(si, cspace_)
 {
   klampt_single_robot_cspace_outer_approximation = static_cast<SingleRobotCSpace*>(outer_); 
+  contexts_outer_approximation = std::make_shared<RobotCollisionContextPool>(klampt_single_robot_cspace_outer_approximation);
 }
 
 bool OMPLValidityCheckerNecessarySufficient::IsSufficientFeasible(const ob::State* state) const
 {
-  Config q = cspace->OMPLStateToConfig(state);
-  return IsCollisionFree(klampt_single_robot_cspace_outer_approximation, q);
+  RobotCollisionContext *context = contexts_outer_approximation->Get();
+  Config &q = context->GetConfigBuffer();
+  cspace->OMPLStateToConfig(state, q);
+  context->UpdateConfig(q);
+  return context->IsCollisionFree();
 }
 
 double OMPLValidityCheckerNecessarySufficient::SufficientDistance(const ob::State* state) const
 {
-  double dw = DistanceToRobot(state, klampt_single_robot_cspace_outer_approximation);
+  double dw = DistanceToRobot(state, contexts_outer_approximation.get());
   return dw;
   // return neighborhood->WorkspaceDistanceToConfigurationSpaceDistance(dw);
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "planner/cspace/cspace.h"
 #include "neighborhood.h"
+#include "robot_collision_context.h"
+#include "clearance_cache.h"
 
 class OMPLValidityChecker: public ob::StateValidityChecker
 {
@@ -14,21 +16,38 @@ class OMPLValidityChecker: public ob::StateValidityChecker
     virtual double SufficientDistance(const ob::State* state) const;
 
     bool isValid(const ob::State* state) const override;
-    bool IsCollisionFree(SingleRobotCSpace *space, Config q) const;
+    //validity and clearance with a single configuration update (clearance is
+    //zero for invalid states)
+    bool isValid(const ob::State* state, double &dist) const override;
+    //same, but the distance query reuses the queries of the previous call of
+    //this thread (cheap for neighbouring states)
+    virtual bool IsValidCached(const ob::State* state, double &dist) const;
+    //check K states in the given order (stops at the first invalid state).
+    //Returns index of first invalid state, or K if all states are valid.
+    virtual uint FirstInvalid(const ob::State* const* states, uint K) const;
+    bool IsCollisionFree(RobotCollisionContextPool *pool, const Config &q) const;
 
     CSpaceOMPL* GetCSpaceOMPLPtr() const;
     void SetNeighborhood(double);
+    //memoize clearance queries (requires a neighborhood, see ClearanceCache)
+    void SetClearanceCache(uint size, double resolution, double maxError);
+    ClearanceCache* GetClearanceCache() const;
 
+    //workspace distance of the robot to the environment
     virtual double clearance(const ob::State*) const override;
 
     virtual bool operator ==(const ob::StateValidityChecker &rhs) const override;
 
   protected:
-    double DistanceToRobot(const ob::State* state, SingleRobotCSpace *space) const;
+    double DistanceToRobot(const ob::State* state, RobotCollisionContextPool *pool) const;
+    bool IsValidWithClearance(const ob::State* state, double &dist, bool cached) const;
 
     CSpaceOMPL *cspace{nullptr};
     SingleRobotCSpace *klampt_single_robot_cspace{nullptr};
+    //robot copies for each thread calling isValid/clearance
+    RobotCollisionContextPoolPtr contexts;
     Neighborhood *neighborhood{nullptr};
+    std::unique_ptr<ClearanceCache> clearanceCache;
 };
 
 class OMPLValidityCheckerNecessarySufficient: public OMPLValidityChecker
@@ -41,6 +60,7 @@ class OMPLValidityCheckerNecessarySufficient: public OMPLValidityChecker
 
   private:
     SingleRobotCSpace *klampt_single_robot_cspace_outer_approximation;
+    RobotCollisionContextPoolPtr contexts_outer_approximation;
 };
 typedef std::shared_ptr<OMPLValidityChecker> OMPLValidityCheckerPtr;
 typedef std::shared_ptr<OMPLValidityCheckerNecessarySufficient> OMPLValidityCheckerNecessarySufficientPtr;
@@ -18,6 +18,34 @@ bool OMPLValidityCheckerRelaxation::isValid(const ob::State* x) const
   else return BaseT::isValid(x);
 }
 
+bool OMPLValidityCheckerRelaxation::isValid(const ob::State* x, double &dist) const
+{
+  double d = si_->distance(xCenter_, x);
+  if( d > radius_){
+    dist = clearance(x);
+    return true;
+  }
+  else return BaseT::isValid(x, dist);
+}
+
+bool OMPLValidityCheckerRelaxation::IsValidCached(const ob::State* x, double &dist) const
+{
+  double d = si_->distance(xCenter_, x);
+  if( d > radius_){
+    dist = clearance(x);
+    return true;
+  }
+  else return BaseT::IsValidCached(x, dist);
+}
+
+uint OMPLValidityCheckerRelaxation::FirstInvalid(const ob::State* const* states, uint K) const
+{
+  for(uint k = 0; k < K; k++){
+    if(!isValid(states[k])) return k;
+  }
+  return K;
+}
+
 bool OMPLValidityCheckerRelaxation::operator ==(const ob::StateValidityChecker &rhs) const
 {
   bool sameSpace = (BaseT::operator==(rhs));
@@ -10,6 +10,9 @@ class OMPLValidityCheckerRelaxation: public OMPLValidityChecker
         CSpaceOMPL *cspace, ob::State*, double);
 
     bool isValid(const ob::State* state) const override;
+    bool isValid(const ob::State* state, double &dist) const override;
+    bool IsValidCached(const ob::State* state, double &dist) const override;
+    uint FirstInvalid(const ob::State* const* states, uint K) const override;
 
     virtual bool operator ==(const ob::StateValidityChecker &rhs) const override;
 
@@ -136,6 +136,18 @@ void PlannerInput::SetDefault()
   contactPlanner = GetSubNodeText<int>(node, "contactPlanner");
   timestep_min = GetSubNodeAttribute<double>(node, "timestep", "min");
   timestep_max = GetSubNodeAttribute<double>(node, "timestep", "max");
+  propagation_cache_size = GetSubNodeAttributeDefault(node, "propagationcache", "size", 0);
+  propagation_cache_memory = GetSubNodeAttributeDefault(node, "propagationcache", "memory", 64.0);
+  propagation_threads = GetSubNodeTextDefault(node, "propagationThreads", 1);
+  integrator_method = GetSubNodeAttributeDefault(node, "integrator", "method", std::string("euler"));
+  integrator_tolerance = GetSubNodeAttributeDefault(node, "integrator", "tolerance", 1e-6);
+  integrator_max_step = GetSubNodeAttributeDefault(node, "integrator", "maxstep", 0.1);
+  integrator_mass_matrix_tolerance = GetSubNodeAttributeDefault(node, "integrator", "massmatrix", 0.0);
+  clearance_cache_size = GetSubNodeAttributeDefault(node, "clearancecache", "size", 0);
+  clearance_cache_resolution = GetSubNodeAttributeDefault(node, "clearancecache", "resolution", 0.01);
+  clearance_cache_error = GetSubNodeAttributeDefault(node, "clearancecache", "error", 0.01);
+  neighborhood_constant = GetSubNodeAttributeDefault(node, "clearancecache", "neighborhood", 1.0);
+  lazy_edges = GetSubNodeTextDefault(node, "lazyEdges", 0);
   max_planning_time = GetSubNodeText<double>(node, "maxplanningtime");
   epsilon_goalregion = GetSubNodeText<double>(node, "epsilongoalregion");
   pathSpeed = GetSubNodeText<double>(node, "pathSpeed");
@@ -159,6 +171,24 @@ bool PlannerInput::Load(TiXmlElement *node, int hierarchy_index)
   robot_idx = GetSubNodeTextDefault(node, "robot", 0);
   timestep_min = GetSubNodeAttributeDefault(node, "timestep", "min", timestep_min);
   timestep_max = GetSubNodeAttributeDefault(node, "timestep", "max", timestep_max);
+  propagation_cache_size = GetSubNodeAttributeDefault(node, "propagationcache", "size", propagation_cache_size);
+  propagation_cache_memory = GetSubNodeAttributeDefault(node, "propagationcache", "memory", propagation_cache_memory);
+  propagation_threads = GetSubNodeTextDefault(node, "propagationThreads", (int)propagation_threads);
+  integrator_method = GetSubNodeAttributeDefault(node, "integrator", "method", integrator_method);
+  integrator_tolerance = GetSubNodeAttributeDefault(node, "integrator", "tolerance", integrator_tolerance);
+  integrator_max_step = GetSubNodeAttributeDefault(node, "integrator", "maxstep", integrator_max_step);
+  integrator_mass_matrix_tolerance = GetSubNodeAttributeDefault(node, "integrator", "massmatrix", integrator_mass_matrix_tolerance);
+  //step size control divides by both (RK45 would never terminate)
+  if(!(integrator_max_step > 0) || !(integrator_tolerance > 0)){
+    std::cout << "ERROR: integrator maxstep and tolerance need to be positive (maxstep "
+      << integrator_max_step << ", tolerance " << integrator_tolerance << ")" << std::endl;
+    throw "Invalid integrator settings.";
+  }
+  clearance_cache_size = GetSubNodeAttributeDefault(node, "clearancecache", "size", clearance_cache_size);
+  clearance_cache_resolution = GetSubNodeAttributeDefault(node, "clearancecache", "resolution", clearance_cache_resolution);
+  clearance_cache_error = GetSubNodeAttributeDefault(node, "clearancecache", "error", clearance_cache_error);
+  neighborhood_constant = GetSubNodeAttributeDefault(node, "clearancecache", "neighborhood", neighborhood_constant);
+  lazy_edges = GetSubNodeTextDefault(node, "lazyEdges", (int)lazy_edges);
   max_planning_time = GetSubNodeTextDefault(node, "maxplanningtime", max_planning_time);
   epsilon_goalregion = GetSubNodeTextDefault(node, "epsilongoalregion", epsilon_goalregion);
   pathSpeed = GetSubNodeTextDefault(node, "pathSpeed", pathSpeed);
@@ -442,6 +472,17 @@ const CSpaceInput& PlannerInput::GetCSpaceInput(int robot_idx)
   cin = new CSpaceInput();
   cin->timestep_max = timestep_max;
   cin->timestep_min = timestep_min;
+  cin->propagation_cache_size = propagation_cache_size;
+  cin->propagation_cache_memory = propagation_cache_memory;
+  cin->propagation_threads = propagation_threads;
+  cin->integrator_method = integrator_method;
+  cin->integrator_tolerance = integrator_tolerance;
+  cin->integrator_max_step = integrator_max_step;
+  cin->integrator_mass_matrix_tolerance = integrator_mass_matrix_tolerance;
+  cin->clearance_cache_size = clearance_cache_size;
+  cin->clearance_cache_resolution = clearance_cache_resolution;
+  cin->clearance_cache_error = clearance_cache_error;
+  cin->neighborhood_constant = neighborhood_constant;
   cin->fixedBase = !freeFloating;
   if(!ExistsAgentAtID(robot_idx))
   {
@@ -473,6 +514,7 @@ const StrategyInput& PlannerInput::GetStrategyInput()
   sin->epsilon_goalregion = epsilon_goalregion;
   sin->max_planning_time = max_planning_time;
   sin->environment_name = environment_name;
+  sin->lazy_edges = lazy_edges;
   return *sin;
 }
 
@@ -498,6 +540,13 @@ std::ostream& operator<< (std::ostream& out, const PlannerInput& pin)
   out << "sampler            : " << pin.name_sampler << std::endl;
   out << "loadPath           : " << pin.name_loadPath << std::endl;
   out << "discr timestep     : [" << pin.timestep_min << "," << pin.timestep_max << "]" << std::endl;
+  out << "propagation cache  : " << pin.propagation_cache_size << " entries (max " << pin.propagation_cache_memory << " MB)" << std::endl;
+  out << "propagation threads: " << pin.propagation_threads << std::endl;
+  out << "integrator         : " << pin.integrator_method << " (tolerance " << pin.integrator_tolerance
+    << ", max step " << pin.integrator_max_step << ", mass matrix " << pin.integrator_mass_matrix_tolerance << ")" << std::endl;
+  out << "clearance cache    : " << pin.clearance_cache_size << " entries (resolution " << pin.clearance_cache_resolution
+    << ", max error " << pin.clearance_cache_error << ", neighborhood " << pin.neighborhood_constant << ")" << std::endl;
+  out << "lazy edges         : " << (pin.lazy_edges?"yes":"no") << std::endl;
   out << "max planning time  : " << pin.max_planning_time << " (seconds)" << std::endl;
   out << "epsilon_goalregion : " << pin.epsilon_goalregion << std::endl;
   out << "robot              : " << pin.robot_idx << std::endl;
@@ -87,6 +87,18 @@ class PlannerInput{
     double max_planning_time{0.0};
     double timestep_min{0.0};
     double timestep_max{0.0};
+    uint propagation_cache_size{0};
+    double propagation_cache_memory{64};
+    uint propagation_threads{1};
+    std::string integrator_method{"euler"};
+    double integrator_tolerance{1e-6};
+    double integrator_max_step{0.1};
+    double integrator_mass_matrix_tolerance{0};
+    uint clearance_cache_size{0};
+    double clearance_cache_resolution{0.01};
+    double clearance_cache_error{0.01};
+    double neighborhood_constant{1};
+    bool lazy_edges{false};
 
     bool smoothPath{false};
     double pathSpeed{1};
@@ -0,0 +1,95 @@
+#include "planner/strategy/clearance_valid_state_sampler.h"
+#include <ompl/base/SpaceInformation.h>
+
+using namespace ompl::base;
+
+ClearanceValidStateSampler::ClearanceValidStateSampler(const SpaceInformation *si):
+  ValidStateSampler(si), sampler_(si->allocStateSampler())
+{
+  name_ = "cached_clearance";
+  work_ = si_->allocState();
+  //the cached distance queries are only available on our own checkers
+  checker_ = dynamic_cast<const OMPLValidityChecker*>(si_->getStateValidityChecker().get());
+
+  params_.declareParam<unsigned int>("nr_improve_attempts",
+      [this](unsigned int a){ setNrImproveAttempts(a); },
+      [this]{ return getNrImproveAttempts(); });
+  params_.declareParam<double>("neighborhood_fraction",
+      [this](double f){ setNeighborhoodFraction(f); },
+      [this]{ return getNeighborhoodFraction(); });
+}
+
+ClearanceValidStateSampler::~ClearanceValidStateSampler()
+{
+  si_->freeState(work_);
+}
+
+bool ClearanceValidStateSampler::isValid(const State *state, double &dist) const
+{
+  if(checker_ != nullptr) return checker_->IsValidCached(state, dist);
+  return si_->getStateValidityChecker()->isValid(state, dist);
+}
+
+bool ClearanceValidStateSampler::sample(State *state)
+{
+  double dist = 0;
+  bool valid = false;
+  unsigned int attempts = 0;
+  do{
+    sampler_->sampleUniform(state);
+    valid = isValid(state, dist);
+    attempts++;
+  }while(!valid && attempts < attempts_);
+
+  if(valid) improve(state, dist);
+  return valid;
+}
+
+bool ClearanceValidStateSampler::sampleNear(State *state, const State *near, double distance)
+{
+  double dist = 0;
+  bool valid = false;
+  unsigned int attempts = 0;
+  do{
+    sampler_->sampleUniformNear(state, near, distance);
+    valid = isValid(state, dist);
+    attempts++;
+  }while(!valid && attempts < attempts_);
+
+  if(valid) improve(state, dist);
+  return valid;
+}
+
+//hill climbing on the clearance. The neighborhood shrinks on failed
+//attempts, such that the climb settles close to a local maximum.
+void ClearanceValidStateSampler::improve(State *state, double dist)
+{
+  double radius = neighborhoodFraction_*si_->getMaximumExtent();
+  for(unsigned int k = 0; k < improveAttempts_; k++){
+    sampler_->sampleUniformNear(work_, state, radius);
+    double d = 0;
+    if(isValid(work_, d) && d > dist){
+      si_->copyState(state, work_);
+      dist = d;
+    }else{
+      radius *= 0.5;
+    }
+  }
+}
+
+void ClearanceValidStateSampler::setNrImproveAttempts(unsigned int attempts)
+{
+  improveAttempts_ = attempts;
+}
+unsigned int ClearanceValidStateSampler::getNrImproveAttempts() const
+{
+  return improveAttempts_;
+}
+void ClearanceValidStateSampler::setNeighborhoodFraction(double fraction)
+{
+  neighborhoodFraction_ = fraction;
+}
+double ClearanceValidStateSampler::getNeighborhoodFraction() const
+{
+  return neighborhoodFraction_;
+}
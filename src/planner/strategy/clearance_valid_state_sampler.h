@@ -0,0 +1,44 @@
+#pragma once
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include <ompl/base/ValidStateSampler.h>
+#include <ompl/base/StateSampler.h>
+
+namespace ompl
+{
+  namespace base
+  {
+    //Valid state sampler which climbs the clearance: after a valid sample
+    //has been found, improvement attempts are sampled in a shrinking
+    //neighborhood of the best state so far, and the state with the largest
+    //clearance is returned. Since consecutive queries are close to each other,
+    //clearance is computed with the distance cache of the validity checker
+    //(OMPLValidityChecker::IsValidCached).
+    class ClearanceValidStateSampler: public ValidStateSampler
+    {
+    public:
+      ClearanceValidStateSampler(const SpaceInformation *si);
+      ~ClearanceValidStateSampler() override;
+
+      bool sample(State *state) override;
+      bool sampleNear(State *state, const State *near, double distance) override;
+
+      void setNrImproveAttempts(unsigned int attempts);
+      unsigned int getNrImproveAttempts() const;
+      //initial radius of the improvement neighborhood (fraction of the
+      //maximum extent of the space)
+      void setNeighborhoodFraction(double fraction);
+      double getNeighborhoodFraction() const;
+
+    private:
+      bool isValid(const State *state, double &dist) const;
+      void improve(State *state, double dist);
+
+      StateSamplerPtr sampler_;
+      State *work_{nullptr};
+      const OMPLValidityChecker *checker_{nullptr};
+
+      unsigned int improveAttempts_{5};
+      double neighborhoodFraction_{0.05};
+    };
+  }
+}
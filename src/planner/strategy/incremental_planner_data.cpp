@@ -0,0 +1,172 @@
+#include "planner/strategy/incremental_planner_data.h"
+#include <ompl/base/objectives/PathLengthOptimizationObjective.h>
+#include <unordered_set>
+
+void IncrementalPlannerData::Clear()
+{
+  pd = nullptr;
+  opt = nullptr;
+  vertexIndex.clear();
+  plannerToIndex.clear();
+  generation = 0;
+  verticesAdded = 0;
+  edgesAdded = 0;
+  edgesRemoved = 0;
+}
+
+ob::PlannerDataPtr IncrementalPlannerData::GetPlannerDataPtr() const
+{
+  return pd;
+}
+
+uint IncrementalPlannerData::GetGeneration() const
+{
+  return generation;
+}
+
+uint IncrementalPlannerData::GetNumberOfAddedVertices() const
+{
+  return verticesAdded;
+}
+
+uint IncrementalPlannerData::GetNumberOfAddedEdges() const
+{
+  return edgesAdded;
+}
+
+uint IncrementalPlannerData::GetNumberOfRemovedEdges() const
+{
+  return edgesRemoved;
+}
+
+void IncrementalPlannerData::Rebuild(ob::PlannerDataPtr pd_planner)
+{
+  pd = pd_planner;
+  opt = std::make_shared<ob::PathLengthOptimizationObjective>(pd->getSpaceInformation());
+
+  vertexIndex.clear();
+  for(uint i = 0; i < pd->numVertices(); i++){
+    vertexIndex[pd->getVertex(i).getState()] = i;
+  }
+  pd->decoupleFromPlanner();
+  pd->computeEdgeWeights(*opt);
+
+  verticesAdded = pd->numVertices();
+  edgesAdded = pd->numEdges();
+  edgesRemoved = 0;
+}
+
+void IncrementalPlannerData::Update(const ob::PlannerPtr &planner)
+{
+  generation++;
+
+  ob::PlannerDataPtr pd_planner = std::make_shared<ob::PlannerData>(planner->getSpaceInformation());
+  planner->getPlannerData(*pd_planner);
+
+  if(!pd){
+    Rebuild(pd_planner);
+    return;
+  }
+
+  uint N = pd_planner->numVertices();
+  uint Nold = pd->numVertices();
+
+  const ob::SpaceInformationPtr &si = pd->getSpaceInformation();
+  uint Nnew = 0;
+  for(uint i = 0; i < N; i++){
+    const ob::State *s = pd_planner->getVertex(i).getState();
+    auto it = vertexIndex.find(s);
+    if(it == vertexIndex.end()){
+      Nnew++;
+    }else if(!si->equalStates(pd->getVertex(it->second).getState(), s)){
+      //state memory has been reused for another vertex
+      Rebuild(pd_planner);
+      return;
+    }
+  }
+  if(Nold + Nnew != N){
+    //planner removed vertices or does not keep its states
+    Rebuild(pd_planner);
+    return;
+  }
+
+  verticesAdded = Nnew;
+  edgesAdded = 0;
+  edgesRemoved = 0;
+
+  //############################################################################
+  //vertices
+  //############################################################################
+  plannerToIndex.resize(N);
+  for(uint i = 0; i < N; i++){
+    const ob::PlannerDataVertex &v = pd_planner->getVertex(i);
+    auto it = vertexIndex.find(v.getState());
+    if(it != vertexIndex.end()){
+      plannerToIndex.at(i) = it->second;
+      continue;
+    }
+    uint vi;
+    if(pd_planner->isStartVertex(i)) vi = pd->addStartVertex(v);
+    else if(pd_planner->isGoalVertex(i)) vi = pd->addGoalVertex(v);
+    else vi = pd->addVertex(v);
+    vertexIndex[v.getState()] = vi;
+    plannerToIndex.at(i) = vi;
+  }
+
+  //existing vertices might have become start or goal vertices
+  for(uint k = 0; k < pd_planner->numStartVertices(); k++){
+    uint vi = plannerToIndex.at(pd_planner->getStartIndex(k));
+    if(!pd->isStartVertex(vi)) pd->markStartState(pd->getVertex(vi).getState());
+  }
+  for(uint k = 0; k < pd_planner->numGoalVertices(); k++){
+    uint vi = plannerToIndex.at(pd_planner->getGoalIndex(k));
+    if(!pd->isGoalVertex(vi)) pd->markGoalState(pd->getVertex(vi).getState());
+  }
+
+  //############################################################################
+  //edges
+  //############################################################################
+  for(uint i = 0; i < N; i++){
+    UpdateEdges(*pd_planner, i, Nold);
+  }
+
+  //clones the states of the new vertices only
+  pd->decoupleFromPlanner();
+}
+
+void IncrementalPlannerData::UpdateEdges(const ob::PlannerData &pd_planner, uint i, uint Nold)
+{
+  std::vector<uint> edges;
+  pd_planner.getEdges(i, edges);
+  uint vi = plannerToIndex.at(i);
+
+  if(vi < Nold){
+    //remove edges which the planner removed or rewired
+    std::vector<uint> edgesOld;
+    pd->getEdges(vi, edgesOld);
+    std::unordered_set<uint> targets;
+    for(uint j = 0; j < edges.size(); j++){
+      targets.insert(plannerToIndex.at(edges.at(j)));
+    }
+    for(uint j = 0; j < edgesOld.size(); j++){
+      if(targets.find(edgesOld.at(j)) == targets.end()){
+        pd->removeEdge(vi, edgesOld.at(j));
+        edgesRemoved++;
+      }
+    }
+  }
+
+  for(uint j = 0; j < edges.size(); j++){
+    uint vj = plannerToIndex.at(edges.at(j));
+    if(!pd->edgeExists(vi, vj)){
+      AddEdge(vi, vj, pd_planner.getEdge(i, edges.at(j)));
+    }
+  }
+}
+
+void IncrementalPlannerData::AddEdge(uint vi, uint vj, const ob::PlannerDataEdge &edge)
+{
+  ob::Cost weight = opt->motionCost(pd->getVertex(vi).getState(), pd->getVertex(vj).getState());
+  pd->addEdge(vi, vj, edge, weight);
+  edgesAdded++;
+}
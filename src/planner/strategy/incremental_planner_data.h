@@ -0,0 +1,55 @@
+#pragma once
+#include <ompl/base/PlannerData.h>
+#include <ompl/base/Planner.h>
+#include <ompl/base/OptimizationObjective.h>
+#include <unordered_map>
+
+namespace ob = ompl::base;
+
+//IncrementalPlannerData: planner data which is kept between consecutive
+//extractions from the same planner. Only vertices and edges which have been
+//added since the last extraction are copied (states are cloned and edge
+//weights computed for the delta only).
+//
+//Vertices are identified by the address of their state in the planner, and
+//the identity is verified by comparing the state with the stored copy (a
+//planner which prunes vertices can reuse the memory of a removed state). If
+//the planner removed vertices, reused a state or does not keep its states
+//between calls to getPlannerData, the data is rebuilt from scratch. Edges of
+//existing vertices are compared on every update, such that rewired edges are
+//replaced.
+class IncrementalPlannerData
+{
+  public:
+    IncrementalPlannerData() = default;
+
+    //extract planner data from planner and update the accumulated data
+    void Update(const ob::PlannerPtr &planner);
+    void Clear();
+
+    ob::PlannerDataPtr GetPlannerDataPtr() const;
+
+    //number of updates since last Clear
+    uint GetGeneration() const;
+    uint GetNumberOfAddedVertices() const;
+    uint GetNumberOfAddedEdges() const;
+    uint GetNumberOfRemovedEdges() const;
+
+  private:
+    void Rebuild(ob::PlannerDataPtr pd_planner);
+    void AddEdge(uint vi, uint vj, const ob::PlannerDataEdge &edge);
+    void UpdateEdges(const ob::PlannerData &pd_planner, uint i, uint Nold);
+
+    ob::PlannerDataPtr pd{nullptr};
+    ob::OptimizationObjectivePtr opt{nullptr};
+
+    //state address in planner -> vertex index in pd
+    std::unordered_map<const ob::State*, uint> vertexIndex;
+    //vertex index in planner data from planner -> vertex index in pd
+    std::vector<uint> plannerToIndex;
+
+    uint generation{0};
+    uint verticesAdded{0};
+    uint edgesAdded{0};
+    uint edgesRemoved{0};
+};
@@ -1,4 +1,8 @@
 #include "infeasibility_sampler.h"
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include <ompl/util/Time.h>
+#include <algorithm>
+#include <cmath>
 
 
 using namespace ompl::geometric;
@@ -7,37 +11,263 @@ namespace ob = ompl::base;
 InfeasibilitySampler::InfeasibilitySampler(const ob::SpaceInformationPtr &si):
   Planner(si, "InfeasibilitySampler")
 {
-  testState = si->allocState();
-  sampler = si_->allocStateSampler();
+  declareParam<uint>("threads", this, &InfeasibilitySampler::setNumberOfThreads,
+      &InfeasibilitySampler::getNumberOfThreads, "0:1:64");
+  declareParam<uint>("reservoir_size", this, &InfeasibilitySampler::setReservoirSize,
+      &InfeasibilitySampler::getReservoirSize, "1:1:1000000");
+  declareParam<double>("target_error", this, &InfeasibilitySampler::setTargetError,
+      &InfeasibilitySampler::getTargetError, "0.:0.0001:0.1");
+}
+
+InfeasibilitySampler::~InfeasibilitySampler()
+{
+  freeStates();
+}
+
+void InfeasibilitySampler::freeStates()
+{
+  si_->freeStates(states);
+  states.clear();
+  for(uint k = 0; k < jobs.size(); k++){
+    si_->freeStates(jobs.at(k).states);
+    si_->freeState(jobs.at(k).testState);
+  }
+  jobs.clear();
 }
 
 ompl::base::PlannerStatus InfeasibilitySampler::solve(const ompl::base::PlannerTerminationCondition &ptc)
 {
-  while(!ptc())
+  checkValidity();
+  allocate();
+
+  unsigned long N0 = Nsamples;
+  ompl::time::point start = ompl::time::now();
+  while(!ptc() && !isConverged())
   {
-    sampler->sampleUniform(testState);
-    if(!si_->isValid(testState)){
-      ob::State *q = si_->cloneState(testState);
-      states.push_back(q);
-    }
+    pool->ParallelFor(jobs.size(), [&](uint job){ sampleBatch(job, ptc); });
+    mergeJobs();
   }
+  double t = ompl::time::seconds(ompl::time::now() - start);
+
+  OMPL_INFORM("%s: %lu samples (%.0f samples/s on %u threads), infeasible fraction %f (+-%f), %u states stored (%.2f MB)",
+      getName().c_str(), Nsamples, (t > 0 ? (Nsamples - N0)/t : 0.0), pool->GetNumberOfThreads(),
+      getInfeasibleFraction(), getInfeasibleFractionError(),
+      (uint)std::min<unsigned long>(Ninfeasible, states.size()), getMemory()/(1024.0*1024.0));
+
   return ompl::base::PlannerStatus::EXACT_SOLUTION;
 
 }
 
+void InfeasibilitySampler::sampleBatch(uint k, const ob::PlannerTerminationCondition &ptc)
+{
+  Job &job = jobs.at(k);
+  uint m = 0;
+  for(; m < batchSize && !ptc; m++){
+    job.sampler->sampleUniform(job.testState);
+    if(!si_->isValid(job.testState)){
+      addInfeasible(job, job.testState);
+    }
+  }
+  job.Nsamples += m;
+}
+
+//reservoir sampling: each infeasible sample of the round is stored with
+//probability (job reservoir size)/(job.Ninfeasible)
+void InfeasibilitySampler::addInfeasible(Job &job, const ob::State *state)
+{
+  unsigned long n = job.Ninfeasible++;
+  if(n < job.states.size()){
+    si_->copyState(job.states.at(n), state);
+  }else{
+    unsigned long j = std::floor(job.rng.uniform01()*(n+1));
+    if(j < job.states.size()){
+      si_->copyState(job.states.at(j), state);
+    }
+  }
+}
+
+//each reservoir is a uniform subset of its infeasible samples. The merged
+//reservoir takes c_i of them from reservoir i, with (c_i) drawn from the
+//multivariate hypergeometric distribution of the sample counts, such that it
+//is a uniform subset of all infeasible samples. States are swapped, not
+//copied.
+void InfeasibilitySampler::mergeJobs()
+{
+  std::lock_guard<std::mutex> lock(mutex);
+
+  //population 0 is the current reservoir, population k+1 the one of job k
+  std::vector<unsigned long> remaining(jobs.size() + 1);
+  remaining.at(0) = Ninfeasible;
+  unsigned long Ntotal = Ninfeasible;
+  for(uint k = 0; k < jobs.size(); k++){
+    remaining.at(k+1) = jobs.at(k).Ninfeasible;
+    Ntotal += jobs.at(k).Ninfeasible;
+    Nsamples += jobs.at(k).Nsamples;
+  }
+
+  std::vector<uint> counts(remaining.size(), 0);
+  unsigned long Nkeep = std::min<unsigned long>(Ntotal, states.size());
+  unsigned long Nremaining = Ntotal;
+  for(unsigned long m = 0; m < Nkeep; m++){
+    unsigned long r = std::min<unsigned long>(Nremaining - 1, std::floor(rng.uniform01()*Nremaining));
+    uint p = 0;
+    while(r >= remaining.at(p)){
+      r -= remaining.at(p);
+      p++;
+    }
+    remaining.at(p)--;
+    Nremaining--;
+    counts.at(p)++;
+  }
+
+  //partial Fisher-Yates: a uniform subset of size c at the front of v[0..n)
+  auto selectFront = [this](std::vector<ob::State*> &v, unsigned long n, uint c)
+  {
+    for(uint m = 0; m < c; m++){
+      unsigned long j = m + std::min<unsigned long>(n - m - 1, std::floor(rng.uniform01()*(n - m)));
+      std::swap(v.at(m), v.at(j));
+    }
+  };
+
+  selectFront(states, std::min<unsigned long>(Ninfeasible, states.size()), counts.at(0));
+  uint slot = counts.at(0);
+  for(uint k = 0; k < jobs.size(); k++){
+    Job &job = jobs.at(k);
+    uint c = counts.at(k+1);
+    selectFront(job.states, std::min<unsigned long>(job.Ninfeasible, job.states.size()), c);
+    for(uint m = 0; m < c; m++){
+      std::swap(states.at(slot++), job.states.at(m));
+    }
+    job.Nsamples = 0;
+    job.Ninfeasible = 0;
+  }
+  Ninfeasible = Ntotal;
+}
+
+bool InfeasibilitySampler::isConverged() const
+{
+  if(targetError <= 0) return false;
+  std::lock_guard<std::mutex> lock(mutex);
+  //do not trust the estimate on few samples
+  if(Nsamples < 1000) return false;
+  double p = (double)Ninfeasible/Nsamples;
+  return 1.96*sqrt(p*(1-p)/Nsamples) < targetError;
+}
+
+double InfeasibilitySampler::getInfeasibleFraction() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return (Nsamples > 0 ? (double)Ninfeasible/Nsamples : 0);
+}
+double InfeasibilitySampler::getInfeasibleFractionError() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if(Nsamples == 0) return 1;
+  double p = (double)Ninfeasible/Nsamples;
+  return 1.96*sqrt(p*(1-p)/Nsamples);
+}
+unsigned long InfeasibilitySampler::getNumberOfSamples() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return Nsamples;
+}
+unsigned long InfeasibilitySampler::getNumberOfInfeasibleSamples() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return Ninfeasible;
+}
+unsigned long InfeasibilitySampler::getMemory() const
+{
+  unsigned long N = states.size();
+  for(uint k = 0; k < jobs.size(); k++) N += jobs.at(k).states.size();
+  return N*si_->getStateSpace()->getSerializationLength();
+}
+
+void InfeasibilitySampler::setNumberOfThreads(uint Nthreads_)
+{
+  Nthreads = Nthreads_;
+}
+uint InfeasibilitySampler::getNumberOfThreads() const
+{
+  return Nthreads;
+}
+void InfeasibilitySampler::setReservoirSize(uint size)
+{
+  reservoirSize = size;
+}
+uint InfeasibilitySampler::getReservoirSize() const
+{
+  return reservoirSize;
+}
+void InfeasibilitySampler::setTargetError(double error)
+{
+  targetError = error;
+}
+double InfeasibilitySampler::getTargetError() const
+{
+  return targetError;
+}
 
 void InfeasibilitySampler::clear()
 {
   BaseT::clear();
-  // si_->freeState(testState);
+  std::lock_guard<std::mutex> lock(mutex);
+  Nsamples = 0;
+  Ninfeasible = 0;
+  for(uint k = 0; k < jobs.size(); k++){
+    jobs.at(k).Nsamples = 0;
+    jobs.at(k).Ninfeasible = 0;
+  }
 }
 void InfeasibilitySampler::setup()
 {
   BaseT::setup();
+  allocate();
+}
+void InfeasibilitySampler::allocate()
+{
+  uint N = (Nthreads > 0 ? Nthreads : std::max(1u, std::thread::hardware_concurrency()));
+  //other validity checkers (e.g. multi-agent) are not thread-safe
+  if(N > 1 && dynamic_cast<OMPLValidityChecker*>(si_->getStateValidityChecker().get()) == nullptr){
+    OMPL_INFORM("%s: validity checker is not thread-safe, sampling on one thread.", getName().c_str());
+    N = 1;
+  }
+  if(pool == nullptr || pool->GetNumberOfThreads() != N){
+    pool.reset(new ThreadPool(N));
+  }
+  //a job stores at most batchSize infeasible samples per round
+  uint Njobs = pool->GetNumberOfThreads();
+  uint jobReservoirSize = std::min(reservoirSize, batchSize);
+  if(jobs.size() != Njobs || jobs.front().states.size() != jobReservoirSize){
+    for(uint k = 0; k < jobs.size(); k++){
+      si_->freeStates(jobs.at(k).states);
+      si_->freeState(jobs.at(k).testState);
+    }
+    jobs.clear();
+    jobs.resize(Njobs);
+    for(uint k = 0; k < Njobs; k++){
+      Job &job = jobs.at(k);
+      job.sampler = si_->allocStateSampler();
+      job.testState = si_->allocState();
+      job.states.assign(jobReservoirSize, nullptr);
+      si_->allocStates(job.states);
+    }
+  }
+  if(states.size() != reservoirSize){
+    std::lock_guard<std::mutex> lock(mutex);
+    si_->freeStates(states);
+    states.assign(reservoirSize, nullptr);
+    si_->allocStates(states);
+    //stored samples are lost
+    Nsamples = 0;
+    Ninfeasible = 0;
+  }
 }
 void InfeasibilitySampler::getPlannerData(ob::PlannerData &data) const
 {
-  for(uint k = 0; k < states.size(); k++){
+  std::lock_guard<std::mutex> lock(mutex);
+  uint N = std::min<unsigned long>(Ninfeasible, states.size());
+  for(uint k = 0; k < N; k++){
     ob::PlannerDataVertex p(states.at(k));
     data.addVertex(p);
   }
@@ -1,6 +1,10 @@
 #pragma once
+#include "algorithms/thread_pool.h"
 #include <ompl/base/Planner.h>
 #include <ompl/base/SpaceInformation.h>
+#include <ompl/util/RandomNumbers.h>
+#include <memory>
+#include <mutex>
 
 namespace ompl
 {
@@ -9,6 +13,17 @@ namespace ompl
 
     //return infeasible samples
     //(e.g. for visualization purposes)
+    //
+    //Samples uniformly on all threads (each with its own state sampler, i.e.
+    //its own random number stream) if the validity checker is an
+    //OMPLValidityChecker (thread-safe through per-thread collision contexts),
+    //otherwise on one thread. The infeasible samples are kept in a reservoir
+    //of fixed capacity (a uniform subset of all infeasible samples), whose
+    //states are allocated once. Each job fills its own reservoir, which are
+    //merged into the reservoir after each round (by swapping states, without
+    //locks while sampling). Sampling stops if the termination condition is met
+    //or if the estimated fraction of infeasible states is accurate up to the
+    //target error (95% confidence, 0: sample until termination).
     class InfeasibilitySampler: public ompl::base::Planner
     {
       using BaseT = ompl::base::Planner;
@@ -16,21 +31,67 @@ namespace ompl
     public:
 
       InfeasibilitySampler(const ompl::base::SpaceInformationPtr &si);
-      ~InfeasibilitySampler(void) = default;
+      ~InfeasibilitySampler(void);
 
       ompl::base::PlannerStatus solve(const ompl::base::PlannerTerminationCondition &ptc) override final;
       virtual void clear() override;
       virtual void setup() override;
       virtual void getPlannerData(ompl::base::PlannerData &data) const override;
+
+      void setNumberOfThreads(uint Nthreads);
+      uint getNumberOfThreads() const;
+      void setReservoirSize(uint size);
+      uint getReservoirSize() const;
+      void setTargetError(double error);
+      double getTargetError() const;
+
+      //estimated fraction of the state space which is infeasible
+      double getInfeasibleFraction() const;
+      //half width of the 95% confidence interval of getInfeasibleFraction
+      double getInfeasibleFractionError() const;
+      unsigned long getNumberOfSamples() const;
+      unsigned long getNumberOfInfeasibleSamples() const;
+      //approximate memory of the reservoir and the job reservoirs (bytes)
+      unsigned long getMemory() const;
+
     private:
-      std::vector<ompl::base::State*> states;
-      ompl::base::StateSamplerPtr sampler;
-      ompl::base::State* testState;
+      struct Job;
+
+      void sampleBatch(uint job, const ompl::base::PlannerTerminationCondition &ptc);
+      //reservoir sampling into the reservoir of job
+      void addInfeasible(Job &job, const ompl::base::State *state);
+      //merges the job reservoirs and counters into states/Nsamples/Ninfeasible
+      void mergeJobs();
+      bool isConverged() const;
+      //thread pool, jobs and reservoir (if settings changed)
+      void allocate();
+      void freeStates();
 
+      uint Nthreads{0};
+      uint reservoirSize{10000};
+      double targetError{0};
+      //samples per job and round (termination is checked per sample)
+      uint batchSize{1000};
 
+      std::unique_ptr<ThreadPool> pool;
+      //sampler, scratch state, reservoir and counters of one round per job
+      struct Job
+      {
+        ompl::base::StateSamplerPtr sampler;
+        ompl::base::State *testState{nullptr};
+        std::vector<ompl::base::State*> states;
+        unsigned long Nsamples{0};
+        unsigned long Ninfeasible{0};
+        ompl::RNG rng;
+      };
+      std::vector<Job> jobs;
+
+      mutable std::mutex mutex;
+      //preallocated states, the first min(Ninfeasible, reservoirSize) are used
+      std::vector<ompl::base::State*> states;
+      unsigned long Nsamples{0};
+      unsigned long Ninfeasible{0};
+      ompl::RNG rng;
     };
   }
 }
-
-
-
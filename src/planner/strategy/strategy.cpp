@@ -1,4 +1,5 @@
 #include "planner/strategy/strategy.h"
+#include "planner/strategy/clearance_valid_state_sampler.h"
 
 #include <ompl/base/ValidStateSampler.h>
 #include <ompl/base/samplers/UniformValidStateSampler.h>
@@ -24,6 +25,10 @@ ob::ValidStateSamplerPtr allocMaximizeClearanceValidStateSampler(const ob::Space
 {
   return std::make_shared<ob::MaximizeClearanceValidStateSampler>(si);
 }
+ob::ValidStateSamplerPtr allocClearanceValidStateSampler(const ob::SpaceInformation *si)
+{
+  return std::make_shared<ob::ClearanceValidStateSampler>(si);
+}
 ob::ValidStateSamplerPtr allocObstacleBasedValidStateSampler(const ob::SpaceInformation *si)
 {
   return std::make_shared<ob::ObstacleBasedValidStateSampler>(si);
@@ -45,6 +50,12 @@ void Strategy::setStateSampler(std::string sampler, ob::SpaceInformationPtr si)
 {
   if(sampler=="custom") return;
 
+  si->clearValidStateSamplerAllocator();
+  si->setValidStateSamplerAllocator(GetValidStateSamplerAllocator(sampler));
+}
+
+ob::ValidStateSamplerAllocator Strategy::GetValidStateSamplerAllocator(const std::string &sampler)
+{
   ob::ValidStateSamplerAllocator allocator;
   if(sampler=="uniform"){
     allocator = allocUniformValidStateSampler;
@@ -53,7 +64,9 @@ void Strategy::setStateSampler(std::string sampler, ob::SpaceInformationPtr si)
   }else if(sampler=="minimum_clearance"){
     allocator = allocMinimumClearanceValidStateSampler;
   }else if(sampler=="maximum_clearance"){
-    allocator = allocMinimumClearanceValidStateSampler;
+    allocator = allocMaximizeClearanceValidStateSampler;
+  }else if(sampler=="cached_clearance"){
+    allocator = allocClearanceValidStateSampler;
   }else if(sampler=="obstacle_based"){
     allocator = allocObstacleBasedValidStateSampler;
   }else if(sampler=="bridge" || sampler=="bridge_test"){
@@ -62,8 +75,7 @@ void Strategy::setStateSampler(std::string sampler, ob::SpaceInformationPtr si)
     std::cout << "Sampler  " << sampler << " is unknown." << std::endl;
     throw "Sampler unknown.";
   }
-  si->clearValidStateSamplerAllocator();
-  si->setValidStateSamplerAllocator(allocator);
+  return allocator;
 }
 
 void Strategy::BenchmarkFileToPNG(const std::string &file)
@@ -17,6 +17,9 @@ class Strategy{
 
     const ob::PlannerPtr GetPlannerPtr();
 
+    //valid state sampler by name (see settings/planner.xml)
+    static ob::ValidStateSamplerAllocator GetValidStateSamplerAllocator(const std::string &sampler);
+
   protected:
     Strategy() = default;
     void setStateSampler(std::string sampler, ob::SpaceInformationPtr si);
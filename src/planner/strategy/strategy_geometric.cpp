@@ -2,7 +2,12 @@
 #include "planner/strategy/strategy_geometric.h"
 #include "planner/benchmark/benchmark_input.h"
 #include "planner/benchmark/benchmark_output.h"
+#include "planner/benchmark/benchmark_parallel.h"
 #include "planner/strategy/infeasibility_sampler.h"
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include "planner/cspace/validitychecker/motion_validator_lazy.h"
+#include "algorithms/roadmap_graph.h"
+#include <ompl/geometric/planners/multilevel/datastructures/PlannerDataVertexAnnotated.h>
 
 #include <ompl/geometric/planners/explorer/Explorer.h>
 #include <ompl/geometric/planners/multilevel/QRRT.h>
@@ -54,6 +59,8 @@
 #include <ompl/geometric/PathGeometric.h>
 #include <ompl/util/Time.h>
 #include <boost/lexical_cast.hpp>
+#include <atomic>
+#include <mutex>
 
 static ob::OptimizationObjectivePtr GetOptimizationObjective(const ob::SpaceInformationPtr& si)
 {
@@ -69,7 +76,9 @@ static uint all_runs{0};
 
 void PostRunEvent(const ob::PlannerPtr &planner, ot::Benchmark::RunProperties &run)
 {
-  static uint pid = 0;
+  //called concurrently by the workers of BenchmarkParallel
+  static std::atomic<uint> pid{0};
+  static std::mutex mutex;
 
   ob::SpaceInformationPtr si = planner->getSpaceInformation();
   ob::ProblemDefinitionPtr pdef = planner->getProblemDefinition();
@@ -89,6 +98,7 @@ void PostRunEvent(const ob::PlannerPtr &planner, ot::Benchmark::RunProperties &r
   std::string strkf = "stratification level"+to_string(0)+" feasible nodes INTEGER";
   run[strkf] = to_string(states);
 
+  std::lock_guard<std::mutex> lock(mutex);
   std::cout << "Run " << pid << "/" << all_runs << " [" << planner->getName() << "] " << (solved?"solved":"no solution") << "(time: "<< time << ", states: " << states << ", memory: " << memory << ")" << std::endl;
   std::cout << std::string(80, '-') << std::endl;
   pid++;
@@ -163,14 +173,15 @@ ob::PlannerPtr StrategyGeometricMultiLevel::GetPlanner(std::string algorithm,
 }
 
 OMPLGeometricStratificationPtr StrategyGeometricMultiLevel::OMPLGeometricStratificationFromCSpaceStratification
-(const StrategyInput &input, std::vector<CSpaceOMPL*> cspace_levels )
+(const StrategyInput &input, std::vector<CSpaceOMPL*> cspace_levels, bool independentSpaceInformation )
 {
   std::vector<ob::SpaceInformationPtr> si_vec; 
 
   for(uint k = 0; k < cspace_levels.size(); k++)
   {
     CSpaceOMPL* cspace_levelk = cspace_levels.at(k);
-    ob::SpaceInformationPtr sik = cspace_levelk->SpaceInformationPtr();
+    ob::SpaceInformationPtr sik = (independentSpaceInformation ?
+        cspace_levelk->CreateSpaceInformation() : cspace_levelk->SpaceInformationPtr());
     setStateSampler(input.name_sampler, sik);
     si_vec.push_back(sik);
     std::cout << "CSPACE LEVEL" << k << " DIMENSION:" << cspace_levelk->GetDimensionality() << std::endl;
@@ -218,12 +229,26 @@ void StrategyGeometricMultiLevel::Init( const StrategyInput &input )
     planner->setup();
     planner->clear();
     isInitialized = true;
+
+    //solutions of the multilevel roadmap planners are validated in SolveLazy
+    lazy_edges = false;
+    if(input.lazy_edges){
+      if(algorithm == "hierarchy:qmp" || algorithm == "hierarchy:qmpstar" || algorithm == "hierarchy:spqr"){
+        lazy_edges = true;
+        si_levels = stratification->si_vec;
+      }else{
+        std::cout << "lazyEdges is only supported by hierarchy:qmp|qmpstar|spqr, validating all edges of " << algorithm << "." << std::endl;
+      }
+    }
   }
   max_planning_time = input.max_planning_time;
 }
 
 void StrategyGeometricMultiLevel::Step(StrategyOutput &output)
 {
+  //steps are not validated afterwards
+  SetLazyEdges(false);
+
   ob::IterationTerminationCondition itc(1);
   ob::PlannerTerminationCondition ptc(itc);
 
@@ -233,9 +258,9 @@ void StrategyGeometricMultiLevel::Step(StrategyOutput &output)
   output.max_planner_time = max_planning_time;
 
   //###########################################################################
-  ob::PlannerDataPtr pd( new ob::PlannerData(planner->getSpaceInformation()) );
-  planner->getPlannerData(*pd);
-  output.SetPlannerData(pd);
+  //only copy vertices and edges added in this step
+  planner_data.Update(planner);
+  output.SetPlannerData(planner_data);
   ob::ProblemDefinitionPtr pdef = planner->getProblemDefinition();
   output.SetProblemDefinition(pdef);
 }
@@ -266,16 +291,143 @@ void StrategyGeometricMultiLevel::Step(StrategyOutput &output)
 
 void StrategyGeometricMultiLevel::Clear()
 {
-  if(isInitialized) planner->clear();
+  if(isInitialized){
+    planner->clear();
+    SetLazyEdges(false);
+    lazy_validator.reset();
+  }
+  planner_data.Clear();
+}
+
+const LazyMotionValidator* StrategyGeometricMultiLevel::GetLazyMotionValidator() const
+{
+  return lazy_validator.get();
+}
+
+void StrategyGeometricMultiLevel::SetLazyEdges(bool lazy)
+{
+  bool installed = !eager_validators.empty();
+  if(lazy == installed) return;
+  for(uint k = 0; k < si_levels.size(); k++){
+    ob::SpaceInformationPtr sik = si_levels.at(k);
+    if(lazy){
+      eager_validators.push_back(sik->getMotionValidator());
+      lazy_validator = std::make_shared<LazyMotionValidator>(sik);
+      sik->setMotionValidator(lazy_validator);
+    }else{
+      sik->setMotionValidator(eager_validators.at(k));
+    }
+    sik->setup();
+  }
+  if(!lazy) eager_validators.clear();
+}
+//state of a vertex in the space information of its level
+static const ob::State* GetVertexState(ob::PlannerData &pd, uint v)
+{
+  ob::PlannerDataVertexAnnotated *va = dynamic_cast<ob::PlannerDataVertexAnnotated*>(&pd.getVertex(v));
+  return (va == nullptr ? pd.getVertex(v).getState() : va->getBaseState());
+}
+static int GetVertexLevel(ob::PlannerData &pd, uint v)
+{
+  ob::PlannerDataVertexAnnotated *va = dynamic_cast<ob::PlannerDataVertexAnnotated*>(&pd.getVertex(v));
+  return (va == nullptr ? 0 : va->getLevel());
+}
+
+//shortest path between start and goal of the last level of the planner data
+//whose edges are valid (lazy search, see RoadmapGraph)
+static bool GetShortestValidPath(ob::PlannerData &pd, const LazyMotionValidator *validator, og::PathGeometric &path)
+{
+  int s = -1;
+  int t = -1;
+  for(uint k = 0; k < pd.numStartVertices(); k++){
+    int v = pd.getStartIndex(k);
+    if(s < 0 || GetVertexLevel(pd, v) > GetVertexLevel(pd, s)) s = v;
+  }
+  for(uint k = 0; k < pd.numGoalVertices(); k++){
+    int v = pd.getGoalIndex(k);
+    if(t < 0 || GetVertexLevel(pd, v) > GetVertexLevel(pd, t)) t = v;
+  }
+  if(s < 0 || t < 0 || GetVertexLevel(pd, s) != GetVertexLevel(pd, t)) return false;
+
+  RoadmapGraph graph(&pd);
+  std::vector<uint> vertices = graph.GetShortestPathLazy(s, t, [&](uint v, uint w)
+      { return validator->ValidateEdge(GetVertexState(pd, v), GetVertexState(pd, w)); });
+  if(vertices.empty()) return false;
+
+  for(uint k = 0; k < vertices.size(); k++){
+    path.append(GetVertexState(pd, vertices.at(k)));
+  }
+  return true;
+}
+
+//Lazy edge validation: the planner accepts motions optimistically
+//(LazyMotionValidator). Its solution is validated edge by edge. If an edge is
+//invalid, the shortest valid path in its roadmap is searched lazily, and the
+//planner continues to grow the roadmap while there is none.
+void StrategyGeometricMultiLevel::SolveLazy(const ob::PlannerTerminationCondition &ptc, const LazyMotionValidator *validator)
+{
+  ob::ProblemDefinitionPtr pdef = planner->getProblemDefinition();
+  ob::SpaceInformationPtr si = planner->getSpaceInformation();
+
+  auto isValid = [&](const og::PathGeometric *path)
+  {
+    for(uint k = 1; k < path->getStateCount(); k++){
+      if(!validator->ValidateEdge(path->getState(k - 1), path->getState(k))) return false;
+    }
+    return true;
+  };
+
+  uint Nvertices = 0;
+  while(!ptc){
+    planner->solve(ptc);
+    og::PathGeometric *solution = dynamic_cast<og::PathGeometric*>(pdef->getSolutionPath().get());
+    if(!pdef->hasExactSolution()){
+      //approximate solutions are kept only if they are valid
+      if(solution != nullptr && !isValid(solution)) pdef->clearSolutionPaths();
+      return;
+    }
+    if(solution != nullptr && isValid(solution)) return;
+
+    ob::PlannerData pd(si);
+    planner->getPlannerData(pd);
+    pd.computeEdgeWeights();
+    pdef->clearSolutionPaths();
+
+    auto path = std::make_shared<og::PathGeometric>(si);
+    if(GetShortestValidPath(pd, validator, *path)){
+      pdef->addSolutionPath(path, false, 0.0, planner->getName());
+      return;
+    }
+    //no valid path in roadmap, continue unless the planner does not add
+    //vertices anymore
+    if(pd.numVertices() <= Nvertices) return;
+    Nvertices = pd.numVertices();
+  }
 }
+
 void StrategyGeometricMultiLevel::Plan(StrategyOutput &output)
 {
   ob::PlannerTerminationCondition ptc( ob::timedPlannerTerminationCondition(max_planning_time) );
+  //path smoothing and simplification after Plan check motions eagerly
   ompl::time::point start = ompl::time::now();
-  planner->solve(ptc);
+  if(lazy_edges){
+    SetLazyEdges(true);
+    SolveLazy(ptc, lazy_validator.get());
+    SetLazyEdges(false);
+  }else{
+    planner->solve(ptc);
+  }
   output.planner_time = ompl::time::seconds(ompl::time::now() - start);
   output.max_planner_time = max_planning_time;
 
+  if(lazy_edges) std::cout << *lazy_validator << std::endl;
+
+  const OMPLValidityChecker *checker = dynamic_cast<const OMPLValidityChecker*>(
+      planner->getSpaceInformation()->getStateValidityChecker().get());
+  if(checker != nullptr && checker->GetClearanceCache() != nullptr){
+    std::cout << *checker->GetClearanceCache() << std::endl;
+  }
+
   //###########################################################################
 
   ob::PlannerDataPtr pd( new ob::PlannerData(planner->getSpaceInformation()) );
@@ -291,47 +443,17 @@ void StrategyGeometricMultiLevel::Plan(StrategyOutput &output)
 
 }
 
-void StrategyGeometricMultiLevel::RunBenchmark(const StrategyInput& input)
+std::vector<ob::PlannerPtr> StrategyGeometricMultiLevel::GetBenchmarkPlanners(
+    const BenchmarkInput &binput,
+    std::vector<OMPLGeometricStratificationPtr> &stratifications,
+    uint k_largest_ambient_space)
 {
-  BenchmarkInput binput(input.name_algorithm);
+  std::vector<ob::PlannerPtr> planners;
 
-  std::vector<OMPLGeometricStratificationPtr> stratifications;
-  for(uint k = 0; k < input.cspace_stratifications.size(); k++){
-    std::vector<CSpaceOMPL*> cspace_strat_k = input.cspace_stratifications.at(k);
-    OMPLGeometricStratificationPtr stratification = OMPLGeometricStratificationFromCSpaceStratification(input, cspace_strat_k);
-    stratifications.push_back(stratification);
-  }
-  if(stratifications.empty()) 
-  {
-    OMPL_INFORM("No stratifications specified. No algorithm is run");
-    return;
-  }
-  uint k_largest_ambient_space = 0;
-  uint largest_ambient_space_dimension = 0;
-  for(uint k = 0; k < stratifications.size(); k++){
-    const ob::SpaceInformationPtr sik = stratifications.at(k)->si_vec.back();
-    uint dk = sik->getStateDimension();
-    if(dk > largest_ambient_space_dimension){
-      k_largest_ambient_space = k;
-      largest_ambient_space_dimension = dk;
-    }
-  }
-
-  std::cout << "Largest Ambient Space Dimension for Benchmark:" << largest_ambient_space_dimension << std::endl;
   const ob::SpaceInformationPtr si = stratifications.at(k_largest_ambient_space)->si_vec.back();
   const ob::ProblemDefinitionPtr pdef = stratifications.at(k_largest_ambient_space)->pdef;
+  uint largest_ambient_space_dimension = si->getStateDimension();
 
-
-  std::string environment_name = util::GetFileBasename(input.environment_name);
-  std::string file_benchmark = environment_name+"_"+util::GetCurrentDateTimeString();
-  std::string output_file_without_extension = util::GetDataFolder()+"/benchmarks/"+file_benchmark;
-  std::string log_file = output_file_without_extension+".log";
-  std::string xml_file = output_file_without_extension+".xml";
-
-  og::SimpleSetup ss(si);
-  ot::Benchmark benchmark(ss, environment_name);
-
-  uint planner_ctr = 0;
   for(uint k = 0; k < binput.algorithms.size(); k++){
     std::string name_algorithm = binput.algorithms.at(k);
 
@@ -373,17 +495,95 @@ void StrategyGeometricMultiLevel::RunBenchmark(const StrategyInput& input)
           planner_k_i->setName(name_algorithm_strat);
         }
         std::cout << "adding planner with ambient space " << si_vec_k.back()->getStateDimension() << std::endl;
-        benchmark.addPlanner(planner_k_i);
-        planner_ctr++;
+        planners.push_back(planner_k_i);
       }
     }else{
-      benchmark.addPlanner(GetPlanner(binput.algorithms.at(k), stratifications.at(0)));
-      planner_ctr++;
+      planners.push_back(GetPlanner(binput.algorithms.at(k), stratifications.at(0)));
     }
   }
+  return planners;
+}
+
+void StrategyGeometricMultiLevel::RunBenchmark(const StrategyInput& input)
+{
+  //benchmark runs report their solutions without validating them afterwards
+  if(input.lazy_edges){
+    std::cout << "lazyEdges is not supported in benchmarks." << std::endl;
+    throw "Lazy edges in benchmark.";
+  }
+  BenchmarkInput binput(input.name_algorithm);
+
+  std::vector<OMPLGeometricStratificationPtr> stratifications;
+  for(uint k = 0; k < input.cspace_stratifications.size(); k++){
+    std::vector<CSpaceOMPL*> cspace_strat_k = input.cspace_stratifications.at(k);
+    OMPLGeometricStratificationPtr stratification = OMPLGeometricStratificationFromCSpaceStratification(input, cspace_strat_k);
+    stratifications.push_back(stratification);
+  }
+  if(stratifications.empty()) 
+  {
+    OMPL_INFORM("No stratifications specified. No algorithm is run");
+    return;
+  }
+  uint k_largest_ambient_space = 0;
+  uint largest_ambient_space_dimension = 0;
+  for(uint k = 0; k < stratifications.size(); k++){
+    const ob::SpaceInformationPtr sik = stratifications.at(k)->si_vec.back();
+    uint dk = sik->getStateDimension();
+    if(dk > largest_ambient_space_dimension){
+      k_largest_ambient_space = k;
+      largest_ambient_space_dimension = dk;
+    }
+  }
+
+  std::cout << "Largest Ambient Space Dimension for Benchmark:" << largest_ambient_space_dimension << std::endl;
+  const ob::SpaceInformationPtr si = stratifications.at(k_largest_ambient_space)->si_vec.back();
+  const ob::ProblemDefinitionPtr pdef = stratifications.at(k_largest_ambient_space)->pdef;
+
+
+  std::string environment_name = util::GetFileBasename(input.environment_name);
+  std::string file_benchmark = environment_name+"_"+util::GetCurrentDateTimeString();
+  std::string output_file_without_extension = util::GetDataFolder()+"/benchmarks/"+file_benchmark;
+  std::string log_file = output_file_without_extension+".log";
+  std::string xml_file = output_file_without_extension+".xml";
 
   CSpaceOMPL *cspace = input.cspace_stratifications.at(k_largest_ambient_space).back();
 
+  //each worker plans on its own space information (with its own validity
+  //checker and problem definition). State spaces are shared.
+  auto allocateWorker = [&]() -> BenchmarkWorker
+  {
+    std::vector<OMPLGeometricStratificationPtr> stratifications_w;
+    for(uint k = 0; k < input.cspace_stratifications.size(); k++){
+      stratifications_w.push_back(
+          OMPLGeometricStratificationFromCSpaceStratification(input, input.cspace_stratifications.at(k), true));
+    }
+    const ob::SpaceInformationPtr si_w = stratifications_w.at(k_largest_ambient_space)->si_vec.back();
+    const ob::ProblemDefinitionPtr pdef_w = stratifications_w.at(k_largest_ambient_space)->pdef;
+
+    BenchmarkWorker worker;
+    worker.setup = std::make_shared<og::SimpleSetup>(si_w);
+    worker.setup->setStartAndGoalStates(
+        cspace->ConfigToOMPLState(input.q_init), cspace->ConfigToOMPLState(input.q_goal), input.epsilon_goalregion);
+    si_w->setup();
+    pdef_w->setOptimizationObjective( GetOptimizationObjective(si_w) );
+
+    worker.planners = GetBenchmarkPlanners(binput, stratifications_w, k_largest_ambient_space);
+    for(uint k = 0; k < worker.planners.size(); k++){
+      worker.planners.at(k)->setProblemDefinition(worker.setup->getProblemDefinition());
+      worker.planners.at(k)->setup();
+    }
+    return worker;
+  };
+
+  og::SimpleSetup ss(si);
+  BenchmarkParallel benchmark(ss, environment_name, allocateWorker, binput.threads);
+
+  std::vector<ob::PlannerPtr> planners = GetBenchmarkPlanners(binput, stratifications, k_largest_ambient_space);
+  for(uint k = 0; k < planners.size(); k++){
+    benchmark.addPlanner(planners.at(k));
+  }
+  uint planner_ctr = planners.size();
+
   ob::ScopedState<> start = cspace->ConfigToOMPLState(input.q_init);
   ob::ScopedState<> goal  = cspace->ConfigToOMPLState(input.q_goal);
   ss.setStartAndGoalStates(start, goal, input.epsilon_goalregion);
@@ -409,13 +609,15 @@ void StrategyGeometricMultiLevel::RunBenchmark(const StrategyInput& input)
   std::cout << std::string(80, '-') << std::endl;
   std::cout << "BENCHMARKING" << std::endl;
 
-  double worst_case_time_estimate_in_seconds = planner_ctr*binput.runCount*binput.maxPlanningTime;
+  uint runs_per_thread = ceil(planner_ctr*binput.runCount/(double)benchmark.GetNumberOfThreads());
+  double worst_case_time_estimate_in_seconds = runs_per_thread*binput.maxPlanningTime;
   double worst_case_time_estimate_in_minutes = worst_case_time_estimate_in_seconds/60.0;
   double worst_case_time_estimate_in_hours = worst_case_time_estimate_in_minutes/60.0;
   all_runs = planner_ctr * binput.runCount;
   std::cout << "Number of Planners           : " << planner_ctr << std::endl;
   std::cout << "Number of Runs Per Planner   : " << binput.runCount << std::endl;
   std::cout << "Time Per Run (s)             : " << binput.maxPlanningTime << std::endl;
+  std::cout << "Number of Threads            : " << benchmark.GetNumberOfThreads() << std::endl;
   std::cout << "Worst-case time requirement  : ";
 
   if(worst_case_time_estimate_in_hours < 1){
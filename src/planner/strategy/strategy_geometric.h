@@ -1,5 +1,7 @@
 #pragma once
 #include "planner/strategy/strategy.h"
+#include "planner/benchmark/benchmark_input.h"
+#include "planner/cspace/validitychecker/motion_validator_lazy.h"
 // #include <omplapp/config.h>
 
 namespace ob = ompl::base;
@@ -31,8 +33,33 @@ class StrategyGeometricMultiLevel: public Strategy{
         OMPLGeometricStratificationPtr stratification);
 
     void RunBenchmark(const StrategyInput& input);
+    //lazy validator of the last level used by the last Plan (nullptr if
+    //lazy edges are disabled)
+    const LazyMotionValidator* GetLazyMotionValidator() const;
+    //planners of a benchmark, all defined on the space information of the
+    //stratification with the largest ambient space
+    std::vector<ob::PlannerPtr> GetBenchmarkPlanners(const BenchmarkInput &binput,
+        std::vector<OMPLGeometricStratificationPtr> &stratifications,
+        uint k_largest_ambient_space);
+    //independentSpaceInformation: do not use the (cached) space information
+    //of the cspaces, but create new ones
     OMPLGeometricStratificationPtr OMPLGeometricStratificationFromCSpaceStratification
-    (const StrategyInput &input, std::vector<CSpaceOMPL*> cspace_levels );
+    (const StrategyInput &input, std::vector<CSpaceOMPL*> cspace_levels, bool independentSpaceInformation = false );
+
+  private:
+    void SolveLazy(const ob::PlannerTerminationCondition &ptc, const LazyMotionValidator *validator);
+    //installs LazyMotionValidators on all levels (lazy = true, only while
+    //SolveLazy runs) or restores the eager validators
+    void SetLazyEdges(bool lazy);
+
+    //lazy edge validation in Plan (multilevel roadmap planners only)
+    bool lazy_edges{false};
+    std::vector<ob::SpaceInformationPtr> si_levels;
+    std::vector<ob::MotionValidatorPtr> eager_validators;
+    std::shared_ptr<LazyMotionValidator> lazy_validator;
+
+    //planner data accumulated over consecutive steps
+    IncrementalPlannerData planner_data;
 
     // template<class T_Algorithm>
     // ob::PlannerPtr GetSharedMultiChartPtr( 
@@ -19,6 +19,10 @@ struct StrategyInput{
   std::string name_loadPath;
   double max_planning_time;
   double epsilon_goalregion;
+  //accept motions without checking them until they lie on a candidate
+  //solution path (multilevel roadmap planners in Plan, see
+  //LazyMotionValidator)
+  bool lazy_edges{false};
 
   std::vector<CSpaceOMPL*> cspace_levels;
   std::vector<std::vector<CSpaceOMPL*>> cspace_stratifications;
@@ -1,6 +1,10 @@
 #include "planner/strategy/strategy_kinodynamic.h"
 #include "planner/cspace/cspace_kinodynamic.h"
 #include "planner/benchmark/benchmark_input.h"
+#include "planner/benchmark/benchmark_output.h"
+#include "planner/benchmark/benchmark_parallel.h"
+#include "planner/benchmark/benchmark_kinodynamic.h"
+#include "planner/cspace/integrator/propagation_cache.h"
 #include "util.h"
 
 #include <ompl/geometric/planners/explorer/Explorer.h>
@@ -28,7 +32,10 @@
 #include <ompl/util/Time.h>
 #include <ompl/tools/benchmark/Benchmark.h>
 #include <ompl/base/objectives/PathLengthOptimizationObjective.h>
+#include <ompl/base/terminationconditions/IterationTerminationCondition.h>
 #include <boost/lexical_cast.hpp>
+#include <atomic>
+#include <mutex>
 
 namespace ot = ompl::tools;
 
@@ -39,9 +46,18 @@ static ob::OptimizationObjectivePtr getThresholdPathLengthObj(const ob::SpaceInf
   return obj;
 }
 
+static uint all_runs{0};
+
+void PreRunEventKinodynamic(const ob::PlannerPtr &planner)
+{
+  ClearKinodynamicRunStatistics(planner);
+}
+
 void PostRunEventKinodynamic(const ob::PlannerPtr &planner, ot::Benchmark::RunProperties &run)
 {
-  static uint pid = 0;
+  //called concurrently by the workers of BenchmarkParallel
+  static std::atomic<uint> pid{0};
+  static std::mutex mutex;
 
   ob::SpaceInformationPtr si = planner->getSpaceInformation();
   ob::ProblemDefinitionPtr pdef = planner->getProblemDefinition();
@@ -52,10 +68,20 @@ void PostRunEventKinodynamic(const ob::PlannerPtr &planner, ot::Benchmark::RunPr
   double time = boost::lexical_cast<double>(run["time REAL"]);
   double memory = boost::lexical_cast<double>(run["memory REAL"]);
 
-  std::cout << "Run " << pid << " [" << planner->getName() << "] " << (solved?"solved":"no solution") << "(time: "<< time << ", states: " << states << ", memory: " << memory << ")" << std::endl;
+  //same (single level) stratification properties as geometric benchmarks
+  uint N = si->getStateDimension();
+  run["stratification levels INTEGER"] = std::to_string(1);
+  run["stratification level0 dimension INTEGER"] = std::to_string(N);
+  run["stratification level0 nodes INTEGER"] = std::to_string(states);
+  run["stratification level0 feasible nodes INTEGER"] = std::to_string(states);
+
+  AddKinodynamicRunProperties(planner, run);
+  const KinodynamicRunStatistics &statistics = KinodynamicRunStatistics::Get();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::cout << "Run " << pid << "/" << all_runs << " [" << planner->getName() << "] " << (solved?"solved":"no solution") << "(time: "<< time << ", states: " << states << ", propagations: " << statistics.propagations << ", memory: " << memory << ")" << std::endl;
   std::cout << std::string(80, '-') << std::endl;
   pid++;
-
 }
 
 StrategyKinodynamicMultiLevel::StrategyKinodynamicMultiLevel()
@@ -119,17 +145,15 @@ ob::PlannerPtr StrategyKinodynamicMultiLevel::GetPlanner(std::string algorithm,
   return planner;
 
 }
-void StrategyKinodynamicMultiLevel::Init( const StrategyInput &input )
+void StrategyKinodynamicMultiLevel::GetSpaceInformation(const StrategyInput &input,
+    std::vector<ob::SpaceInformationPtr> &si_vec, ob::ProblemDefinitionPtr &pdef,
+    bool independentSpaceInformation)
 {
-  std::string algorithm = input.name_algorithm;
-
-  std::vector<ob::SpaceInformationPtr> si_vec; 
-  ob::ProblemDefinitionPtr pdef; 
-
+  si_vec.clear();
   for(uint k = 0; k < input.cspace_levels.size(); k++){
     CSpaceOMPL* cspace_levelk = input.cspace_levels.at(k);
-    // bool dynamic = cspace_levelk->isDynamic();
-    ob::SpaceInformationPtr sik = cspace_levelk->SpaceInformationPtr();
+    ob::SpaceInformationPtr sik = (independentSpaceInformation ?
+        cspace_levelk->CreateSpaceInformation() : cspace_levelk->SpaceInformationPtr());
 
     ob::ScopedState<> startk(sik);
     ob::ScopedState<> goalk(sik);
@@ -151,8 +175,11 @@ void StrategyKinodynamicMultiLevel::Init( const StrategyInput &input )
       pdef->setOptimizationObjective( getThresholdPathLengthObj(sik) );
     }
   }
+}
 
-  ob::StateSpacePtr spacek = si_vec.back()->getStateSpace();
+void StrategyKinodynamicMultiLevel::Init( const StrategyInput &input )
+{
+  std::string algorithm = input.name_algorithm;
 
   max_planning_time = input.max_planning_time;
 
@@ -162,9 +189,12 @@ void StrategyKinodynamicMultiLevel::Init( const StrategyInput &input )
 
   if(util::StartsWith(algorithm,"benchmark")){
     //No Init, directly execute benchmark
-    OMPL_ERROR("NYI");
-    throw "NYI";
+    RunBenchmark(input);
   }else{
+    std::vector<ob::SpaceInformationPtr> si_vec; 
+    ob::ProblemDefinitionPtr pdef; 
+    GetSpaceInformation(input, si_vec, pdef);
+
     planner = GetPlanner(algorithm, si_vec, pdef, input);
     planner->setup();
     planner->clear();
@@ -199,6 +229,12 @@ void StrategyKinodynamicMultiLevel::Plan( StrategyOutput &output)
   output.planner_time = ompl::time::seconds(ompl::time::now() - start);
   output.max_planner_time = max_planning_time;
 
+  oc::SpaceInformationPtr siC = std::dynamic_pointer_cast<oc::SpaceInformation>(planner->getSpaceInformation());
+  if(siC != nullptr){
+    PropagationCache *cache = dynamic_cast<PropagationCache*>(siC->getStatePropagator().get());
+    if(cache != nullptr) std::cout << *cache << std::endl;
+  }
+
   //###########################################################################
   ob::PlannerDataPtr pd( new ob::PlannerData(planner->getSpaceInformation()) );
   planner->getPlannerData(*pd);
@@ -215,9 +251,117 @@ void StrategyKinodynamicMultiLevel::Plan( StrategyOutput &output)
 void StrategyKinodynamicMultiLevel::Clear()
 {
   if(planner != nullptr) planner->clear();
+  planner_data.Clear();
 }
 void StrategyKinodynamicMultiLevel::Step(StrategyOutput &output)
 {
-  OMPL_ERROR("NYI");
-  throw "NYI";
+  ob::IterationTerminationCondition itc(1);
+  ob::PlannerTerminationCondition ptc(itc);
+
+  ompl::time::point start = ompl::time::now();
+  planner->solve(ptc);
+  output.planner_time = ompl::time::seconds(ompl::time::now() - start);
+  output.max_planner_time = max_planning_time;
+
+  //###########################################################################
+  //only copy vertices and edges added in this step
+  planner_data.Update(planner);
+  output.SetPlannerData(planner_data);
+  output.SetProblemDefinition(planner->getProblemDefinition());
+}
+
+void StrategyKinodynamicMultiLevel::RunBenchmark(const StrategyInput& input)
+{
+  BenchmarkInput binput(input.name_algorithm);
+
+  std::string environment_name = util::GetFileBasename(input.environment_name);
+  std::string file_benchmark = environment_name+"_"+util::GetCurrentDateTimeString();
+  std::string output_file_without_extension = util::GetDataFolder()+"/benchmarks/"+file_benchmark;
+  std::string log_file = output_file_without_extension+".log";
+  std::string xml_file = output_file_without_extension+".xml";
+
+  CSpaceOMPL *cspace = input.cspace_levels.back();
+
+  std::vector<std::string> algorithms;
+  for(uint k = 0; k < binput.algorithms.size(); k++){
+    if(binput.algorithms.at(k) == "optimizer"){
+      OMPL_WARN("Optimizer cannot be benchmarked (requires a path). Skipped.");
+      continue;
+    }
+    algorithms.push_back(binput.algorithms.at(k));
+  }
+
+  //each worker plans on its own space information (with its own validity
+  //checker, propagator and problem definition). State and control spaces are
+  //shared.
+  auto allocateWorker = [&]() -> BenchmarkWorker
+  {
+    std::vector<ob::SpaceInformationPtr> si_vec; 
+    ob::ProblemDefinitionPtr pdef; 
+    GetSpaceInformation(input, si_vec, pdef, true);
+
+    const oc::SpaceInformationPtr siC = dynamic_pointer_cast<oc::SpaceInformation>(si_vec.back());
+    if(siC == nullptr){
+      OMPL_ERROR("Kinodynamic benchmark requires a control SpaceInformationPtr on the last level.");
+      throw "NotControl";
+    }
+    InstallKinodynamicRunStatistics(siC);
+
+    BenchmarkWorker worker;
+    worker.csetup = std::make_shared<oc::SimpleSetup>(siC);
+    worker.csetup->setStartAndGoalStates(
+        cspace->ConfigVelocityToOMPLState(input.q_init, input.dq_init),
+        cspace->ConfigVelocityToOMPLState(input.q_goal, input.dq_goal), input.epsilon_goalregion);
+    siC->setup();
+    worker.csetup->getProblemDefinition()->setOptimizationObjective( getThresholdPathLengthObj(siC) );
+
+    for(uint k = 0; k < algorithms.size(); k++){
+      ob::PlannerPtr planner_k = GetPlanner(algorithms.at(k), si_vec, worker.csetup->getProblemDefinition(), input);
+      planner_k->setup();
+      worker.planners.push_back(planner_k);
+    }
+    return worker;
+  };
+
+  //runs serially if the (wrapped) validity checker is not thread-safe, e.g.
+  //for multi-agent cspaces (see BenchmarkParallel::IsThreadSafe)
+  BenchmarkWorker worker = allocateWorker();
+  BenchmarkParallel benchmark(*worker.csetup, environment_name, allocateWorker, binput.threads);
+  for(uint k = 0; k < worker.planners.size(); k++){
+    benchmark.addPlanner(worker.planners.at(k));
+  }
+  uint planner_ctr = worker.planners.size();
+
+  ot::Benchmark::Request req;
+  req.maxTime = binput.maxPlanningTime;
+  req.maxMem = binput.maxMemory;
+  req.runCount = binput.runCount;
+  req.simplify = false;
+  req.displayProgress = true;
+
+  benchmark.setPreRunEvent(std::bind(&PreRunEventKinodynamic, std::placeholders::_1));
+  benchmark.setPostRunEvent(std::bind(&PostRunEventKinodynamic, std::placeholders::_1, std::placeholders::_2));
+
+  //############################################################################
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "BENCHMARKING (KINODYNAMIC)" << std::endl;
+
+  uint runs_per_thread = ceil(planner_ctr*binput.runCount/(double)benchmark.GetNumberOfThreads());
+  all_runs = planner_ctr * binput.runCount;
+  std::cout << "Number of Planners           : " << planner_ctr << std::endl;
+  std::cout << "Number of Runs Per Planner   : " << binput.runCount << std::endl;
+  std::cout << "Time Per Run (s)             : " << binput.maxPlanningTime << std::endl;
+  std::cout << "Number of Threads            : " << benchmark.GetNumberOfThreads() << std::endl;
+  std::cout << "Worst-case time requirement  : " << runs_per_thread*binput.maxPlanningTime << "s" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  //############################################################################
+
+  benchmark.benchmark(req);
+  benchmark.saveResultsToFile(log_file.c_str());
+
+  BenchmarkOutput boutput(benchmark.getRecordedExperimentData());
+  boutput.Save(xml_file.c_str());
+  boutput.PrintPDF();
+
+  UninstallKinodynamicRunStatistics(worker.csetup->getSpaceInformation());
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "planner/strategy/strategy.h"
+#include "planner/strategy/incremental_planner_data.h"
 //#include <omplapp/config.h>
 
 namespace ob = ompl::base;
@@ -20,9 +21,17 @@ class StrategyKinodynamicMultiLevel: public Strategy{
         std::vector<ob::SpaceInformationPtr> si_vec, 
         ob::ProblemDefinitionPtr pdef,
         const StrategyInput& input);
-    // void RunBenchmark(
-    //     const StrategyInput& input,
-    //     std::vector<oc::SpaceInformationPtr> si_vec, 
-    //     std::vector<ob::ProblemDefinitionPtr> pdef_vec);
+    void RunBenchmark(const StrategyInput& input);
 
+  private:
+    //space informations of all levels (last one is a control space
+    //information) and problem definition on the last level.
+    //independentSpaceInformation: do not use the (cached) space information
+    //of the cspaces, but create new ones
+    void GetSpaceInformation(const StrategyInput &input,
+        std::vector<ob::SpaceInformationPtr> &si_vec, ob::ProblemDefinitionPtr &pdef,
+        bool independentSpaceInformation = false);
+
+    //planner data accumulated over consecutive steps
+    IncrementalPlannerData planner_data;
 };
@@ -14,6 +14,17 @@ void StrategyOutput::SetPlannerData( ob::PlannerDataPtr pd_ ){
   pd->decoupleFromPlanner();
   pd->computeEdgeWeights();
 }
+void StrategyOutput::SetPlannerData( const IncrementalPlannerData &pdi ){
+  pd = pdi.GetPlannerDataPtr();
+  generation = pdi.GetGeneration();
+  vertices_added = pdi.GetNumberOfAddedVertices();
+  edges_added = pdi.GetNumberOfAddedEdges();
+  edges_removed = pdi.GetNumberOfRemovedEdges();
+}
+bool StrategyOutput::IsPlannerDataUnchanged() const{
+  //the first update (or planner data which is not incremental) is a change
+  return generation > 1 && vertices_added == 0 && edges_added == 0 && edges_removed == 0;
+}
 void StrategyOutput::SetProblemDefinition( ob::ProblemDefinitionPtr pdef_ ){
   pdef = pdef_;
 }
@@ -67,6 +78,7 @@ ob::PathPtr StrategyOutput::getShortestPathOMPL(){
   if(cspace->isDynamic()){
     oc::PathControl cpath = static_cast<oc::PathControl&>(*path);
     cpath.interpolate();
+    path = std::make_shared<oc::PathControl>(cpath);
   }else{
 
     og::PathGeometric gpath = static_cast<og::PathGeometric&>(*path);
@@ -87,6 +99,7 @@ ob::PathPtr StrategyOutput::getShortestPathOMPL(){
     if(!gpath.check()){
       std::cout << "WARNING: path is not valid. Unsuccessfully tried to repair it for " << ctr-1 << " iterations." << std::endl;
     }
+    path = std::make_shared<og::PathGeometric>(gpath);
   }
 
   return path;
@@ -113,8 +126,28 @@ std::vector<Config> StrategyOutput::GetShortestPath(){
 //}
 
 typedef Tree<ob::PlannerDataPtr> PTree;
+typedef std::map<std::vector<int>, RoadmapPtr> RoadmapsByPath;
 
-void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std::vector<CSpaceOMPL*> cspace_levels)
+//roadmaps of the hierarchy before it is recreated, to carry over their
+//buffers to the new roadmaps at the same path
+void CollectRoadmaps( Node<RoadmapPtr> *node, std::vector<int> &path, RoadmapsByPath &roadmaps)
+{
+  if(node == nullptr) return;
+  if(node->content != nullptr) roadmaps[path] = node->content;
+  for(uint k = 0; k < node->children.size(); k++){
+    path.push_back(k);
+    CollectRoadmaps(node->children.at(k), path, roadmaps);
+    path.pop_back();
+  }
+}
+
+void ShareBuffersWithPrevious( RoadmapPtr roadmap, const std::vector<int> &path, const RoadmapsByPath &previous)
+{
+  auto it = previous.find(path);
+  if(it != previous.end()) roadmap->ShareBuffers(*it->second);
+}
+
+void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std::vector<CSpaceOMPL*> cspace_levels, const RoadmapsByPath &previous, bool write_samples)
 {
 
   if(current->content != nullptr)
@@ -135,6 +168,8 @@ void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std:
 
       roadmap_k = std::make_shared<Roadmap>(pdi, cspace_levels.back(), cspace_levels.back());
       std::vector<int> hindex;
+      std::vector<int> path{(int)hierarchy->NumberChildren(hindex)};
+      ShareBuffersWithPrevious(roadmap_k, path, previous);
       hierarchy->AddNode( roadmap_k, hindex);
       if(current->children.size()>0)
       {
@@ -151,6 +186,7 @@ void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std:
       uint level = v->getLevel();
 
       roadmap_k = std::make_shared<Roadmap>(pdi, cspace_levels.back(), cspace_levels.at(level));
+      ShareBuffersWithPrevious(roadmap_k, path, previous);
       //std::cout << "level " << level << "," << path << " : " << pdi->numVertices() << " | " << pdi->numEdges() << std::endl;
       while(!hierarchy->NodeExists(path)){
         std::vector<int> ppath(path.begin(), path.end()-1);
@@ -158,9 +194,14 @@ void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std:
       }
       hierarchy->UpdateNode( roadmap_k, path);
     }
-    std::string rname = cspace_levels.back()->GetName();//RobotPtr()->name;
-    std::string fname = "../data/samples/cspace_robot_"+rname+".samples";
-    roadmap_k->Save(fname.c_str());
+    if(write_samples){
+      std::string rname = cspace_levels.back()->GetName();//RobotPtr()->name;
+      std::string fname = "../data/samples/cspace_robot_"+rname+".samples";
+      //written in background (skipped if roadmap did not change)
+      RoadmapSamples samples;
+      roadmap_k->GetSamples(samples);
+      RoadmapSampleWriter::Get().Write(fname, samples);
+    }
     // std::cout << "Wrote samples to " << fname << std::endl;
   }
 
@@ -169,7 +210,7 @@ void RecurseTraverseTree( PTree *current, HierarchicalRoadmapPtr hierarchy, std:
     return;
   }
   for(uint k = 0; k < current->children.size(); k++){
-    RecurseTraverseTree(current->children.at(k), hierarchy, cspace_levels);
+    RecurseTraverseTree(current->children.at(k), hierarchy, cspace_levels, previous, write_samples);
   }
 }
 
@@ -244,9 +285,14 @@ void StrategyOutput::GetHierarchicalRoadmap( HierarchicalRoadmapPtr hierarchy, s
     }
   }
 
+  RoadmapsByPath previous;
+  std::vector<int> hpath;
+  CollectRoadmaps(hierarchy->GetRootNode(), hpath, previous);
+
   hierarchy->DeleteAllNodes();
   hierarchy->AddRootNode( std::make_shared<Roadmap>() ); 
-  RecurseTraverseTree(root, hierarchy, cspace_levels);
+  //samples are only copied if the planner data changed since the last step
+  RecurseTraverseTree(root, hierarchy, cspace_levels, previous, !IsPlannerDataUnchanged());
 }
 
 std::ostream& operator<< (std::ostream& out, const StrategyOutput& so) 
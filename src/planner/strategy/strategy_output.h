@@ -2,6 +2,7 @@
 #include "elements/path_pwl.h"
 #include "elements/hierarchical_roadmap.h"
 #include "planner/cspace/cspace.h"
+#include "planner/strategy/incremental_planner_data.h"
 // #include <omplapp/config.h>
 #include <ompl/base/PlannerData.h>
 #include <ompl/base/ProblemDefinition.h>
@@ -21,8 +22,12 @@ struct StrategyOutput{
     void SetShortestPath( std::vector<Config> );
 
     void GetHierarchicalRoadmap( HierarchicalRoadmapPtr hierarchy, std::vector<CSpaceOMPL*> cspace_levels);
+    //incremental planner data which did not change in the last update
+    bool IsPlannerDataUnchanged() const;
 
     void SetPlannerData( ob::PlannerDataPtr pd_ );
+    //planner data is already decoupled from planner and has edge weights
+    void SetPlannerData( const IncrementalPlannerData &pdi );
     void SetProblemDefinition( ob::ProblemDefinitionPtr pdef_ );
     ob::PlannerDataPtr GetPlannerDataPtr();
     ob::ProblemDefinitionPtr GetProblemDefinitionPtr();
@@ -39,6 +44,12 @@ struct StrategyOutput{
     double planner_time{-1};
     double max_planner_time{-1};
 
+    //incremental planner data: number of updates and size of last update
+    uint generation{0};
+    uint vertices_added{0};
+    uint edges_added{0};
+    uint edges_removed{0};
+
   private:
 
     std::vector<Config> PathGeometricToConfigPath(og::PathGeometric &path);
@@ -0,0 +1,85 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include "planner/cspace/validitychecker/validity_checker_ompl.h"
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+//Clearance queries along random walks (neighbouring states, as queried by
+//clearance objectives, clearance samplers and path optimization) on the
+//geometric cspace of the first robot of the environment, without and with
+//ClearanceCache. Reports time, hit rate, and the error of the cached lower
+//bounds against the exact clearance. A negative error means that the
+//neighborhood constant is too large for the robot, i.e. not conservative.
+//
+//Usage: ./clearance_cache_benchmark <environment.xml> [neighborhood constant] [step size]
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  double neighborhood = 1;
+  double step = 0.005;
+  if(argc > 2) neighborhood = std::atof(argv[2]);
+  if(argc > 3) step = std::atof(argv[3]);
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  RobotWorld *world = env.GetWorldPtr();
+
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  GeometricCSpaceOMPL *cspace = factory.MakeGeometricCSpace(world, robot_idx);
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  OMPLValidityChecker *checker = dynamic_cast<OMPLValidityChecker*>(si->getStateValidityChecker().get());
+  if(checker == nullptr){
+    std::cout << "Validity checker is not an OMPLValidityChecker." << std::endl;
+    return 1;
+  }
+
+  //random walks: states along each walk are step apart
+  uint Nwalks = 100;
+  uint Nsteps = 1000;
+  ob::StateSamplerPtr sampler = si->allocStateSampler();
+  std::vector<ob::State*> states(Nwalks*Nsteps, nullptr);
+  si->allocStates(states);
+  for(uint i = 0; i < Nwalks; i++){
+    sampler->sampleUniform(states.at(i*Nsteps));
+    for(uint j = 1; j < Nsteps; j++){
+      sampler->sampleUniformNear(states.at(i*Nsteps+j), states.at(i*Nsteps+j-1), step);
+    }
+  }
+
+  std::vector<double> exact(states.size());
+  ompl::time::point start = ompl::time::now();
+  for(uint k = 0; k < states.size(); k++){
+    exact.at(k) = checker->clearance(states.at(k));
+  }
+  double t_exact = ompl::time::seconds(ompl::time::now() - start);
+
+  double error = pin->clearance_cache_error;
+  checker->SetNeighborhood(neighborhood);
+  checker->SetClearanceCache(100000, pin->clearance_cache_resolution, error);
+
+  double maxError = 0;
+  double minError = dInf;
+  start = ompl::time::now();
+  for(uint k = 0; k < states.size(); k++){
+    double d = checker->clearance(states.at(k));
+    double e = exact.at(k) - d;
+    if(e > maxError) maxError = e;
+    if(e < minError) minError = e;
+  }
+  double t_cached = ompl::time::seconds(ompl::time::now() - start);
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Clearance of " << states.size() << " states (" << Nwalks << " random walks, step " << step
+    << ", robot " << world->robots[robot_idx]->name << ")" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "exact" << std::right << std::setw(12) << t_exact << "s" << std::endl;
+  std::cout << std::left << std::setw(16) << "cached" << std::right << std::setw(12) << t_cached << "s"
+    << std::setw(10) << std::setprecision(3) << t_exact/t_cached << "x" << std::endl;
+  std::cout << *checker->GetClearanceCache() << std::endl;
+  std::cout << "error of cached lower bounds: [" << minError << "," << maxError << "] (max " << error << ")" << std::endl;
+
+  si->freeStates(states);
+  return 0;
+}
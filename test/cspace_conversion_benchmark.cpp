@@ -0,0 +1,109 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include <ompl/util/Time.h>
+#include <functional>
+#include <iomanip>
+
+//Measures the number of OMPL state <--> Klampt config conversions per second
+//for each cspace type which can be constructed for the first robot of the
+//given environment.
+//
+//Usage: ./cspace_conversion_benchmark <environment.xml> [number of conversions]
+
+const uint Nsamples = 1000;
+
+void BenchmarkCSpace(const std::string &name, CSpaceOMPL *cspace, uint Nconversions)
+{
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  ob::StateSamplerPtr sampler = si->allocStateSampler();
+
+  std::vector<ob::State*> states;
+  for(uint k = 0; k < Nsamples; k++){
+    ob::State *s = si->allocState();
+    sampler->sampleUniform(s);
+    states.push_back(s);
+  }
+
+  //allocating conversion
+  double checksum = 0;
+  ompl::time::point t_start = ompl::time::now();
+  for(uint k = 0; k < Nconversions; k++){
+    Config q = cspace->OMPLStateToConfig(states.at(k % Nsamples));
+    checksum += q(0);
+  }
+  double t_alloc = ompl::time::seconds(ompl::time::now() - t_start);
+
+  //in-place conversion
+  Config q;
+  t_start = ompl::time::now();
+  for(uint k = 0; k < Nconversions; k++){
+    cspace->OMPLStateToConfig(states.at(k % Nsamples), q);
+    checksum -= q(0);
+  }
+  double t_inplace = ompl::time::seconds(ompl::time::now() - t_start);
+
+  //config to state
+  ob::State *s = si->allocState();
+  t_start = ompl::time::now();
+  for(uint k = 0; k < Nconversions; k++){
+    cspace->ConfigToOMPLState(q, s);
+  }
+  double t_toompl = ompl::time::seconds(ompl::time::now() - t_start);
+  si->freeState(s);
+
+  for(uint k = 0; k < states.size(); k++){
+    si->freeState(states.at(k));
+  }
+
+  std::cout << std::left << std::setw(16) << name
+    << std::right << std::setw(16) << Nconversions/t_alloc
+    << std::setw(16) << Nconversions/t_inplace
+    << std::setw(16) << Nconversions/t_toompl
+    << (fabs(checksum) > 1e-10 ? "  [MISMATCH]" : "") << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  uint Nconversions = 1e6;
+  if(argc > 2){
+    Nconversions = std::atoi(argv[2]);
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  RobotWorld *world = env.GetWorldPtr();
+  uint Nklampt = world->robots[robot_idx]->q.size();
+
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+
+  std::vector<std::pair<std::string, std::function<CSpaceOMPL*()>>> cspaces;
+  cspaces.push_back(std::make_pair("SE3RN", [&](){ return factory.MakeGeometricCSpace(world, robot_idx); }));
+  cspaces.push_back(std::make_pair("SE2RN", [&](){ return factory.MakeGeometricCSpaceSE2RN(world, robot_idx); }));
+  cspaces.push_back(std::make_pair("SO2RN", [&](){ return factory.MakeGeometricCSpaceSO2RN(world, robot_idx); }));
+  cspaces.push_back(std::make_pair("FixedBase", [&](){ return factory.MakeGeometricCSpaceFixedBase(world, robot_idx); }));
+  cspaces.push_back(std::make_pair("RN", [&](){ return factory.MakeGeometricCSpaceRN(world, robot_idx, Nklampt); }));
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Conversions per second (robot " << world->robots[robot_idx]->name
+    << ", " << Nconversions << " conversions)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "CSpace"
+    << std::right << std::setw(16) << "OMPL->Klampt"
+    << std::setw(16) << "(in-place)"
+    << std::setw(16) << "Klampt->OMPL" << std::endl;
+
+  for(uint k = 0; k < cspaces.size(); k++){
+    const std::string &name = cspaces.at(k).first;
+    try{
+      CSpaceOMPL *cspace = cspaces.at(k).second();
+      BenchmarkCSpace(name, cspace, Nconversions);
+    }catch(const char *e){
+      std::cout << std::left << std::setw(16) << name << " skipped (" << e << ")" << std::endl;
+    }catch(const std::exception &e){
+      std::cout << std::left << std::setw(16) << name << " skipped (" << e.what() << ")" << std::endl;
+    }
+  }
+  return 0;
+}
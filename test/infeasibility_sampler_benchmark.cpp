@@ -0,0 +1,59 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include "planner/strategy/infeasibility_sampler.h"
+#include <ompl/base/ProblemDefinition.h>
+#include <iomanip>
+#include <thread>
+
+//Samples per second of the InfeasibilitySampler for an increasing number of
+//threads on the geometric cspace of the first robot of the environment. Each
+//run samples for a fixed time; the estimated infeasible fraction of the runs
+//should agree within their errors.
+//
+//Usage: ./infeasibility_sampler_benchmark <environment.xml> [seconds per run]
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  double T = 2;
+  if(argc > 2){
+    T = std::atof(argv[2]);
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  RobotWorld *world = env.GetWorldPtr();
+
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  GeometricCSpaceOMPL *cspace = factory.MakeGeometricCSpace(world, robot_idx);
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "InfeasibilitySampler (robot " << world->robots[robot_idx]->name << ", "
+    << si->getStateDimension() << " dimensions, " << T << "s per run)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(14) << "samples/s" << std::setw(10) << "speedup"
+    << std::setw(14) << "infeasible" << std::setw(12) << "error" << std::setw(12) << "MB" << std::endl;
+
+  uint Nmax = std::max(1u, std::thread::hardware_concurrency());
+  double samples_single = 0;
+  for(uint Nthreads = 1; Nthreads <= Nmax; Nthreads *= 2){
+    ob::ProblemDefinitionPtr pdef = std::make_shared<ob::ProblemDefinition>(si);
+    auto sampler = std::make_shared<ompl::geometric::InfeasibilitySampler>(si);
+    sampler->setProblemDefinition(pdef);
+    sampler->setNumberOfThreads(Nthreads);
+    sampler->setup();
+
+    sampler->solve(ob::timedPlannerTerminationCondition(T));
+
+    double samples = sampler->getNumberOfSamples()/T;
+    if(Nthreads == 1) samples_single = samples;
+    std::cout << std::setw(10) << Nthreads << std::setw(14) << (unsigned long)samples
+      << std::setw(10) << std::setprecision(3) << samples/samples_single
+      << std::setw(14) << sampler->getInfeasibleFraction()
+      << std::setw(12) << sampler->getInfeasibleFractionError()
+      << std::setw(12) << sampler->getMemory()/(1024.0*1024.0) << std::endl;
+  }
+  return 0;
+}
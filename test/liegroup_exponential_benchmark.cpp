@@ -0,0 +1,93 @@
+#include "planner/cspace/integrator/liegroupintegrator.h"
+#include <ompl/util/RandomNumbers.h>
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+using namespace Math3D;
+
+//Compares the closed-form SE(3) exponential of LieGroupIntegrator against the
+//generic Pade approximation: maximum entrywise error for twists of different
+//magnitude (including the small-angle branch) and exponentials per second.
+//
+//Usage: ./liegroup_exponential_benchmark [number of exponentials]
+//Returns 1 if the error exceeds the tolerance.
+
+const uint Nsamples = 1000;
+const double tolerance = 1e-10;
+
+double MaxError(const Matrix4 &A, const Matrix4 &B)
+{
+  double e = 0;
+  for(int i = 0; i < 4; i++){
+    for(int j = 0; j < 4; j++){
+      e = std::max(e, fabs(A(i,j) - B(i,j)));
+    }
+  }
+  return e;
+}
+
+int main(int argc, char **argv)
+{
+  uint Nexponentials = 1e6;
+  if(argc > 1){
+    Nexponentials = std::atoi(argv[1]);
+  }
+
+  LieGroupIntegrator integrator;
+  ompl::RNG rng;
+
+  //###########################################################################
+  //correctness
+  //###########################################################################
+  bool success = true;
+  std::vector<double> scales = {0, 1e-8, 1e-4, 1e-2, 1e-1, 1, M_PI, 10};
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "|w| scale"
+    << std::right << std::setw(16) << "max error" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  for(uint k = 0; k < scales.size(); k++){
+    double e = 0;
+    for(uint j = 0; j < Nsamples; j++){
+      ControlInput u(6);
+      for(uint i = 0; i < 3; i++) u(i) = rng.uniformReal(-1, 1);
+      for(uint i = 3; i < 6; i++) u(i) = scales.at(k)*rng.uniformReal(-1, 1);
+      Matrix4 x = integrator.SE3Derivative(u);
+      e = std::max(e, MaxError(integrator.MatrixExponential(x), integrator.MatrixExponentialPade(x)));
+    }
+    std::cout << std::left << std::setw(16) << scales.at(k)
+      << std::right << std::setw(16) << e << (e > tolerance ? "  [FAILED]" : "") << std::endl;
+    if(e > tolerance) success = false;
+  }
+
+  //###########################################################################
+  //throughput
+  //###########################################################################
+  std::vector<Matrix4> twists;
+  for(uint j = 0; j < Nsamples; j++){
+    ControlInput u(6);
+    for(uint i = 0; i < 6; i++) u(i) = 0.1*rng.uniformReal(-1, 1);
+    twists.push_back(integrator.SE3Derivative(u));
+  }
+
+  double checksum = 0;
+  ompl::time::point t_start = ompl::time::now();
+  for(uint k = 0; k < Nexponentials; k++){
+    checksum += integrator.MatrixExponentialPade(twists.at(k % Nsamples))(0,3);
+  }
+  double t_pade = ompl::time::seconds(ompl::time::now() - t_start);
+
+  t_start = ompl::time::now();
+  for(uint k = 0; k < Nexponentials; k++){
+    checksum -= integrator.MatrixExponential(twists.at(k % Nsamples))(0,3);
+  }
+  double t_closed = ompl::time::seconds(ompl::time::now() - t_start);
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Exponentials per second (" << Nexponentials << " exponentials)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "Pade" << std::right << std::setw(16) << Nexponentials/t_pade << std::endl;
+  std::cout << std::left << std::setw(16) << "closed-form" << std::right << std::setw(16) << Nexponentials/t_closed
+    << "  (speedup " << t_pade/t_closed << ", checksum " << checksum << ")" << std::endl;
+
+  return (success ? 0 : 1);
+}
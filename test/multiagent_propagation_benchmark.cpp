@@ -0,0 +1,105 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include "planner/cspace/integrator/multiagent.h"
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+//Measures the propagation throughput of MultiAgentIntegrator as a function of
+//the number of agents, propagating serially and with a thread pool. Agents
+//alternate between kinodynamic (even) and kinematic (odd) cspaces, i.e. the
+//fleet is mixed as soon as there are two agents. The robots of the
+//environment are used in order.
+//
+//Usage: ./multiagent_propagation_benchmark <environment.xml> [number of propagations]
+
+const uint Nsamples = 1000;
+
+double TimePropagation(MultiAgentIntegrator *integrator, oc::SpaceInformationPtr siC,
+    const std::vector<ob::State*> &states, const std::vector<oc::Control*> &controls,
+    uint Npropagations)
+{
+  ob::State *result = siC->allocState();
+  ompl::time::point t_start = ompl::time::now();
+  for(uint k = 0; k < Npropagations; k++){
+    integrator->propagate(states.at(k % Nsamples), controls.at(k % Nsamples), 0.1, result);
+  }
+  double t = ompl::time::seconds(ompl::time::now() - t_start);
+  siC->freeState(result);
+  return t;
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  uint Npropagations = 1e4;
+  if(argc > 2){
+    Npropagations = std::atoi(argv[2]);
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  RobotWorld *world = env.GetWorldPtr();
+  uint Nrobots = world->robots.size();
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Propagations per second (" << Npropagations << " propagations, "
+    << ThreadPool().GetNumberOfThreads() << " threads)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(10) << "Agents"
+    << std::right << std::setw(16) << "serial"
+    << std::setw(16) << "parallel"
+    << std::setw(16) << "speedup" << std::endl;
+
+  for(uint K = 1; K <= Nrobots; K *= 2){
+    try{
+      std::vector<CSpaceOMPL*> cspaces;
+      for(uint k = 0; k < K; k++){
+        CSpaceFactory factory(pin->GetCSpaceInput(k));
+        if(k % 2 == 0){
+          cspaces.push_back(factory.MakeKinodynamicCSpace(world, k));
+        }else{
+          cspaces.push_back(factory.MakeGeometricCSpace(world, k));
+        }
+      }
+      CSpaceFactory factory(pin->GetCSpaceInput(0));
+      CSpaceOMPLMultiAgent *cspace = factory.MakeGeometricCSpaceMultiAgent(cspaces);
+
+      oc::SpaceInformationPtr siC = std::static_pointer_cast<oc::SpaceInformation>(cspace->SpaceInformationPtr());
+      MultiAgentIntegrator integrator(siC, cspace, cspaces);
+
+      ob::StateSamplerPtr sampler = siC->allocStateSampler();
+      oc::ControlSamplerPtr csampler = siC->allocControlSampler();
+      std::vector<ob::State*> states;
+      std::vector<oc::Control*> controls;
+      for(uint k = 0; k < Nsamples; k++){
+        ob::State *s = siC->allocState();
+        sampler->sampleUniform(s);
+        states.push_back(s);
+        oc::Control *c = siC->allocControl();
+        csampler->sample(c);
+        controls.push_back(c);
+      }
+
+      integrator.SetNumberOfThreads(1);
+      double t_serial = TimePropagation(&integrator, siC, states, controls, Npropagations);
+      integrator.SetNumberOfThreads(0);
+      integrator.SetMinimumParallelAgents(2);
+      double t_parallel = TimePropagation(&integrator, siC, states, controls, Npropagations);
+
+      for(uint k = 0; k < Nsamples; k++){
+        siC->freeState(states.at(k));
+        siC->freeControl(controls.at(k));
+      }
+
+      std::cout << std::left << std::setw(10) << K
+        << std::right << std::setw(16) << Npropagations/t_serial
+        << std::setw(16) << Npropagations/t_parallel
+        << std::setw(16) << t_serial/t_parallel << std::endl;
+    }catch(const char *e){
+      std::cout << std::left << std::setw(10) << K << " skipped (" << e << ")" << std::endl;
+    }catch(const std::exception &e){
+      std::cout << std::left << std::setw(10) << K << " skipped (" << e.what() << ")" << std::endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+#include "environment_loader.h"
+#include "elements/path_pwl.h"
+#include "planner/cspace/cspace_factory.h"
+#include <ompl/util/Time.h>
+#include <ompl/util/RandomNumbers.h>
+
+//Evaluates a piecewise-linear path with many waypoints at many samples, both
+//for monotonically increasing parameters (like playing back a path) and for
+//random parameters.
+//
+//Usage: ./path_pwl_benchmark <environment.xml> [waypoints] [samples]
+
+//linear scan over the segments (reference for Eval)
+Config EvalReference(PathPiecewiseLinear &pwl, CSpaceOMPL *cspace, const std::vector<ob::State*> &states, double t)
+{
+  std::vector<double> interLength = pwl.GetLengthVector();
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  if(t <= 0) return cspace->OMPLStateToConfig(states.front());
+
+  double Tcum = 0;
+  for(uint i = 0; i < interLength.size(); i++){
+    double Tnext = interLength.at(i);
+    if(Tcum + Tnext > t){
+      ob::State *sm = si->allocState();
+      si->getStateSpace()->interpolate(states.at(i), states.at(i+1), (t-Tcum)/Tnext, sm);
+      Config q = cspace->OMPLStateToConfig(sm);
+      si->freeState(sm);
+      return q;
+    }
+    Tcum += Tnext;
+  }
+  return cspace->OMPLStateToConfig(states.back());
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  uint Nwaypoints = 1e4;
+  uint Nsamples = 1e6;
+  if(argc > 2) Nwaypoints = std::atoi(argv[2]);
+  if(argc > 3) Nsamples = std::atoi(argv[3]);
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  CSpaceOMPL *cspace = factory.MakeGeometricCSpace(env.GetWorldPtr(), robot_idx);
+
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  ob::StateSamplerPtr sampler = si->allocStateSampler();
+
+  auto gpath = std::make_shared<og::PathGeometric>(si);
+  ob::State *s = si->allocState();
+  for(uint k = 0; k < Nwaypoints; k++){
+    sampler->sampleUniform(s);
+    gpath->append(s);
+  }
+  si->freeState(s);
+
+  PathPiecewiseLinear pwl(gpath, cspace, cspace);
+  double L = pwl.GetLength();
+  const std::vector<ob::State*> &states = gpath->getStates();
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Path with " << Nwaypoints << " waypoints (length " << L << "), "
+    << Nsamples << " samples" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+
+  //############################################################################
+  //correctness against linear scan
+  //############################################################################
+  ompl::RNG rng;
+  double maxError = 0;
+  for(uint k = 0; k < 1000; k++){
+    double t = rng.uniformReal(0, L);
+    Config q = pwl.Eval(t);
+    Config qref = EvalReference(pwl, cspace, states, t);
+    maxError = std::max(maxError, (q - qref).norm());
+  }
+  std::cout << "Max deviation from linear scan : " << maxError << std::endl;
+
+  //############################################################################
+  //monotone parameters
+  //############################################################################
+  Config q;
+  double checksum = 0;
+  ompl::time::point t_start = ompl::time::now();
+  for(uint k = 0; k < Nsamples; k++){
+    double t = L*k/(double)Nsamples;
+    pwl.Eval(t, q);
+    checksum += q(0);
+  }
+  double t_monotone = ompl::time::seconds(ompl::time::now() - t_start);
+
+  //############################################################################
+  //random parameters
+  //############################################################################
+  std::vector<double> ts;
+  for(uint k = 0; k < Nsamples; k++){
+    ts.push_back(rng.uniformReal(0, L));
+  }
+  t_start = ompl::time::now();
+  for(uint k = 0; k < Nsamples; k++){
+    pwl.Eval(ts.at(k), q);
+    checksum += q(0);
+  }
+  double t_random = ompl::time::seconds(ompl::time::now() - t_start);
+
+  t_start = ompl::time::now();
+  for(uint k = 0; k < Nsamples; k++){
+    Vector3 v = pwl.EvalVec3(ts.at(k));
+    checksum += v[0];
+  }
+  double t_vec3 = ompl::time::seconds(ompl::time::now() - t_start);
+
+  std::cout << "Eval (monotone)   : " << Nsamples/t_monotone << " samples/s (" << t_monotone << "s)" << std::endl;
+  std::cout << "Eval (random)     : " << Nsamples/t_random << " samples/s (" << t_random << "s)" << std::endl;
+  std::cout << "EvalVec3 (random) : " << Nsamples/t_vec3 << " samples/s (" << t_vec3 << "s)" << std::endl;
+  std::cout << "(checksum " << checksum << ")" << std::endl;
+  return 0;
+}
@@ -0,0 +1,281 @@
+#include "environment_loader_headless.h"
+#include "planner/planner.h"
+#include "planner/strategy/strategy.h"
+#include "planner/strategy/strategy_geometric.h"
+#include "planner/strategy/strategy_output.h"
+#include "planner/cspace/validitychecker/motion_validator_lazy.h"
+#include "util.h"
+#include <ompl/util/Console.h>
+#include <ompl/util/RandomNumbers.h>
+#include <ompl/util/Time.h>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+//Headless batch planning: runs each planner of each environment for a number
+//of trials, without GUI, simulation or GL context, and writes the per-phase
+//timings as JSON and/or CSV.
+//
+//Usage: ./planner_batch [--runs N] [--seed S] [--time T] [--lazy] [--json file]
+//                       [--csv file] <environment.xml> [<environment.xml> ..]
+//
+//  --runs : trials per planner (default 10)
+//  --seed : seed of the batch (default 1, OMPL does not accept 0). OMPL takes
+//           a seed only once per process, so trials are reproducible by
+//           rerunning the whole batch with the same seed and arguments.
+//  --time : overwrite maximum planning time of environments (seconds)
+//  --lazy : lazy edge validation (overwrites lazyEdges of environments,
+//           hierarchy:qmp|qmpstar|spqr only)
+//
+//Values of --runs, --seed and --time have to be positive numbers, unknown
+//options are rejected.
+//
+//path_length is the length of the simplified path, motion_checks counts
+//motions checked for collision, deferred_checks the motions accepted without
+//check in lazy mode (of the last level).
+
+struct TrialResult{
+  std::string environment;
+  std::string planner;
+  uint trial;
+  uint seed;
+  bool exact{false};
+  bool approximate{false};
+  double setup{0};
+  double planning{0};
+  double simplification{0};
+  double output{0};
+  double path_length{0};
+  uint vertices{0};
+  uint edges{0};
+  unsigned long motion_checks{0};
+  unsigned long deferred_checks{0};
+};
+
+//MotionPlanner without GUI, which records the time of each phase of
+//AdvanceUntilSolution
+class MotionPlannerHeadless: public MotionPlanner
+{
+  public:
+    MotionPlannerHeadless(RobotWorld *world_, PlannerInput& input_):
+      MotionPlanner(world_, input_)
+    {
+    }
+
+    void Run(TrialResult &result)
+    {
+      ompl::time::point t = ompl::time::now();
+      InitStrategy();
+      result.setup += ompl::time::seconds(ompl::time::now() - t);
+
+      StrategyOutput output(cspace_levels.back());
+      t = ompl::time::now();
+      strategy->Plan(output);
+      double Tplan = ompl::time::seconds(ompl::time::now() - t);
+      result.planning = output.planner_time;
+      result.exact = output.hasExactSolution();
+      result.approximate = output.hasApproximateSolution();
+
+      if(result.exact || result.approximate){
+        t = ompl::time::now();
+        ob::PathPtr path = output.getShortestPathOMPL();
+        result.simplification = ompl::time::seconds(ompl::time::now() - t);
+        result.path_length = path->length();
+      }
+
+      //planner data extraction (part of Plan) and roadmap hierarchy
+      t = ompl::time::now();
+      output.GetHierarchicalRoadmap(hierarchy, cspace_levels);
+      result.output = (Tplan - output.planner_time) + ompl::time::seconds(ompl::time::now() - t);
+
+      ob::PlannerDataPtr pd = output.GetPlannerDataPtr();
+      if(pd){
+        result.vertices = pd->numVertices();
+        result.edges = pd->numEdges();
+      }
+
+      //lazy validators are only installed while planning
+      const StrategyGeometricMultiLevel *geometric = dynamic_cast<const StrategyGeometricMultiLevel*>(strategy.get());
+      const LazyMotionValidator *lazy = (geometric ? geometric->GetLazyMotionValidator() : nullptr);
+      const ob::PlannerPtr planner = strategy->GetPlannerPtr();
+      const ob::MotionValidator *validator = lazy;
+      if(validator == nullptr && planner) validator = planner->getSpaceInformation()->getMotionValidator().get();
+      if(validator){
+        result.motion_checks = validator->getValidMotionCount() + validator->getInvalidMotionCount();
+        if(lazy != nullptr) result.deferred_checks = lazy->GetNumberOfDeferredChecks();
+      }
+    }
+};
+
+std::string Escape(const std::string &s)
+{
+  std::string e;
+  for(uint k = 0; k < s.size(); k++){
+    if(s.at(k) == '"' || s.at(k) == '\\') e += '\\';
+    e += s.at(k);
+  }
+  return e;
+}
+
+//quoted field, quotes are doubled (RFC 4180)
+std::string CSVField(const std::string &s)
+{
+  std::string e = "\"";
+  for(uint k = 0; k < s.size(); k++){
+    if(s.at(k) == '"') e += '"';
+    e += s.at(k);
+  }
+  return e + "\"";
+}
+
+void WriteJSON(const std::string &fname, const std::vector<TrialResult> &results)
+{
+  std::ofstream file(fname);
+  file << std::setprecision(9);
+  file << "[" << std::endl;
+  for(uint k = 0; k < results.size(); k++){
+    const TrialResult &r = results.at(k);
+    file << "  {\"environment\": \"" << Escape(r.environment) << "\""
+      << ", \"planner\": \"" << Escape(r.planner) << "\""
+      << ", \"trial\": " << r.trial
+      << ", \"seed\": " << r.seed
+      << ", \"exact_solution\": " << (r.exact?"true":"false")
+      << ", \"approximate_solution\": " << (r.approximate?"true":"false")
+      << ", \"time_setup\": " << r.setup
+      << ", \"time_planning\": " << r.planning
+      << ", \"time_simplification\": " << r.simplification
+      << ", \"time_output\": " << r.output
+      << ", \"path_length\": " << r.path_length
+      << ", \"vertices\": " << r.vertices
+      << ", \"edges\": " << r.edges
+      << ", \"motion_checks\": " << r.motion_checks
+      << ", \"deferred_checks\": " << r.deferred_checks
+      << "}" << (k+1 < results.size() ? "," : "") << std::endl;
+  }
+  file << "]" << std::endl;
+}
+
+void WriteCSV(std::ostream &file, const std::vector<TrialResult> &results)
+{
+  file << std::setprecision(9);
+  file << "environment,planner,trial,seed,exact_solution,approximate_solution,"
+    << "time_setup,time_planning,time_simplification,time_output,path_length,vertices,edges,motion_checks,deferred_checks" << std::endl;
+  for(uint k = 0; k < results.size(); k++){
+    const TrialResult &r = results.at(k);
+    file << CSVField(r.environment) << "," << CSVField(r.planner) << "," << r.trial << "," << r.seed << ","
+      << r.exact << "," << r.approximate << ","
+      << r.setup << "," << r.planning << "," << r.simplification << "," << r.output << ","
+      << r.path_length << "," << r.vertices << "," << r.edges << ","
+      << r.motion_checks << "," << r.deferred_checks << std::endl;
+  }
+}
+
+//positive number, the whole argument has to be parsed
+bool ParsePositive(const char *arg, double &value)
+{
+  char *end = nullptr;
+  value = std::strtod(arg, &end);
+  return end != arg && *end == '\0' && value > 0;
+}
+
+bool ParsePositive(const char *arg, uint &value)
+{
+  double d;
+  if(!ParsePositive(arg, d) || d > std::numeric_limits<uint>::max() || d != (uint)d) return false;
+  value = (uint)d;
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  uint Nruns = 10;
+  uint seed = 1;
+  double max_planning_time = -1;
+  bool lazy = false;
+  std::string fname_json, fname_csv;
+  std::vector<std::string> environments;
+
+  bool valid = true;
+  for(int k = 1; k < argc && valid; k++){
+    std::string arg = argv[k];
+    bool hasValue = (k+1 < argc);
+    if(arg == "--lazy") lazy = true;
+    else if(arg.compare(0, 1, "-") != 0) environments.push_back(arg);
+    else if(arg != "--runs" && arg != "--seed" && arg != "--time" && arg != "--json" && arg != "--csv"){
+      std::cout << "Unknown option " << arg << std::endl;
+      valid = false;
+    }else if(!hasValue){
+      std::cout << "Missing value of " << arg << std::endl;
+      valid = false;
+    }else{
+      const char *value = argv[++k];
+      if(arg == "--runs") valid = ParsePositive(value, Nruns);
+      else if(arg == "--seed") valid = ParsePositive(value, seed);
+      else if(arg == "--time") valid = ParsePositive(value, max_planning_time);
+      else if(arg == "--json") fname_json = value;
+      else fname_csv = value;
+      if(!valid){
+        std::cout << "Invalid value " << value << " of " << arg << " (expected positive number)" << std::endl;
+      }
+    }
+  }
+  if(!valid || environments.empty()){
+    std::cout << "Usage: " << argv[0] << " [--runs N] [--seed S] [--time T] [--lazy] [--json file] [--csv file] <xml world file> [<xml world file> ..]" << std::endl;
+    return 1;
+  }
+  ompl::msg::setLogLevel(ompl::msg::LOG_WARN);
+
+  //seeds all random number generators (needs to be set before the first one
+  //is created)
+  ompl::RNG::setSeed(seed);
+
+  std::vector<TrialResult> results;
+  for(uint i = 0; i < environments.size(); i++){
+    std::string file = environments.at(i);
+    if(file.front() != '/') file = util::GetExecFilePath()+"/"+file;
+
+    HeadlessEnvironmentLoader env(file.c_str());
+    PlannerMultiInput in = env.GetPlannerInput();
+
+    for(uint j = 0; j < in.inputs.size(); j++){
+      PlannerInput *pin = in.inputs.at(j);
+      if(util::StartsWith(pin->name_algorithm, "benchmark")) continue;
+      if(max_planning_time > 0) pin->max_planning_time = max_planning_time;
+      if(lazy) pin->lazy_edges = true;
+
+      for(uint k = 0; k < Nruns; k++){
+        TrialResult result;
+        result.environment = environments.at(i);
+        result.planner = pin->name_algorithm;
+        result.trial = k;
+        result.seed = seed;
+
+        ompl::time::point t = ompl::time::now();
+        MotionPlannerHeadless planner(env.GetWorldPtr(), *pin);
+        result.setup = ompl::time::seconds(ompl::time::now() - t);
+        planner.Run(result);
+
+        std::cout << "[" << result.environment << "] " << result.planner << " trial " << k+1 << "/" << Nruns
+          << " : " << (result.exact?"solved":"no solution")
+          << " (setup " << result.setup << "s, planning " << result.planning << "s, simplification "
+          << result.simplification << "s, output " << result.output << "s)" << std::endl;
+        results.push_back(result);
+      }
+    }
+  }
+
+  if(!fname_json.empty()){
+    WriteJSON(fname_json, results);
+    std::cout << "Wrote " << results.size() << " trials to " << fname_json << std::endl;
+  }
+  if(!fname_csv.empty()){
+    std::ofstream file(fname_csv);
+    WriteCSV(file, results);
+    std::cout << "Wrote " << results.size() << " trials to " << fname_csv << std::endl;
+  }
+  if(fname_json.empty() && fname_csv.empty()){
+    WriteCSV(std::cout, results);
+  }
+  return 0;
+}
@@ -0,0 +1,155 @@
+#include "environment_loader.h"
+#include "elements/roadmap.h"
+#include "planner/cspace/cspace_factory.h"
+#include "gui/gui_state.h"
+#include "util.h"
+#include <ompl/base/PlannerData.h>
+#include <ompl/util/Time.h>
+#include <ompl/util/RandomNumbers.h>
+#include <iomanip>
+
+//Frame time of Roadmap::DrawGL (retained vertex buffers, updated as the
+//roadmap grows) against drawing every vertex and interpolated edge in
+//immediate mode on every frame, for roadmaps of increasing size on the
+//geometric cspace of the first robot. Renders offscreen with OSMesa, i.e.
+//times are software rendering times, but comparable between both modes.
+//
+//Usage: ./roadmap_draw_benchmark <environment.xml> [max vertices] [frames]
+
+#ifdef HAVE_OSMESA
+#include <GL/osmesa.h>
+#include <KrisLibrary/GLdraw/drawextra.h>
+
+using namespace GLDraw;
+
+//per-frame projection and interpolation (as Roadmap::DrawGL did before)
+void DrawImmediate(ob::PlannerDataPtr pd, CSpaceOMPL *cspace)
+{
+  ob::StateSpacePtr space = cspace->SpaceInformationPtr()->getStateSpace();
+  ob::State *sCur = space->allocState();
+  glPointSize(6);
+  for(uint vidx = 0; vidx < pd->numVertices(); vidx++){
+    drawPoint(cspace->getXYZ(pd->getVertex(vidx).getState()));
+  }
+  glLineWidth(1);
+  std::vector<uint> edgeList;
+  for(uint vidx = 0; vidx < pd->numVertices(); vidx++){
+    const ob::State *s = pd->getVertex(vidx).getState();
+    pd->getEdges(vidx, edgeList);
+    for(uint j = 0; j < edgeList.size(); j++){
+      const ob::State *t = pd->getVertex(edgeList.at(j)).getState();
+      uint nd = std::max(1u, space->validSegmentCount(s, t));
+      Vector3 qOld = cspace->getXYZ(s);
+      for(uint k = 1; k <= nd; k++){
+        space->interpolate(s, t, (double)k/(double)nd, sCur);
+        Vector3 qCur = cspace->getXYZ(sCur);
+        drawLineSegment(qOld, qCur);
+        qOld = qCur;
+      }
+    }
+  }
+  space->freeState(sCur);
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  uint Nmax = 1e5;
+  uint Nframes = 20;
+  if(argc > 2) Nmax = std::atoi(argv[2]);
+  if(argc > 3) Nframes = std::atoi(argv[3]);
+
+  const int W = 640, H = 480;
+  OSMesaContext ctx = OSMesaCreateContextExt(OSMESA_RGBA, 16, 0, 0, NULL);
+  std::vector<unsigned char> image(4*W*H);
+  if(!ctx || !OSMesaMakeCurrent(ctx, &image[0], GL_UNSIGNED_BYTE, W, H)){
+    std::cout << "[RoadmapDrawBenchmark] could not create OSMesa context." << std::endl;
+    throw "OSMesa error.";
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  CSpaceOMPL *cspace = factory.MakeGeometricCSpace(env.GetWorldPtr(), robot_idx);
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  ob::StateSamplerPtr sampler = si->allocStateSampler();
+
+  GUIState state;
+  std::string guidef = util::GetDataFolder()+"/../settings/gui.xml";
+  state.Load(guidef.c_str());
+  state("draw_roadmap_vertices").activate();
+  state("draw_roadmap_edges").activate();
+
+  //planner data does not own the states of its vertices
+  std::vector<ob::State*> states;
+  ob::PlannerDataPtr pd = std::make_shared<ob::PlannerData>(si);
+  //buffers are freed before the context is destroyed
+  RoadmapPtr roadmap = std::make_shared<Roadmap>(pd, cspace, cspace);
+  ompl::RNG rng;
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Roadmap frame times (robot " << env.GetWorldPtr()->robots[robot_idx]->name
+    << ", " << Nframes << " frames per size, " << W << "x" << H << " offscreen)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::setw(10) << "vertices" << std::setw(10) << "edges" << std::setw(14) << "update [ms]"
+    << std::setw(14) << "frame [ms]" << std::setw(16) << "immediate [ms]" << std::setw(10) << "speedup" << std::endl;
+
+  for(uint N = 1000; N <= Nmax; N *= 10){
+    //grow the roadmap: each vertex is connected to its predecessor and to a
+    //random earlier vertex
+    while(pd->numVertices() < N){
+      ob::State *s = si->allocState();
+      sampler->sampleUniform(s);
+      states.push_back(s);
+      uint vidx = pd->addVertex(ob::PlannerDataVertex(s));
+      if(vidx > 0){
+        pd->addEdge(vidx - 1, vidx);
+        pd->addEdge(rng.uniformInt(0, vidx - 1), vidx);
+      }
+    }
+
+    //first frame after growing uploads the new vertices and edges
+    ompl::time::point start = ompl::time::now();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    roadmap->DrawGL(state);
+    glFinish();
+    double t_update = ompl::time::seconds(ompl::time::now() - start);
+
+    start = ompl::time::now();
+    for(uint k = 0; k < Nframes; k++){
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      roadmap->DrawGL(state);
+      glFinish();
+    }
+    double t_retained = ompl::time::seconds(ompl::time::now() - start)/Nframes;
+
+    start = ompl::time::now();
+    for(uint k = 0; k < Nframes; k++){
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      DrawImmediate(pd, cspace);
+      glFinish();
+    }
+    double t_immediate = ompl::time::seconds(ompl::time::now() - start)/Nframes;
+
+    std::cout << std::setw(10) << pd->numVertices() << std::setw(10) << pd->numEdges()
+      << std::setw(14) << 1e3*t_update << std::setw(14) << 1e3*t_retained
+      << std::setw(16) << 1e3*t_immediate << std::setw(10) << std::setprecision(3) << t_immediate/t_retained << std::endl;
+  }
+
+  roadmap.reset();
+  pd.reset();
+  si->freeStates(states);
+  OSMesaDestroyContext(ctx);
+  return 0;
+}
+
+#else
+
+int main(int argc, char **argv)
+{
+  std::cout << "roadmap_draw_benchmark requires OSMesa (pkg-config osmesa)." << std::endl;
+  return 0;
+}
+
+#endif
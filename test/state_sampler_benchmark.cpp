@@ -0,0 +1,68 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include "planner/strategy/strategy.h"
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+//Valid samples per second of the valid state samplers of settings/planner.xml
+//on the geometric cspace of the first robot of the environment, together with
+//the mean clearance of the samples (workspace distance to the environment).
+//E.g. on experiments/02D_disk_narrow.xml or
+//experiments/03D_planar_narrow_passage.xml.
+//
+//Usage: ./state_sampler_benchmark <environment.xml> [seconds per sampler]
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  double T = 2;
+  if(argc > 2){
+    T = std::atof(argv[2]);
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  RobotWorld *world = env.GetWorldPtr();
+
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  GeometricCSpaceOMPL *cspace = factory.MakeGeometricCSpace(world, robot_idx);
+  ob::SpaceInformationPtr si = cspace->SpaceInformationPtr();
+  const ob::StateValidityCheckerPtr checker = si->getStateValidityChecker();
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Valid state samplers (robot " << world->robots[robot_idx]->name << ", "
+    << si->getStateDimension() << " dimensions, " << T << "s per sampler)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(20) << "sampler" << std::right << std::setw(14) << "samples/s"
+    << std::setw(12) << "failed" << std::setw(16) << "mean clearance" << std::endl;
+
+  std::vector<std::string> samplers = {"uniform", "gaussian", "obstacle_based", "bridge",
+    "minimum_clearance", "maximum_clearance", "cached_clearance"};
+
+  ob::State *state = si->allocState();
+  for(uint k = 0; k < samplers.size(); k++){
+    ob::ValidStateSamplerPtr sampler = Strategy::GetValidStateSamplerAllocator(samplers.at(k))(si.get());
+
+    unsigned long Nvalid = 0;
+    unsigned long Nfailed = 0;
+    double clearance = 0;
+    double t = 0;
+    while(t < T){
+      ompl::time::point start = ompl::time::now();
+      bool valid = sampler->sample(state);
+      t += ompl::time::seconds(ompl::time::now() - start);
+      if(valid){
+        Nvalid++;
+        clearance += checker->clearance(state);
+      }else{
+        Nfailed++;
+      }
+    }
+    std::cout << std::left << std::setw(20) << samplers.at(k) << std::right
+      << std::setw(14) << (unsigned long)(Nvalid/t) << std::setw(12) << Nfailed
+      << std::setw(16) << (Nvalid > 0 ? clearance/Nvalid : 0.0) << std::endl;
+  }
+  si->freeState(state);
+  return 0;
+}
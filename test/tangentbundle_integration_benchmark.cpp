@@ -0,0 +1,211 @@
+#include "environment_loader.h"
+#include "planner/cspace/cspace_factory.h"
+#include "planner/cspace/integrator/tangentbundle.h"
+#include "planner/cspace/integrator/liegroupintegrator.h"
+#include <ompl/util/Time.h>
+#include <ompl/util/RandomNumbers.h>
+#include <iomanip>
+
+//Accuracy against cost of the integration methods of TangentBundleIntegrator
+//for the first robot of the given environment (which needs a kinodynamic
+//cspace, e.g. 06D_drone_forest.xml or 06D_rocket.xml). For increasing
+//control durations, random states and controls are propagated and compared
+//to a reference solution (RK45, tolerance 1e-10, maximum step 0.01).
+//
+//Before, the Lie group part of RK4/RK45 is checked against the closed-form
+//rigid body motion g0 exp(t xi) for a constant twist xi, and against a fine
+//product of exponentials for a constant body acceleration (the latter
+//involves the brackets of dexp^{-1}, which vanish for a constant twist).
+//
+//Usage: ./tangentbundle_integration_benchmark <environment.xml> [number of samples]
+
+struct IntegratorSetting{
+  std::string name;
+  TangentBundleIntegrator::Method method;
+  double tolerance;
+  double maxStepSize;
+  double massMatrixTolerance;
+};
+
+void SetIntegrator(TangentBundleIntegrator &integrator, const IntegratorSetting &setting)
+{
+  integrator.SetMethod(setting.method);
+  integrator.SetTolerance(setting.tolerance);
+  integrator.SetMaxStepSize(setting.maxStepSize);
+  integrator.SetMassMatrixTolerance(setting.massMatrixTolerance);
+  integrator.ResetCounters();
+}
+
+double SE3Error(const Matrix4 &g, const Matrix4 &h)
+{
+  double error = 0;
+  for(int i = 0; i < 4; i++){
+    for(int j = 0; j < 4; j++){
+      error = std::max(error, fabs(g(i,j) - h(i,j)));
+    }
+  }
+  return error;
+}
+
+//body acceleration alpha (zero: constant twist), over duration T from q0
+//with the twist xi0. Returns the error of propagate_rk in SE(3).
+double LieGroupError(const TangentBundleIntegrator &integrator, const Config &q0,
+    const Config &xi0, const Config &alpha, double T)
+{
+  const int N = q0.n;
+  LieGroupIntegrator lie;
+  Config dq0(N, 0.0);
+  for(int i = 0; i < 6; i++) dq0(i) = xi0(i);
+
+  auto acceleration = [&](const Config &/*q*/, const Config &/*dq*/, Config &ddq){
+    ddq.resize(N);
+    ddq.setZero();
+    for(int i = 0; i < 6; i++) ddq(i) = alpha(i);
+  };
+  Config q1, dq1;
+  integrator.propagate_rk(q0, dq0, T, acceleration, q1, dq1);
+
+  //g(T) = g0 prod_k exp(h xi(t_k + h/2)), exact for alpha = 0
+  Matrix4 g = lie.StateToSE3(q0);
+  const uint Nsteps = (alpha.norm() > 0 ? 20000 : 1);
+  const double h = T/Nsteps;
+  Config xi(6);
+  for(uint k = 0; k < Nsteps; k++){
+    for(int i = 0; i < 6; i++) xi(i) = h*(xi0(i) + (k + 0.5)*h*alpha(i));
+    g = g*lie.MatrixExponential(lie.SE3Derivative(xi));
+  }
+  return SE3Error(lie.StateToSE3(q1), g);
+}
+
+void CheckLieGroupIntegration(TangentBundleIntegrator &integrator, const Config &q0)
+{
+  ompl::RNG rng;
+  Config xi0(6), zero(6, 0.0), alpha(6);
+  for(int i = 0; i < 6; i++){
+    xi0(i) = rng.uniformReal(-1, 1);
+    alpha(i) = rng.uniformReal(-1, 1);
+  }
+  const double T = 1.0;
+  const double maxError = 1e-6;
+
+  std::vector<IntegratorSetting> settings = {
+    {"RK4 (h=0.01)", TangentBundleIntegrator::RK4, 0, 0.01, 0},
+    {"RK45 (1e-10)", TangentBundleIntegrator::RK45, 1e-10, 0.1, 0}};
+
+  bool success = true;
+  for(uint j = 0; j < settings.size(); j++){
+    SetIntegrator(integrator, settings.at(j));
+    double errorTwist = LieGroupError(integrator, q0, xi0, zero, T);
+    double errorAcceleration = LieGroupError(integrator, q0, xi0, alpha, T);
+    std::cout << std::left << std::setw(16) << settings.at(j).name
+      << " constant twist error " << errorTwist
+      << ", constant acceleration error " << errorAcceleration << std::endl;
+    success = success && (errorTwist < maxError) && (errorAcceleration < maxError);
+  }
+  if(!success){
+    std::cout << "[TangentBundleIntegrator] Lie group integration error above " << maxError << std::endl;
+    throw "Lie group integration error.";
+  }
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  uint Nsamples = 200;
+  if(argc > 2){
+    Nsamples = std::atoi(argv[2]);
+  }
+
+  PlannerMultiInput in = env.GetPlannerInput();
+  PlannerInput *pin = in.inputs.at(0);
+  int robot_idx = pin->robot_idx;
+  RobotWorld *world = env.GetWorldPtr();
+
+  CSpaceFactory factory(pin->GetCSpaceInput(robot_idx));
+  KinodynamicCSpaceOMPL *cspace = factory.MakeKinodynamicCSpace(world, robot_idx);
+  oc::SpaceInformationPtr siC = std::static_pointer_cast<oc::SpaceInformation>(cspace->SpaceInformationPtr());
+  uint Nctrl = cspace->GetControlDimensionality();
+
+  TangentBundleIntegrator integrator(siC, cspace);
+
+  std::vector<IntegratorSetting> settings = {
+    {"Euler", TangentBundleIntegrator::EULER, 0, 0, 0},
+    {"RK4 (h=0.1)", TangentBundleIntegrator::RK4, 0, 0.1, 0},
+    {"RK4 (h=0.02)", TangentBundleIntegrator::RK4, 0, 0.02, 0},
+    {"RK45 (1e-3)", TangentBundleIntegrator::RK45, 1e-3, 1.0, 0},
+    {"RK45 (1e-6)", TangentBundleIntegrator::RK45, 1e-6, 1.0, 0},
+    {"RK45 (1e-6,B)", TangentBundleIntegrator::RK45, 1e-6, 1.0, 1e-3}};
+  IntegratorSetting reference = {"reference", TangentBundleIntegrator::RK45, 1e-10, 0.01, 0};
+
+  ob::StateSamplerPtr sampler = siC->allocStateSampler();
+  oc::ControlSamplerPtr csampler = siC->allocControlSampler();
+  std::vector<ob::State*> states;
+  std::vector<oc::Control*> controls;
+  for(uint k = 0; k < Nsamples; k++){
+    ob::State *s = siC->allocState();
+    sampler->sampleUniform(s);
+    states.push_back(s);
+    oc::Control *c = siC->allocControl();
+    csampler->sample(c);
+    controls.push_back(c);
+  }
+  std::vector<ob::State*> results;
+  for(uint k = 0; k < Nsamples; k++){
+    results.push_back(siC->allocState());
+  }
+  ob::State *x = siC->allocState();
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Lie group integration against closed-form solutions" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  CheckLieGroupIntegration(integrator, cspace->OMPLStateToConfig(states.at(0)));
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Integration accuracy against cost (robot " << world->robots[robot_idx]->name
+    << ", " << Nsamples << " samples)" << std::endl;
+  std::cout << "(B: mass matrix factorization reused within 1e-3)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(10) << "duration" << std::setw(16) << "method"
+    << std::right << std::setw(14) << "mean error"
+    << std::setw(14) << "evaluations"
+    << std::setw(14) << "factoriz."
+    << std::setw(12) << "time [us]" << std::endl;
+
+  std::vector<double> durations = {0.01, 0.1, 0.5, 1.0};
+  for(uint d = 0; d < durations.size(); d++){
+    double T = durations.at(d);
+    for(uint k = 0; k < Nsamples; k++){
+      controls.at(k)->as<oc::RealVectorControlSpace::ControlType>()->values[Nctrl-1] = T;
+    }
+
+    SetIntegrator(integrator, reference);
+    for(uint k = 0; k < Nsamples; k++){
+      integrator.propagate(states.at(k), controls.at(k), T, results.at(k));
+    }
+
+    for(uint j = 0; j < settings.size(); j++){
+      SetIntegrator(integrator, settings.at(j));
+      double error = 0;
+      double time = 0;
+      for(uint k = 0; k < Nsamples; k++){
+        ompl::time::point t_start = ompl::time::now();
+        integrator.propagate(states.at(k), controls.at(k), T, x);
+        time += ompl::time::seconds(ompl::time::now() - t_start);
+        error += siC->distance(x, results.at(k));
+      }
+      std::cout << std::left << std::setw(10) << T << std::setw(16) << settings.at(j).name
+        << std::right << std::setw(14) << error/Nsamples
+        << std::setw(14) << (double)integrator.GetNumberOfDynamicsEvaluations()/Nsamples
+        << std::setw(14) << (double)integrator.GetNumberOfFactorizations()/Nsamples
+        << std::setw(12) << 1e6*time/Nsamples << std::endl;
+    }
+  }
+
+  siC->freeState(x);
+  for(uint k = 0; k < Nsamples; k++){
+    siC->freeState(states.at(k));
+    siC->freeState(results.at(k));
+    siC->freeControl(controls.at(k));
+  }
+  return 0;
+}
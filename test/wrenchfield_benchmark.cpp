@@ -0,0 +1,128 @@
+#include "elements/wrench_field.h"
+#include "elements/forcefields/forcefield_grid.h"
+#include <KrisLibrary/math/random.h>
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+using namespace Math3D;
+
+//Compares WrenchField::getForce (one virtual call per field and query point)
+//against the batched WrenchField::getForces for the force fields of the given
+//world file (e.g. data/spider_ridge.xml), evaluated at random positions and
+//velocities in [-5,5]^3. If the world contains no random force fields, both
+//results are compared. Precomputed fields (e.g. data/tests/forcefield_grid.xml)
+//are additionally compared against evaluating their fields, i.e. their error
+//bound is checked at random points inside the cells.
+//
+//Usage: ./wrenchfield_benchmark <world.xml> [number of query points]
+//Returns 1 if the results differ or a grid exceeds its error bound.
+
+const double tolerance = 1e-10;
+
+int main(int argc, char **argv)
+{
+  if(argc < 2){
+    std::cout << "Usage: " << argv[0] << " <world.xml> [number of query points]" << std::endl;
+    return 0;
+  }
+  uint Npoints = 1e6;
+  if(argc > 2){
+    Npoints = std::atoi(argv[2]);
+  }
+
+  WrenchField wrenchfield;
+  wrenchfield.Load(argv[1]);
+  std::cout << wrenchfield;
+
+  bool deterministic = true;
+  const std::vector<ForceFieldPtr> &fields = wrenchfield.GetForceFields();
+  for(uint k = 0; k < fields.size(); k++){
+    ForceFieldTypes type = fields.at(k)->type();
+    if(type == UNIFORM_RANDOM || type == GAUSSIAN_RANDOM) deterministic = false;
+  }
+
+  std::vector<Vector3> positions(Npoints), velocities(Npoints);
+  for(uint k = 0; k < Npoints; k++){
+    for(int i = 0; i < 3; i++){
+      positions[k][i] = Math::Rand(-5, 5);
+      velocities[k][i] = Math::Rand(-5, 5);
+    }
+  }
+
+  std::vector<Vector3> forces_scalar(Npoints);
+  ompl::time::point t_start = ompl::time::now();
+  for(uint k = 0; k < Npoints; k++){
+    forces_scalar[k] = wrenchfield.getForce(positions[k], velocities[k]);
+  }
+  double t_scalar = ompl::time::seconds(ompl::time::now() - t_start);
+
+  std::vector<Vector3> forces_batched;
+  t_start = ompl::time::now();
+  wrenchfield.getForces(positions, velocities, forces_batched);
+  double t_batched = ompl::time::seconds(ompl::time::now() - t_start);
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Force evaluation (" << fields.size() << " fields, " << Npoints << " query points)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "scalar" << std::right << std::setw(12) << t_scalar << "s"
+    << std::setw(14) << 1e9*t_scalar/Npoints << " ns/point" << std::endl;
+  std::cout << std::left << std::setw(16) << "batched" << std::right << std::setw(12) << t_batched << "s"
+    << std::setw(14) << 1e9*t_batched/Npoints << " ns/point" << std::endl;
+  std::cout << "speedup: " << t_scalar/t_batched << std::endl;
+
+  bool gridError = false;
+  for(uint k = 0; k < fields.size(); k++){
+    if(fields.at(k)->type() != GRID) continue;
+    GridForceField *grid = dynamic_cast<GridForceField*>(&(*fields.at(k)));
+    const std::vector<ForceFieldPtr> &static_fields = grid->GetForceFields();
+
+    std::vector<Vector3> forces_grid(Npoints), forces_analytic(Npoints);
+    t_start = ompl::time::now();
+    for(uint m = 0; m < Npoints; m++){
+      forces_grid[m] = grid->getForce(positions[m], velocities[m]);
+    }
+    double t_grid = ompl::time::seconds(ompl::time::now() - t_start);
+    t_start = ompl::time::now();
+    for(uint m = 0; m < Npoints; m++){
+      Vector3 F(0,0,0);
+      for(uint f = 0; f < static_fields.size(); f++){
+        F += static_fields.at(f)->getForce(positions[m], velocities[m]);
+      }
+      forces_analytic[m] = F;
+    }
+    double t_analytic = ompl::time::seconds(ompl::time::now() - t_start);
+
+    double error = 0;
+    for(uint m = 0; m < Npoints; m++){
+      error = std::max(error, (forces_grid[m] - forces_analytic[m]).maxAbsElement());
+    }
+    std::cout << std::string(80, '-') << std::endl;
+    std::cout << "Grid (" << grid->GetNumberOfCells() << " cells, " << grid->GetNumberOfInterpolatedCells()
+      << " interpolated, size " << grid->GetCellSize() << ")" << std::endl;
+    std::cout << std::left << std::setw(16) << "analytic" << std::right << std::setw(12) << t_analytic << "s"
+      << std::setw(14) << 1e9*t_analytic/Npoints << " ns/point" << std::endl;
+    std::cout << std::left << std::setw(16) << "grid" << std::right << std::setw(12) << t_grid << "s"
+      << std::setw(14) << 1e9*t_grid/Npoints << " ns/point" << std::endl;
+    std::cout << "max interpolation error: " << error << " (bound " << grid->GetMaxError() << ")" << std::endl;
+    if(error > grid->GetMaxError()){
+      std::cout << "Error: grid interpolation error above its bound." << std::endl;
+      gridError = true;
+    }
+  }
+
+  if(!deterministic){
+    std::cout << "(random force fields: results are not compared)" << std::endl;
+    return (gridError ? 1 : 0);
+  }
+  double error = 0;
+  for(uint k = 0; k < Npoints; k++){
+    double scale = std::max(1.0, forces_scalar[k].maxAbsElement());
+    error = std::max(error, (forces_scalar[k] - forces_batched[k]).maxAbsElement()/scale);
+  }
+  std::cout << "max relative error: " << error << std::endl;
+  if(error > tolerance){
+    std::cout << "Error: batched forces differ from getForce." << std::endl;
+    return 1;
+  }
+  return (gridError ? 1 : 0);
+}
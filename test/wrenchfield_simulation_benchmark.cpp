@@ -0,0 +1,89 @@
+#include "environment_loader.h"
+#include "elements/wrench_field_simulation.h"
+#include <ompl/util/Time.h>
+#include <iomanip>
+
+using namespace Math3D;
+
+//Headless simulation steps per second of the wrench field simulation, with
+//one WrenchHook per link allocated on every step (as ForceFieldBackend did
+//before) against persistent hooks updated in place (WrenchFieldSimulation).
+//E.g. on experiments/06D_drone_forest.xml (drone) or hubo_object.xml
+//(humanoid).
+//
+//Usage: ./wrenchfield_simulation_benchmark <environment.xml> [simulated seconds]
+
+//per-step hook allocation
+double RunAllocating(WorldSimulation &sim, WrenchField &wrenchfield, double dt, uint Nsteps)
+{
+  ODERobot *simrobot = sim.odesim.robot(0);
+  uint Nlinks = simrobot->robot.links.size();
+  ompl::time::point start = ompl::time::now();
+  for(uint k = 0; k < Nsteps; k++){
+    sim.hooks.clear();
+    for(uint i = 0; i < Nlinks; i++){
+      dBodyID bodyid = simrobot->body(i);
+      if(!bodyid || simrobot->robot.IsGeometryEmpty(i)) continue;
+      Vector3 com;
+      RobotLink3D *link = &simrobot->robot.links[i];
+      link->GetWorldCOM(com);
+      Vector3 linmom = simrobot->robot.GetLinearMomentum(i);
+      Vector3 force = wrenchfield.getForce(com, linmom/link->mass);
+      sim.hooks.push_back(new WrenchHook(bodyid, force, Vector3(0,0,0)));
+    }
+    sim.Advance(dt);
+    sim.UpdateModel();
+  }
+  double t = ompl::time::seconds(ompl::time::now() - start);
+  sim.hooks.clear();
+  return t;
+}
+
+double RunPooled(WorldSimulation &sim, WrenchField &wrenchfield, double dt, double duration)
+{
+  WrenchFieldSimulation wrenchsimulation(&sim, &wrenchfield);
+  wrenchsimulation.SetTimeStep(dt);
+  ompl::time::point start = ompl::time::now();
+  wrenchsimulation.Run(duration);
+  double t = ompl::time::seconds(ompl::time::now() - start);
+  wrenchsimulation.Clear();
+  return t;
+}
+
+int main(int argc, char **argv)
+{
+  EnvironmentLoader env = EnvironmentLoader::from_args(argc, argv);
+  double duration = 10;
+  if(argc > 2){
+    duration = std::atof(argv[2]);
+  }
+
+  PlannerBackendPtr backend = env.GetBackendPtr();
+  WorldSimulation &sim = backend->sim;
+  WrenchField &wrenchfield = backend->wrenchfield;
+  sim.odesim.SetGravity(Vector3(0,0,0));
+
+  ODERobot *simrobot = sim.odesim.robot(0);
+  Config q0, dq0;
+  simrobot->GetConfig(q0);
+  simrobot->GetVelocities(dq0);
+  wrenchfield.init(simrobot->robot.links.size());
+
+  double dt = sim.simStep;
+  uint Nsteps = std::floor(duration/dt);
+
+  double t_allocating = RunAllocating(sim, wrenchfield, dt, Nsteps);
+
+  util::SetSimulatedRobot(&simrobot->robot, sim, q0, dq0);
+  double t_pooled = RunPooled(sim, wrenchfield, dt, duration);
+
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << "Simulation of " << duration << "s (" << Nsteps << " steps of " << dt << "s, robot "
+    << simrobot->robot.name << " with " << simrobot->robot.links.size() << " links)" << std::endl;
+  std::cout << std::string(80, '-') << std::endl;
+  std::cout << std::left << std::setw(16) << "allocating" << std::right << std::setw(12) << t_allocating << "s"
+    << std::setw(14) << Nsteps/t_allocating << " steps/s" << std::endl;
+  std::cout << std::left << std::setw(16) << "pooled" << std::right << std::setw(12) << t_pooled << "s"
+    << std::setw(14) << Nsteps/t_pooled << " steps/s" << std::endl;
+  return 0;
+}